@@ -0,0 +1,408 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_AssetArchive.cpp 								|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To read asset files from one packed archive			|
+|					mapped into memory									|
+|																		|
+\***********************************************************************/
+
+#include "SGD_AssetArchive.h"
+
+
+// Uses EncodeAssetName for the entry names
+#include "SGD_AssetIndex.h"
+
+// Uses DecompressLZ for compressed entries
+#include "SGD_Compression.h"
+
+// Uses Alert for archives that cannot be read
+#include "SGD_Utilities.h"
+
+// Uses memcmp
+#include <cstring>
+
+// Uses std::string & std::wstring
+#include <string>
+
+// Uses std::mutex for mounting while the loader thread reads
+#include <mutex>
+
+// Uses the file mapping API
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		// The mounted archive
+		//	- s_unReaders counts the ReadArchivedFile calls not yet
+		//	  released: it cannot be unmapped until they are
+		static std::mutex		s_ArchiveMutex;				// guards both
+		static AssetArchive*	s_pArchive		= nullptr;
+		static unsigned int		s_unReaders		= 0;
+
+
+		//*************************************************************//
+		// DESTRUCTOR
+		AssetArchive::~AssetArchive( void )
+		{
+			Close();
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// OPEN
+		bool AssetArchive::Open( const wchar_t* filename )
+		{
+			Close();
+
+			SGD_ASSERT( filename != nullptr, "AssetArchive::Open - invalid filename" );
+			if( filename == nullptr )
+				return false;
+
+
+#ifdef _WIN32
+			HANDLE hFile = CreateFileW( filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr );
+			if( hFile == INVALID_HANDLE_VALUE )
+				return false;
+
+			LARGE_INTEGER size;
+			if( GetFileSizeEx( hFile, &size ) == FALSE || size.QuadPart < (LONGLONG)sizeof( ArchiveHeader ) )
+			{
+				CloseHandle( hFile );
+				return false;
+			}
+
+			HANDLE hMapping = CreateFileMappingW( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+			void* pView = ( hMapping != nullptr ) ? MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+			if( pView == nullptr )
+			{
+				if( hMapping != nullptr )
+					CloseHandle( hMapping );
+				CloseHandle( hFile );
+				return false;
+			}
+
+			m_hFile		= hFile;
+			m_hMapping	= hMapping;
+			m_pData		= (const unsigned char*)pView;
+			m_uSize		= (size_t)size.QuadPart;
+#else
+			// The paths are ASCII
+			std::wstring	wide	= filename;
+			std::string		name( wide.begin(), wide.end() );
+
+			int file = open( name.c_str(), O_RDONLY );
+			if( file < 0 )
+				return false;
+
+			struct stat info;
+			if( fstat( file, &info ) != 0 || info.st_size < (off_t)sizeof( ArchiveHeader ) )
+			{
+				close( file );
+				return false;
+			}
+
+			// The mapping keeps the file open
+			void* pView = mmap( nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0 );
+			close( file );
+			if( pView == MAP_FAILED )
+				return false;
+
+			m_pData		= (const unsigned char*)pView;
+			m_uSize		= (size_t)info.st_size;
+#endif
+
+
+			// Is it an archive?
+			if( Validate() == false )
+			{
+				Close();
+
+				// MESSAGE
+				std::wstring message = L"!!! AssetArchive::Open - \"" + std::wstring( filename ) + L"\" is not an asset archive !!!\n";
+				Alert( message.c_str() );
+
+				return false;
+			}
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// CLOSE
+		void AssetArchive::Close( void )
+		{
+			if( m_pData == nullptr )
+				return;
+
+#ifdef _WIN32
+			UnmapViewOfFile( m_pData );
+			CloseHandle( (HANDLE)m_hMapping );
+			CloseHandle( (HANDLE)m_hFile );
+#else
+			munmap( (void*)m_pData, m_uSize );
+#endif
+
+			m_pData		= nullptr;
+			m_uSize		= 0;
+			m_hFile		= nullptr;
+			m_hMapping	= nullptr;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// GET NUM ENTRIES
+		unsigned int AssetArchive::GetNumEntries( void ) const
+		{
+			if( m_pData == nullptr )
+				return 0;
+
+			return ( (const ArchiveHeader*)m_pData )->count;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// READ
+		bool AssetArchive::Read( const wchar_t* filename, const unsigned char*& data, size_t& size, std::vector< unsigned char >& buffer ) const
+		{
+			buffer.clear();
+
+			const ArchiveEntry* entry = Find( filename );
+			if( entry == nullptr )
+				return false;
+
+
+			// Stored: read it in place
+			if( entry->compression == ARCHIVE_STORED )
+			{
+				data = m_pData + entry->offset;
+				size = entry->size;
+				return true;
+			}
+
+
+			// Compressed: expand it
+			buffer.resize( entry->originalSize );
+			if( DecompressLZ( m_pData + entry->offset, entry->size, buffer.data(), buffer.size() ) == false )
+			{
+				SGD_ASSERT( false, "AssetArchive::Read - corrupt entry" );
+				buffer.clear();
+				return false;
+			}
+
+			data = buffer.data();
+			size = buffer.size();
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// VALIDATE
+		//	- every table, name & data range must lie inside the file,
+		//	  so Read never checks them again
+		bool AssetArchive::Validate( void ) const
+		{
+			const ArchiveHeader* header = (const ArchiveHeader*)m_pData;
+
+			if( memcmp( header->magic, "SGDA", 4 ) != 0 || header->version != ARCHIVE_VERSION )
+				return false;
+
+			if( header->alignment == 0 || ( header->alignment & ( header->alignment - 1 ) ) != 0 )
+				return false;
+
+			if( header->count > ( m_uSize - sizeof( ArchiveHeader ) ) / sizeof( ArchiveEntry ) )
+				return false;
+
+
+			const ArchiveEntry* entries = (const ArchiveEntry*)( m_pData + sizeof( ArchiveHeader ) );
+			for( unsigned int i = 0; i < header->count; i++ )
+			{
+				const ArchiveEntry& entry = entries[ i ];
+
+				if( entry.nameOffset > m_uSize || entry.nameLength > m_uSize - entry.nameOffset )
+					return false;
+
+				if( entry.offset > m_uSize || entry.size > m_uSize - entry.offset )
+					return false;
+
+				if( entry.compression == ARCHIVE_STORED && entry.size != entry.originalSize )
+					return false;
+
+				if( entry.compression != ARCHIVE_STORED && entry.compression != ARCHIVE_LZ )
+					return false;
+			}
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// FIND
+		//	- binary search of the sorted names
+		const ArchiveEntry* AssetArchive::Find( const wchar_t* filename ) const
+		{
+			if( m_pData == nullptr || filename == nullptr )
+				return nullptr;
+
+			std::string name = EncodeAssetName( filename );
+
+			const ArchiveEntry* entries = (const ArchiveEntry*)( m_pData + sizeof( ArchiveHeader ) );
+			unsigned int low	= 0;
+			unsigned int high	= GetNumEntries();
+
+			while( low < high )
+			{
+				unsigned int		middle	= low + ( high - low ) / 2;
+				const ArchiveEntry&	entry	= entries[ middle ];
+
+				int compare = name.compare( 0, std::string::npos, (const char*)m_pData + entry.nameOffset, entry.nameLength );
+				if( compare == 0 )
+					return &entry;
+
+				if( compare < 0 )
+					high = middle;
+				else
+					low = middle + 1;
+			}
+
+			return nullptr;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// READ ARCHIVED FILE
+		bool ReadArchivedFile( const wchar_t* filename, const unsigned char*& data, size_t& size, std::vector< unsigned char >& buffer )
+		{
+			// Keep it mounted while reading (Read is const, so the
+			// lock is not held for decompressing)
+			const AssetArchive* pArchive;
+			{
+				std::lock_guard< std::mutex > lock( s_ArchiveMutex );
+				if( s_pArchive == nullptr )
+					return false;
+
+				pArchive = s_pArchive;
+				++s_unReaders;
+			}
+
+			if( pArchive->Read( filename, data, size, buffer ) == true )
+				return true;
+
+			ReleaseArchivedFile();
+			return false;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// RELEASE ARCHIVED FILE
+		void ReleaseArchivedFile( void )
+		{
+			std::lock_guard< std::mutex > lock( s_ArchiveMutex );
+
+			SGD_ASSERT( s_unReaders > 0, "ReleaseArchivedFile - no archived file was read" );
+			if( s_unReaders > 0 )
+				--s_unReaders;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// GET MOUNTED ARCHIVE
+		const AssetArchive* GetMountedArchive( void )
+		{
+			std::lock_guard< std::mutex > lock( s_ArchiveMutex );
+			return s_pArchive;
+		}
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+
+
+	//*****************************************************************//
+	// MOUNT ARCHIVE
+	bool MountArchive( const wchar_t* filename )
+	{
+		// Open it on the side, so a failure keeps the current one
+		SGD_IMPLEMENTATION::AssetArchive* pArchive = new SGD_IMPLEMENTATION::AssetArchive;
+		if( pArchive->Open( filename ) == false )
+		{
+			delete pArchive;
+			return false;
+		}
+
+		// Swap it in, unless the current one is still read
+		bool mounted;
+		{
+			std::lock_guard< std::mutex > lock( SGD_IMPLEMENTATION::s_ArchiveMutex );
+
+			SGD_ASSERT( SGD_IMPLEMENTATION::s_unReaders == 0, "MountArchive - the mounted archive is still read" );
+			mounted = SGD_IMPLEMENTATION::s_unReaders == 0;
+			if( mounted == true )
+			{
+				SGD_IMPLEMENTATION::AssetArchive* pOld = SGD_IMPLEMENTATION::s_pArchive;
+				SGD_IMPLEMENTATION::s_pArchive = pArchive;
+				pArchive = pOld;
+			}
+		}
+
+		// Unmap the old one (or the new one, if it was refused)
+		delete pArchive;
+		return mounted;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// UNMOUNT ARCHIVE
+	bool UnmountArchive( void )
+	{
+		SGD_IMPLEMENTATION::AssetArchive* pArchive;
+		{
+			std::lock_guard< std::mutex > lock( SGD_IMPLEMENTATION::s_ArchiveMutex );
+
+			SGD_ASSERT( SGD_IMPLEMENTATION::s_unReaders == 0, "UnmountArchive - the mounted archive is still read" );
+			if( SGD_IMPLEMENTATION::s_unReaders > 0 )
+				return false;
+
+			pArchive = SGD_IMPLEMENTATION::s_pArchive;
+			SGD_IMPLEMENTATION::s_pArchive = nullptr;
+		}
+
+		delete pArchive;
+		return true;
+	}
+	//*****************************************************************//
+
+}	// namespace SGD
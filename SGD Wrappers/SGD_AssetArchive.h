@@ -0,0 +1,175 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_AssetArchive.h 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To read asset files from one packed archive			|
+|					mapped into memory									|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_ASSETARCHIVE_H
+#define SGD_ASSETARCHIVE_H
+
+
+// Uses size_t
+#include <cstddef>
+
+// Uses std::vector for expanding compressed entries
+#include <vector>
+
+
+namespace SGD
+{
+	//*****************************************************************//
+	// MountArchive
+	//	- maps an archive built by pack_assets (tools/PackAssets.cpp),
+	//	  the managers then read the files it holds from memory
+	//	  & the rest from disk
+	//	- false (keeping the archive already mounted) if the file is
+	//	  missing or is not an archive
+	//	- both refuse (asserting) while the mounted archive is still
+	//	  read: mapped audio is loaded or a texture is being decoded
+	//	  from it, so mount once before loading & UnmountArchive after
+	//	  the managers are terminated
+	bool	MountArchive		( const wchar_t* filename );
+	bool	UnmountArchive		( void );
+	//*****************************************************************//
+
+
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// Archive layout (little endian):
+		//	- ArchiveHeader
+		//	- ArchiveEntry[ count ], sorted by name (binary search)
+		//	- the names (EncodeAssetName: normalized UTF-8 paths)
+		//	- the entries' data, each aligned to 'alignment' bytes
+		//	  from the start of the file
+		enum ArchiveFormat
+		{
+			ARCHIVE_VERSION		= 1,
+
+			ARCHIVE_STORED		= 0,		// the file as it is
+			ARCHIVE_LZ			= 1,		// CompressLZ
+		};
+
+		struct ArchiveHeader
+		{
+			char			magic[ 4 ];		// "SGDA"
+			unsigned int	version;		// ARCHIVE_VERSION
+			unsigned int	count;			// number of entries
+			unsigned int	alignment;		// power of 2
+		};
+
+		struct ArchiveEntry
+		{
+			unsigned int	nameOffset;		// from the start of the file
+			unsigned int	nameLength;		// bytes, no terminator
+			unsigned int	offset;			// data, from the start of the file
+			unsigned int	size;			// bytes in the archive
+			unsigned int	originalSize;	// bytes once expanded
+			unsigned int	compression;	// ARCHIVE_STORED or ARCHIVE_LZ
+		};
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// AssetArchive
+		//	- read-only view of a mapped archive file: the whole file
+		//	  is mapped once & the pages are read in on demand
+		//	- stored entries are read in place (no copy),
+		//	  compressed ones are expanded into the caller's buffer
+		//	- Read is const, so the loader threads can share it
+		class AssetArchive
+		{
+		public:
+			AssetArchive			( void )	= default;
+			~AssetArchive			( void );
+
+
+			// Open:
+			//	- maps the file & checks every entry lies inside it
+			//	- false if it is missing or is not an archive
+			bool			Open			( const wchar_t* filename );
+			void			Close			( void );
+
+			bool			IsOpen			( void ) const		{	return m_pData != nullptr;		}
+			unsigned int	GetNumEntries	( void ) const;
+
+
+			// Read:
+			//	- the file's bytes: 'data' points into the mapping for a
+			//	  stored entry (leaving 'buffer' empty), or into 'buffer'
+			//	  for an expanded one
+			//	- false if the archive does not hold it (or it is corrupt)
+			bool			Read			( const wchar_t* filename, const unsigned char*& data, size_t& size, std::vector< unsigned char >& buffer ) const;
+
+
+		private:
+			AssetArchive			( const AssetArchive& )		= delete;	// Copy constructor
+			AssetArchive&	operator=	( const AssetArchive& )		= delete;	// Assignment operator
+
+
+			bool					Validate		( void ) const;
+			const ArchiveEntry*		Find			( const wchar_t* filename ) const;
+
+
+			const unsigned char*	m_pData			= nullptr;		// the mapped file
+			size_t					m_uSize			= 0;
+
+			void*					m_hFile			= nullptr;		// Windows file & mapping handles
+			void*					m_hMapping		= nullptr;
+		};
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// ReadArchivedFile
+		//	- AssetArchive::Read from the mounted archive (any thread)
+		//	- false if none is mounted or it does not hold the file,
+		//	  so the caller loads it from disk
+		//	- true keeps the archive mounted until ReleaseArchivedFile,
+		//	  as 'data' can point into its mapping
+		bool	ReadArchivedFile	( const wchar_t* filename, const unsigned char*& data, size_t& size, std::vector< unsigned char >& buffer );
+		void	ReleaseArchivedFile	( void );
+
+		// The mounted archive (nullptr if none)
+		const AssetArchive*	GetMountedArchive	( void );
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// ArchivedFile
+		//	- ReadArchivedFile released when it goes out of scope
+		class ArchivedFile
+		{
+		public:
+			ArchivedFile			( void )	= default;
+			~ArchivedFile			( void )	{	if( m_bRead == true ) ReleaseArchivedFile();	}
+
+			bool	Read	( const wchar_t* filename, const unsigned char*& data, size_t& size, std::vector< unsigned char >& buffer )
+			{
+				if( m_bRead == true )
+					ReleaseArchivedFile();
+
+				m_bRead = ReadArchivedFile( filename, data, size, buffer );
+				return m_bRead;
+			}
+
+		private:
+			ArchivedFile				( const ArchivedFile& )		= delete;	// Copy constructor
+			ArchivedFile&	operator=	( const ArchivedFile& )		= delete;	// Assignment operator
+
+			bool	m_bRead		= false;
+		};
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+#endif //SGD_ASSETARCHIVE_H
@@ -0,0 +1,126 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_AssetIndex.cpp 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To find loaded assets by their file path			|
+|					without searching every handle						|
+|																		|
+\***********************************************************************/
+
+#include "SGD_AssetIndex.h"
+
+// Uses towlower for case folding
+#include <cwctype>
+
+// Uses std::vector for the folders
+#include <vector>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// NORMALIZE ASSET PATH
+		std::wstring NormalizeAssetPath( const wchar_t* filename )
+		{
+			std::wstring path;
+			if( filename == nullptr )
+				return path;
+
+
+			// Keep the root ("/" or the "//" of a network path)
+			const wchar_t* pos = filename;
+			while( ( *pos == L'/' || *pos == L'\\' ) && path.size() < 2 )
+			{
+				path += L'/';
+				++pos;
+			}
+
+
+			// Split into folders, dropping "." & folding ".."
+			std::vector< std::wstring > parts;
+			std::wstring part;
+
+			for( ; ; ++pos )
+			{
+				if( *pos != L'\0' && *pos != L'/' && *pos != L'\\' )
+				{
+					part += (wchar_t)towlower( *pos );
+					continue;
+				}
+
+				if( part == L".." && parts.empty() == false && parts.back() != L".." )
+					parts.pop_back();
+				else if( part.empty() == false && part != L"." )
+					parts.push_back( part );
+
+				part.clear();
+				if( *pos == L'\0' )
+					break;
+			}
+
+
+			// Join them with '/'
+			for( unsigned int i = 0; i < parts.size(); i++ )
+			{
+				if( i > 0 )
+					path += L'/';
+				path += parts[ i ];
+			}
+
+			return path;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// ENCODE ASSET NAME
+		std::string EncodeAssetName( const wchar_t* filename )
+		{
+			std::wstring	path	= NormalizeAssetPath( filename );
+			std::string		name;
+
+			for( unsigned int i = 0; i < path.size(); i++ )
+			{
+				unsigned long code = (unsigned long)path[ i ];
+
+				// UTF-16 surrogate pair (2-byte wchar_t)?
+				if( code >= 0xD800 && code <= 0xDBFF && i + 1 < path.size()
+					&& (unsigned long)path[ i + 1 ] >= 0xDC00 && (unsigned long)path[ i + 1 ] <= 0xDFFF )
+				{
+					code = 0x10000 + ( ( code - 0xD800 ) << 10 ) + ( (unsigned long)path[ i + 1 ] - 0xDC00 );
+					++i;
+				}
+
+				if( code < 0x80 )
+					name += (char)code;
+				else if( code < 0x800 )
+				{
+					name += (char)( 0xC0 | ( code >> 6 ) );
+					name += (char)( 0x80 | ( code & 0x3F ) );
+				}
+				else if( code < 0x10000 )
+				{
+					name += (char)( 0xE0 | ( code >> 12 ) );
+					name += (char)( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+					name += (char)( 0x80 | ( code & 0x3F ) );
+				}
+				else
+				{
+					name += (char)( 0xF0 | ( code >> 18 ) );
+					name += (char)( 0x80 | ( ( code >> 12 ) & 0x3F ) );
+					name += (char)( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+					name += (char)( 0x80 | ( code & 0x3F ) );
+				}
+			}
+
+			return name;
+		}
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
@@ -0,0 +1,86 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_AssetIndex.h 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To find loaded assets by their file path			|
+|					without searching every handle						|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_ASSETINDEX_H
+#define SGD_ASSETINDEX_H
+
+
+// Uses std::wstring for the keys (& std::string for archive names)
+#include <string>
+
+// Uses std::unordered_map for the index
+#include <unordered_map>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// NormalizeAssetPath
+		//	- the key for a file path: '\' becomes '/', "." & empty
+		//	  folders are dropped, "folder/.." cancels out, and the
+		//	  path is lower case (Windows paths ignore case)
+		//	- so "./resource/graphics/A.png" & "resource\graphics\a.png"
+		//	  are the same asset (relative & absolute paths are not)
+		std::wstring	NormalizeAssetPath	( const wchar_t* filename );
+
+		// EncodeAssetName
+		//	- the normalized path as UTF-8: the names stored in an
+		//	  asset archive (the same on every platform)
+		std::string		EncodeAssetName		( const wchar_t* filename );
+
+
+		//*************************************************************//
+		// AssetIndex
+		//	- path-keyed hash index kept next to a manager's HandleManager,
+		//	  so loading an asset that is already loaded is O(1)
+		//	- the manager inserts each asset it stores and removes it
+		//	  with its last reference
+		template< typename HandleType >
+		class AssetIndex
+		{
+		public:
+			// Find the asset (INVALID_HANDLE if it is not loaded)
+			HandleType		Find		( const wchar_t* filename ) const
+			{
+				typename IndexMap::const_iterator iter = m_mIndex.find( NormalizeAssetPath( filename ) );
+				if( iter == m_mIndex.end() )
+					return HandleType();
+
+				return iter->second;
+			}
+
+			void			Insert		( const wchar_t* filename, HandleType handle )
+			{
+				m_mIndex[ NormalizeAssetPath( filename ) ] = handle;
+			}
+
+			void			Remove		( const wchar_t* filename )
+			{
+				m_mIndex.erase( NormalizeAssetPath( filename ) );
+			}
+
+			void			Clear		( void )
+			{
+				m_mIndex.clear();
+			}
+
+		private:
+			typedef std::unordered_map< std::wstring, HandleType >	IndexMap;
+			IndexMap		m_mIndex;
+		};
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+#endif	//SGD_ASSETINDEX_H
@@ -39,6 +39,12 @@
 // Uses HandleManager for storing data
 #include "SGD_HandleManager.h"
 
+// Uses AssetIndex for finding audio by name
+#include "SGD_AssetIndex.h"
+
+// Uses ReadArchivedFile for playing audio from the mounted archive
+#include "SGD_AssetArchive.h"
+
 // Uses Alert & SGD_ASSERT for debugging
 #include "SGD_Utilities.h"
 
@@ -56,6 +62,7 @@ namespace SGD
 			unsigned int			unRefCount;			// reference count
 			WAVEFORMATEXTENSIBLE	format;				// wave format (sample rate, etc)
 			XAUDIO2_BUFFER			buffer;				// buffer
+			bool					bMapped;			// buffer data is in the mounted archive (not owned, keeps it mounted)
 			XAUDIO2_BUFFER_WMA		bufferwma;			// additional buffer packets for xwm
 			float					fVolume;			// audio volume
 		};
@@ -157,6 +164,7 @@ namespace SGD
 			VoiceMap					m_mVoices;								// source voice map
 
 			HandleManager< AudioInfo >	m_HandleManager;						// data storage
+			AssetIndex< HAudio >		m_Index;								// audio handles by file name
 			HandleManager< VoiceInfo >	m_VoiceManager;							// voice storage
 
 
@@ -165,15 +173,11 @@ namespace SGD
 			static	HRESULT		ReadChunkData	( HANDLE hFile, void* buffer, DWORD buffersize, DWORD bufferoffset );
 			static	HRESULT		LoadAudio		( const wchar_t* filename, WAVEFORMATEXTENSIBLE& wfx, XAUDIO2_BUFFER& buffer, XAUDIO2_BUFFER_WMA& bufferWMA );
 
+			static	HRESULT		FindChunk		( const BYTE* pFile, DWORD dwFileSize, DWORD fourcc, DWORD& dwChunkSize, DWORD& dwChunkDataPosition );
+			static	HRESULT		LoadAudio		( const BYTE* pFile, DWORD dwFileSize, bool bCopy, WAVEFORMATEXTENSIBLE& wfx, XAUDIO2_BUFFER& buffer, XAUDIO2_BUFFER_WMA& bufferWMA );
 
-			// AUDIO REFERENCE HELPER METHOD
-			struct SearchInfo
-			{
-				const wchar_t*	filename;	// input
-				AudioInfo*		audio;		// output
-				HAudio			handle;		// output
-			};
-			static	bool	FindAudioByName( Handle handle, AudioInfo& data, SearchInfo* extra );
+			// HandleManager::ForEach callback for Terminate
+			static	bool		ReleaseMapped	( Handle handle, AudioInfo& data, void* extra );
 		};
 		//*************************************************************//
 
@@ -457,9 +461,14 @@ namespace SGD
 			m_mVoices.clear();
 
 
+			// Let go of the mounted archive (audio still loaded)
+			m_HandleManager.ForEach( &AudioManager::ReleaseMapped, (void*)nullptr );
+
+
 			// Clear handles
 			m_VoiceManager.Clear();
 			m_HandleManager.Clear();
+			m_Index.Clear();
 
 			
 			// Release submix & master voices
@@ -485,6 +494,28 @@ namespace SGD
 
 
 
+		//*************************************************************//
+		// RELEASE MAPPED
+		//	- ForEach callback: a mapped buffer keeps reading the
+		//	  archive until it is unloaded
+		/*static*/ bool AudioManager::ReleaseMapped( Handle handle, AudioInfo& data, void* extra )
+		{
+			(void)handle;
+			(void)extra;
+
+			if( data.bMapped == true )
+			{
+				data.bMapped = false;
+				data.buffer.pAudioData = nullptr;
+				ReleaseArchivedFile();
+			}
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
 		//*************************************************************//
 		// GET MASTER VOLUME
 		int AudioManager::GetMasterVolume( AudioGroup group )
@@ -561,15 +592,14 @@ namespace SGD
 				return SGD::INVALID_HANDLE;
 
 
-			// Attempt to find the audio in the Handle Manager
-			SearchInfo search = { filename, nullptr, SGD::INVALID_HANDLE };
-			m_HandleManager.ForEach( &AudioManager::FindAudioByName, &search );
+			// Attempt to find the audio in the index
+			HAudio handle = m_Index.Find( filename );
 
 			// If it was found, increase the reference & return the existing handle
-			if( search.audio != NULL )
+			if( handle != SGD::INVALID_HANDLE )
 			{
-				search.audio->unRefCount++;
-				return search.handle;
+				m_HandleManager.GetData( handle )->unRefCount++;
+				return handle;
 			}
 
 
@@ -580,8 +610,24 @@ namespace SGD
 			ZeroMemory( &data.bufferwma, sizeof( data.bufferwma ) );
 
 
-			// Attempt to load from file
-			HRESULT hResult = LoadAudio( filename, data.format, data.buffer, data.bufferwma );
+			// Attempt to load from the mounted archive (stored files
+			// play straight from the mapping), or from file
+			const unsigned char*			bytes	= nullptr;
+			size_t							size	= 0;
+			std::vector< unsigned char >	expanded;
+
+			HRESULT hResult;
+			if( ReadArchivedFile( filename, bytes, size, expanded ) == true )
+			{
+				data.bMapped = expanded.empty();
+				hResult = LoadAudio( bytes, (DWORD)size, data.bMapped == false, data.format, data.buffer, data.bufferwma );
+
+				// Only a mapped buffer keeps reading the archive
+				if( data.bMapped == false || FAILED( hResult ) )
+					ReleaseArchivedFile();
+			}
+			else
+				hResult = LoadAudio( filename, data.format, data.buffer, data.bufferwma );
 			if( FAILED( hResult ) )
 			{
 				// MESSAGE
@@ -602,8 +648,10 @@ namespace SGD
 			data.fVolume		= 1.0f;
 
 
-			// Store audio into the Handle Manager
-			return m_HandleManager.StoreData( data );
+			// Store audio into the Handle Manager & index its name
+			handle = m_HandleManager.StoreData( data );
+			m_Index.Insert( filename, handle );
+			return handle;
 		}
 		//*************************************************************//
 
@@ -857,10 +905,14 @@ namespace SGD
 
 
 				// Deallocate the audio buffers
-				delete[] data->buffer.pAudioData;
+				if( data->bMapped == false )
+					delete[] data->buffer.pAudioData;
+				else
+					ReleaseArchivedFile();
 				delete[] data->bufferwma.pDecodedPacketCumulativeBytes;
 
 				// Deallocate the name
+				m_Index.Remove( data->wszFilename );
 				delete[] data->wszFilename;
 
 
@@ -1349,25 +1401,98 @@ namespace SGD
 				return E_UNEXPECTED;
 			}
 		}
-		//*************************************************************//
 
+		/*static*/ HRESULT AudioManager::FindChunk( const BYTE* pFile, DWORD dwFileSize, DWORD fourcc, DWORD& dwChunkSize, DWORD& dwChunkDataPosition )
+		{
+			// Same walk as the file version, within the bounds of the memory
+			DWORD dwOffset = 0;
 
+			while( dwFileSize - dwOffset >= sizeof(DWORD) * 2 )
+			{
+				DWORD dwChunkType;
+				DWORD dwChunkDataSize;
+				memcpy( &dwChunkType, pFile + dwOffset, sizeof(DWORD) );
+				memcpy( &dwChunkDataSize, pFile + dwOffset + sizeof(DWORD), sizeof(DWORD) );
 
-		//*************************************************************//
-		// FIND AUDIO BY NAME
-		/*static*/ bool AudioManager::FindAudioByName( Handle handle, AudioInfo& data, SearchInfo* extra )
-		{		
-			// Compare the names
-			if( wcscmp( data.wszFilename, extra->filename ) == 0 )
+				dwOffset += sizeof(DWORD) * 2;
+
+				// The RIFF chunk holds the rest (after its file type)
+				if( dwChunkType == E_CC_RIFF )
+					dwChunkDataSize = 4;
+
+				if( dwChunkDataSize > dwFileSize - dwOffset )
+					return E_FAIL;
+
+				if( dwChunkType == fourcc )
+				{
+					dwChunkSize = dwChunkDataSize;
+					dwChunkDataPosition = dwOffset;
+					return S_OK;
+				}
+
+				dwOffset += dwChunkDataSize;
+			}
+
+			return S_FALSE;
+		}
+
+		/*static*/ HRESULT AudioManager::LoadAudio( const BYTE* pFile, DWORD dwFileSize, bool bCopy, WAVEFORMATEXTENSIBLE& wfx, XAUDIO2_BUFFER& buffer, XAUDIO2_BUFFER_WMA& bufferWMA )
+		{
+			// Check the file type, should be 'WAVE' or 'XWMA'
+			DWORD dwChunkSize;
+			DWORD dwChunkPosition;
+			if( FindChunk( pFile, dwFileSize, E_CC_RIFF, dwChunkSize, dwChunkPosition ) != S_OK )
+				return E_UNEXPECTED;
+
+			DWORD filetype;
+			memcpy( &filetype, pFile + dwChunkPosition, sizeof(DWORD) );
+			if( filetype != E_CC_WAVE && filetype != E_CC_XWMA )
+				return E_UNEXPECTED;
+
+
+			// Find every chunk before allocating anything
+			DWORD dwFmtSize, dwFmtPosition;
+			DWORD dwDataSize, dwDataPosition;
+			DWORD dwDpdsSize = 0, dwDpdsPosition = 0;
+			if( FindChunk( pFile, dwFileSize, E_CC_FMT, dwFmtSize, dwFmtPosition ) != S_OK
+				|| FindChunk( pFile, dwFileSize, E_CC_DATA, dwDataSize, dwDataPosition ) != S_OK
+				|| ( filetype == E_CC_XWMA && FindChunk( pFile, dwFileSize, E_CC_DPDS, dwDpdsSize, dwDpdsPosition ) != S_OK ) )
+				return E_UNEXPECTED;
+
+
+			// Fill out the WAVEFORMATEXTENSIBLE structure with the contents of the FMT chunk
+			memcpy( &wfx, pFile + dwFmtPosition, ( dwFmtSize < sizeof( wfx ) ) ? dwFmtSize : sizeof( wfx ) );
+
+
+			// Play the DATA chunk in place, or copy it
+			// (when the memory does not outlive the audio)
+			if( bCopy == true )
 			{
-				// Audio does exist!
-				extra->audio	= &data;
-				extra->handle	= handle;
-				return false;
+				BYTE* pDataBuffer = new BYTE[ dwDataSize ];
+				memcpy( pDataBuffer, pFile + dwDataPosition, dwDataSize );
+				buffer.pAudioData = pDataBuffer;
 			}
+			else
+				buffer.pAudioData = pFile + dwDataPosition;
 
-			// Did not find yet
-			return true;
+			buffer.AudioBytes = dwDataSize;			// size of the audio buffer in bytes
+			buffer.Flags = XAUDIO2_END_OF_STREAM;	// tell the source voice not to expect any data after this buffer
+
+
+			// Fill the wma buffer if necessary
+			// (always copied: it must be DWORD aligned)
+			if( filetype == E_CC_XWMA )
+			{
+				UINT32  nPackets = (dwDpdsSize + (sizeof(UINT32)-1)) / sizeof(UINT32);	// round size to number of DWORDS
+				UINT32* pWmaDataBuffer = new UINT32[ nPackets ];
+				ZeroMemory( pWmaDataBuffer, nPackets * sizeof(UINT32) );
+				memcpy( pWmaDataBuffer, pFile + dwDpdsPosition, dwDpdsSize );
+
+				bufferWMA.PacketCount = nPackets;							// size of the audio buffer in DWORDS
+				bufferWMA.pDecodedPacketCumulativeBytes = pWmaDataBuffer;	// buffer containing wma data
+			}
+
+			return S_OK;
 		}
 		//*************************************************************//
 		
@@ -0,0 +1,193 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_Compression.cpp 								|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To compress & expand asset archive entries			|
+|																		|
+\***********************************************************************/
+
+#include "SGD_Compression.h"
+
+// Uses memcpy for reading 4 bytes at a time
+#include <cstring>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		namespace
+		{
+			enum
+			{
+				MIN_MATCH		= 4,				// shortest match worth an offset
+				MAX_OFFSET		= 0xFFFF,			// 16-bit offsets
+				HASH_BITS		= 14,				// match finder table: 2^14 positions
+				NO_POSITION		= 0xFFFFFFFF
+			};
+
+			inline unsigned int Read32( const unsigned char* p )
+			{
+				unsigned int value;
+				memcpy( &value, p, sizeof( value ) );
+				return value;
+			}
+
+			inline unsigned int Hash( unsigned int value )
+			{
+				return ( value * 2654435761u ) >> ( 32 - HASH_BITS );
+			}
+
+			// Lengths of 15 or more continue in extra bytes (255 = more follow)
+			inline void WriteLength( size_t length, std::vector< unsigned char >& output )
+			{
+				for( ; length >= 255; length -= 255 )
+					output.push_back( 255 );
+				output.push_back( (unsigned char)length );
+			}
+
+			inline bool ReadLength( const unsigned char*& in, const unsigned char* end, size_t& length )
+			{
+				unsigned char byte;
+				do
+				{
+					if( in == end )
+						return false;
+					byte = *in++;
+					length += byte;
+				} while( byte == 255 );
+
+				return true;
+			}
+
+			void WriteSequence( const unsigned char* literals, size_t numLiterals, size_t offset, size_t matchLength, std::vector< unsigned char >& output )
+			{
+				size_t extraMatch = ( matchLength >= MIN_MATCH ) ? matchLength - MIN_MATCH : 0;
+
+				unsigned char token = (unsigned char)( ( ( numLiterals < 15 ) ? numLiterals : 15 ) << 4 );
+				if( matchLength >= MIN_MATCH )
+					token |= (unsigned char)( ( extraMatch < 15 ) ? extraMatch : 15 );
+				output.push_back( token );
+
+				if( numLiterals >= 15 )
+					WriteLength( numLiterals - 15, output );
+				output.insert( output.end(), literals, literals + numLiterals );
+
+				// The last sequence stops after its literals
+				if( matchLength < MIN_MATCH )
+					return;
+
+				output.push_back( (unsigned char)( offset & 0xFF ) );
+				output.push_back( (unsigned char)( offset >> 8 ) );
+
+				if( extraMatch >= 15 )
+					WriteLength( extraMatch - 15, output );
+			}
+		}
+
+
+		//*************************************************************//
+		// COMPRESS LZ
+		//	- greedy: the last position seen with the same 4 bytes is
+		//	  the match candidate
+		size_t CompressLZ( const unsigned char* data, size_t size, std::vector< unsigned char >& output )
+		{
+			size_t start = output.size();
+
+			std::vector< unsigned int > table( (size_t)1 << HASH_BITS, (unsigned int)NO_POSITION );
+
+			size_t anchor	= 0;		// first byte not written yet
+			size_t pos		= 0;
+
+			while( pos + MIN_MATCH <= size )
+			{
+				unsigned int	value		= Read32( data + pos );
+				unsigned int&	slot		= table[ Hash( value ) ];
+				size_t			candidate	= slot;
+				slot = (unsigned int)pos;
+
+				if( candidate == NO_POSITION || pos - candidate > MAX_OFFSET || Read32( data + candidate ) != value )
+				{
+					pos++;
+					continue;
+				}
+
+				// Extend the match
+				size_t length = MIN_MATCH;
+				while( pos + length < size && data[ candidate + length ] == data[ pos + length ] )
+					length++;
+
+				WriteSequence( data + anchor, pos - anchor, pos - candidate, length, output );
+
+				pos		+= length;
+				anchor	= pos;
+			}
+
+			// The rest is literals
+			WriteSequence( data + anchor, size - anchor, 0, 0, output );
+			return output.size() - start;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// DECOMPRESS LZ
+		bool DecompressLZ( const unsigned char* data, size_t size, unsigned char* output, size_t outputSize )
+		{
+			const unsigned char*	in		= data;
+			const unsigned char*	end		= data + size;
+			size_t					written	= 0;
+
+			while( in < end )
+			{
+				unsigned char token = *in++;
+
+				// Literals
+				size_t numLiterals = token >> 4;
+				if( numLiterals == 15 && ReadLength( in, end, numLiterals ) == false )
+					return false;
+
+				if( numLiterals > (size_t)( end - in ) || numLiterals > outputSize - written )
+					return false;
+
+				if( numLiterals > 0 )
+					memcpy( output + written, in, numLiterals );
+				in		+= numLiterals;
+				written	+= numLiterals;
+
+				// Last sequence?
+				if( in == end )
+					break;
+
+
+				// Match
+				if( end - in < 2 )
+					return false;
+
+				size_t offset = in[ 0 ] | ( in[ 1 ] << 8 );
+				in += 2;
+
+				size_t length = token & 0x0F;
+				if( length == 15 && ReadLength( in, end, length ) == false )
+					return false;
+				length += MIN_MATCH;
+
+				if( offset == 0 || offset > written || length > outputSize - written )
+					return false;
+
+				// Byte by byte: the match can overlap what it writes
+				const unsigned char* from = output + written - offset;
+				for( size_t i = 0; i < length; i++ )
+					output[ written + i ] = from[ i ];
+				written += length;
+			}
+
+			return written == outputSize;
+		}
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
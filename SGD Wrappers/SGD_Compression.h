@@ -0,0 +1,49 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_Compression.h 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To compress & expand asset archive entries			|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_COMPRESSION_H
+#define SGD_COMPRESSION_H
+
+
+// Uses size_t
+#include <cstddef>
+
+// Uses std::vector for the compressed output
+#include <vector>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// LZ compression
+		//	- byte-oriented LZ77 (the LZ4 block layout): each sequence is
+		//	  a token (literal count, match length - 4), its literals,
+		//	  then a 16-bit offset back into the output & the match;
+		//	  the last sequence only has literals
+		//	- fast to expand (no entropy coding), for entries that are
+		//	  not compressed already (.wav rather than .png or .xwm)
+
+		// CompressLZ:
+		//	- appends the compressed data to 'output'
+		//	- returns the compressed size
+		size_t	CompressLZ		( const unsigned char* data, size_t size, std::vector< unsigned char >& output );
+
+		// DecompressLZ:
+		//	- expands into 'output', which must be exactly 'outputSize' bytes
+		//	- false if the data is corrupt (never writes past the output)
+		bool	DecompressLZ	( const unsigned char* data, size_t size, unsigned char* output, size_t outputSize );
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+#endif //SGD_COMPRESSION_H
@@ -19,9 +19,20 @@
 // Uses strcmp for comparisons
 #include <cstring>
 
+// Uses std::unordered_map & std::deque for interning event IDs
+#include <string>
+#include <deque>
+#include <unordered_map>
+
+// Uses std::mutex for interning from any thread
+#include <mutex>
+
 // Uses Event Manager
 #include "SGD_EventManager.h"
 
+// Uses FrameArena for allocation
+#include "SGD_FrameArena.h"
+
 // Uses SGD_ASSERT for debug breaks
 #include "SGD_Utilities.h"
 
@@ -31,63 +42,96 @@ namespace SGD
 
 #pragma region EVENTID_METHODS
 	
+	//*****************************************************************//
+	// EVENT ID INTERNING
+	//	- names map to consecutive integers, index 0 is 'no event'
+	//	- the table is a function static, so global EventID constants
+	//	  can be constructed in any order during startup
+	namespace
+	{
+		struct EventIDTable
+		{
+			std::mutex									lock;
+			std::unordered_map< std::string, unsigned int >	indices;
+			std::deque< std::string >					names;		// by index (never moves)
+
+			EventIDTable( void )	{	names.push_back( "" );	}
+		};
+
+		EventIDTable& GetEventIDTable( void )
+		{
+			static EventIDTable table;
+			return table;
+		}
+	}
+
+
 	//*****************************************************************//
 	// EVENT ID METHODS
 
-	// Default constructor
+	// Overloaded constructor
+	//	- look up the name's integer (assigning the next one if new)
 	EventID::EventID( const char* str )
+		: m_unIndex( 0 )
 	{
-		// Copy the parameter
-		memcpy( id, str, SIZE );
-
-		// Pad the remaining string with null terminators (for quick mem compare)
-		int eos = 0;
-		while( eos < SIZE && id[ eos ] != '\0' )
-			eos++;
-		while( eos < SIZE )
-			id[ eos++ ] = '\0';
-	}
+		if( str == nullptr || str[ 0 ] == '\0' )
+			return;
 
-	// Is-equal-to
-	bool EventID::operator == ( const EventID& other ) const
-	{
-		return memcmp( id, other.id, SIZE ) == 0;
+		EventIDTable& table = GetEventIDTable();
+		std::lock_guard< std::mutex > guard( table.lock );
+
+		std::unordered_map< std::string, unsigned int >::const_iterator iter = table.indices.find( str );
+		if( iter != table.indices.end() )
+		{
+			m_unIndex = iter->second;
+			return;
+		}
+
+		m_unIndex = (unsigned int)table.names.size();
+		table.names.push_back( str );
+		table.indices[ table.names.back() ] = m_unIndex;
 	}
-	
-	// Not-equal-to
-	bool EventID::operator != ( const EventID& other ) const
+
+	// Interned name
+	const char* EventID::GetName( void ) const
 	{
-		return memcmp( id, other.id, SIZE ) != 0;
+		EventIDTable& table = GetEventIDTable();
+		std::lock_guard< std::mutex > guard( table.lock );
+
+		return table.names[ m_unIndex ].c_str();
 	}
 
-	// Less-than
-	bool EventID::operator < ( const EventID& other ) const
+	// Interned so far
+	/*static*/ unsigned int EventID::GetNumIDs( void )
 	{
-		return strcmp( id, other.id ) < 0;
+		EventIDTable& table = GetEventIDTable();
+		std::lock_guard< std::mutex > guard( table.lock );
+
+		return (unsigned int)table.names.size();
 	}
 
 	// Is-equal-to string
 	bool EventID::operator == ( const char* str ) const
 	{
-		return strcmp( id, str ) == 0;
+		return strcmp( GetName(), str ) == 0;
 	}
 
 	// Not-equal-to string
 	bool EventID::operator != ( const char* str ) const
 	{
-		return strcmp( id, str ) != 0;
+		return strcmp( GetName(), str ) != 0;
 	}
 
 	// String is-equal-to
 	/*friend*/ bool operator == ( const char* str, const EventID& other )
 	{
-		return strcmp( str, other.id ) == 0;
+		return strcmp( str, other.GetName() ) == 0;
 	}
 
 	// String not-equal-to
 	/*friend*/ bool operator != ( const char* str, const EventID& other )
 	{
-		return strcmp( str, other.id ) != 0;
+		return strcmp( str, other.GetName() ) != 0;
 	}
 	//*****************************************************************//
 
@@ -106,22 +150,42 @@ namespace SGD
 		void*			data,			// attached data (any type)
 		void*			sender			// object that sent the event
 	)
-	: m_pData{ data }, m_pSender{ sender }
+	: m_pData{ data }, m_pSender{ sender }, m_unCount{ 1 }
 	{
 		// Validate the ID
 		SGD_ASSERT( eventID != nullptr, "Event::Event - event ID cannot be null!" );
 		if( eventID == nullptr )
 			return;
 
-		SGD_ASSERT( strlen( eventID ) < 32, "Event::Event - event ID length cannot exceed 31 characters!" );
-		if( strlen( eventID ) >= 32 )
-			return;
-
 
-		// Store the ID		
+		// Store the ID (interned)
 		m_ID = eventID;
 	}
 
+	// Overloaded constructor
+	Event::Event
+	(	
+		const EventID&	eventID,		// interned event ID
+		void*			data,			// attached data (any type)
+		void*			sender			// object that sent the event
+	)
+	: m_ID{ eventID }, m_pData{ data }, m_pSender{ sender }, m_unCount{ 1 }
+	{
+		// Validate the ID
+		SGD_ASSERT( eventID.GetIndex() != 0, "Event::Event - event ID cannot be empty!" );
+	}
+
+	// Allocation:
+	/*static*/ void* Event::operator new( size_t size )
+	{
+		return FrameArena::GetInstance()->Allocate( size );
+	}
+
+	/*static*/ void Event::operator delete( void* p )
+	{
+		FrameArena::GetInstance()->Deallocate( p );
+	}
+
 	// EventManager Interaction:
 	bool Event::QueueEvent( const void* destination ) const
 	{
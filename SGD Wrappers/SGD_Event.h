@@ -17,36 +17,49 @@
 #define SGD_EVENT_H
 
 
+// Uses size_t for allocation
+#include <cstddef>
+
 namespace SGD
 {
+	// Forward declaration (merges coalesced events)
+	namespace SGD_IMPLEMENTATION	{	class EventManager;	}
+
+
 	//*****************************************************************//
 	// EventID
-	//	- 32 character string (optimized for comparisons)
+	//	- event name interned to a small integer (optimized for comparisons)
+	//	- the first EventID made from a name assigns the integer, later
+	//	  ones look it up: construct frequently sent IDs once (constants)
+	//	  instead of from a string literal per event
 	class EventID
 	{
 	public:
-		EventID( void )										// default constructor
-			{	id[ 0 ] = 0;	}
-		EventID( const char* str );							// overloaded constructor
-
-		char&		operator [] ( unsigned int i )			// array accessor
-			{	return id[ i ];	}
-		const char& operator [] ( unsigned int i ) const	// const array accessor
-			{	return id[ i ];	}
-
-		bool operator == ( const EventID& other ) const;	// is-equal-to
-		bool operator != ( const EventID& other ) const;	// not-equal-to
-		bool operator <  ( const EventID& other ) const;	// less-than
+		EventID( void )										// default constructor (no event)
+			: m_unIndex( 0 )	{	}
+		EventID( const char* str );							// overloaded constructor (interns the name)
+
+		unsigned int	GetIndex	( void ) const			// interned integer (0 = no event)
+			{	return m_unIndex;	}
+		const char*		GetName		( void ) const;			// interned name
+
+		bool operator == ( const EventID& other ) const		// is-equal-to
+			{	return m_unIndex == other.m_unIndex;	}
+		bool operator != ( const EventID& other ) const		// not-equal-to
+			{	return m_unIndex != other.m_unIndex;	}
+		bool operator <  ( const EventID& other ) const		// less-than (interning order)
+			{	return m_unIndex <  other.m_unIndex;	}
 		
-		bool operator == ( const char* str )	  const;	// is-equal-to string
-		bool operator != ( const char* str )	  const;	// not-equal-to string
+		bool operator == ( const char* str )	  const;	// is-equal-to string (slower)
+		bool operator != ( const char* str )	  const;	// not-equal-to string (slower)
 		
 		friend bool operator == ( const char* str, const EventID& other );	// string is-equal-to
 		friend bool operator != ( const char* str, const EventID& other );	// string not-equal-to
 
+		static unsigned int	GetNumIDs	( void );			// interned so far (including 'no event')
+
 	private:
-		enum { SIZE = 32 };	// compile-time constant
-		char id[ SIZE ];	// event ID (limited to 32 characters!)
+		unsigned int	m_unIndex;	// interned integer
 	};
 
 
@@ -57,8 +70,12 @@ namespace SGD
 	class Event
 	{
 	public:
-		// Overloaded constructor
-		Event	(	const char*		eventID,						// event ID / name (limited to 32 characters!)
+		// Overloaded constructors
+		Event	(	const char*		eventID,						// event ID / name
+					void*			data			= nullptr,		// attached data (any type)
+					void*			sender			= nullptr		// object that sent the event
+				);
+		Event	(	const EventID&	eventID,						// interned event ID (faster)
 					void*			data			= nullptr,		// attached data (any type)
 					void*			sender			= nullptr		// object that sent the event
 				);
@@ -67,6 +84,13 @@ namespace SGD
 		virtual ~Event	( void )	= default;
 
 
+		// Allocation:
+		//	- new / delete use the FrameArena (queued events only
+		//	  live until the EventManager's next Update)
+		static void*	operator new	( size_t size );
+		static void		operator delete	( void* p );
+
+
 		// EventManager Interaction:
 		bool			QueueEvent		( const void* destination = nullptr )	const;	// event will be stored & deallocated by the EventManager
 		bool			SendEventNow	( const void* destination = nullptr )	const;	// event will NOT be stored or deallocated!
@@ -76,16 +100,20 @@ namespace SGD
 		const EventID&	GetEventID		( void )	const	{	return m_ID;			}
 		void*			GetData			( void )	const	{	return m_pData;			}
 		void*			GetSender		( void )	const	{	return m_pSender;		}
+		unsigned int	GetCount		( void )	const	{	return m_unCount;		}	// queued events coalesced into this one
 
 
 	private:
 		Event				( const Event& )	= delete;	// Copy constructor
 		Event& operator=	( const Event& )	= delete;	// Assignment operator
 
+		friend class SGD_IMPLEMENTATION::EventManager;		// counts the coalesced events
+
 		// members:
-		EventID			m_ID;					// event ID (limited to 32 characters!)
+		EventID			m_ID;					// interned event ID
 		void*			m_pData;				// attached data (can point to any type)
 		void*			m_pSender;				// object that sent the event
+		unsigned int	m_unCount;				// queued events coalesced into this one
 	};
 
 }	// namespace SGD
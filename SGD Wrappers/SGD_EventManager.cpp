@@ -16,17 +16,16 @@
 #include "SGD_EventManager.h"
 
 
-// Uses std::string for mapping event IDs
-#include <string>
-
-// Uses std::queue for storing events
-#include <queue>
+// Uses std::vector for storing events & listeners (indexed by interned event ID)
+#include <vector>
 
-// Uses std::multimap for storing listeners
-#include <map>
+// Uses std::unordered_map for finding the listener of a destination
+#include <unordered_map>
 
-// Uses std::vector for storing current event listeners
-#include <vector>
+// Uses MPSCQueue & std::mutex for receiving events from other threads
+#include "SGD_MPSCQueue.h"
+#include <atomic>
+#include <mutex>
 
 // Uses Event & Listener
 #include "SGD_Event.h"
@@ -57,18 +56,26 @@ namespace SGD
 
 			virtual bool		RegisterForEvent	( IListener* listener, const char* eventID )		override;
 			virtual bool		UnregisterFromEvent	( IListener* listener, const char* eventID )		override;
+			virtual bool		RegisterForEvent	( IListener* listener, const EventID& eventID )		override;
+			virtual bool		UnregisterFromEvent	( IListener* listener, const EventID& eventID )		override;
 
 			virtual bool		QueueEvent			( const Event* pEvent, const void* destination )	override;
 			virtual bool		SendEventNow		( const Event* pEvent, const void* destination )	override;
 
 			virtual bool		ClearEvents			( void )					override;
+
+			virtual bool		SetCoalescing		( const EventID& eventID, bool coalesce, MergeProc pfMerge )	override;
+
+			virtual bool		BeginCapture		( unsigned int numStreams )	override;
+			virtual bool		SetCaptureStream	( unsigned int stream )		override;
+			virtual bool		EndCapture			( void )					override;
 			
 
 		private:
 			// SINGLETON
 			static	EventManager*		s_Instance;		// the ONE instance
 
-			EventManager				( void )				= default;		// Default constructor
+			EventManager				( void );								// Default constructor
 			virtual	~EventManager		( void )				= default;		// Destructor
 
 			EventManager				( const EventManager& )	= delete;		// Copy constructor
@@ -86,16 +93,111 @@ namespace SGD
 			EEventManagerStatus			m_eStatus	= E_UNINITIALIZED;		// wrapper initialization status
 			
 			typedef	std::pair< const Event*, const void* >	EventDestinationPair;
-			typedef std::queue< EventDestinationPair >		EventQueue;
-			EventQueue					m_qEvents;							// event queue
+			typedef std::vector< EventDestinationPair >		EventQueue;
+			EventQueue					m_vEvents;							// event queue (keeps its memory)
+			unsigned int				m_unNextEvent	= 0;				// first event not processed yet
+
+			// Registrations:
+			//	- each (listener, event ID) pair owns a slot, stamped with the
+			//	  slot's generation when it was registered
+			//	- unregistering bumps the generation & frees the slot, so any
+			//	  copied handle to it is stale (checked with one compare)
+			struct Registration
+			{
+				IListener*		listener;
+				unsigned int	generation;
+			};
+
+			struct ListenerHandle
+			{
+				unsigned int	slot;
+				unsigned int	generation;
+			};
 
-			typedef std::multimap< EventID, IListener* >	ListenerMap;
-			typedef ListenerMap::const_iterator				LMapIter;
-			typedef ListenerMap::value_type					LMapValue;
-			typedef std::pair< LMapIter, LMapIter >			LMapRange;
-			typedef std::vector< IListener* >				ListenerVector;
-			ListenerMap					m_mListeners;						// registered listeners
-			ListenerMap					m_mUnlisteners;						// unregistered listeners
+			typedef std::vector< ListenerHandle >			ListenerVector;
+			typedef std::vector< ListenerVector >			ListenerTable;
+			ListenerTable				m_vListeners;						// registered listeners, by event ID index (stale handles removed lazily)
+			std::vector< Registration >	m_vRegistrations;					// registration slots
+			std::vector< unsigned int >	m_vFreeSlots;						// unused registration slots
+			ListenerVector				m_vDispatch;						// listeners of the event being updated
+
+			// Destination lookup:
+			//	- each listener is keyed by its object's address (dynamic_cast< const void* >)
+			//	  when it first registers, so a targeted event is one hash lookup
+			struct TargetKey
+			{
+				const void*		object;
+				unsigned int	id;
+
+				bool operator== ( const TargetKey& other ) const	{	return object == other.object && id == other.id;	}
+			};
+
+			struct TargetHash
+			{
+				size_t operator() ( const TargetKey& key ) const	{	return std::hash< const void* >()( key.object ) ^ ( key.id * 2654435761u );	}
+			};
+
+			typedef std::unordered_map< TargetKey, unsigned int, TargetHash >	TargetMap;
+			typedef std::unordered_map< IListener*, const void* >				ObjectMap;
+			TargetMap					m_mTargets;							// (object, event ID) -> registration slot
+			ObjectMap					m_mObjects;							// listener -> object address
+
+			// Coalescing:
+			//	- the queue index of the event still waiting for each
+			//	  (destination, event ID) of a coalescing ID
+			//	- open-addressed table (linear probing) that keeps its
+			//	  memory: a slot is only in use while it carries the
+			//	  current epoch, so clearing it is one increment
+			struct CoalesceRule
+			{
+				bool			coalesce;
+				MergeProc		merge;
+			};
+
+			struct PendingSlot
+			{
+				TargetKey		key;
+				unsigned int	index;		// queue index
+				unsigned int	epoch;		// in use while == m_unPendingEpoch
+			};
+
+			std::vector< CoalesceRule >	m_vCoalesce;						// coalescing rules, by event ID index
+			std::vector< PendingSlot >	m_vPending;							// (destination, event ID) -> queue index (power of 2 slots)
+			unsigned int				m_unPendingCount	= 0;			// slots in use
+			unsigned int				m_unPendingEpoch	= 1;
+
+			unsigned int&	FindPending		( const TargetKey& key, unsigned int index, bool& inserted );
+			void			GrowPending		( void );
+			void			ClearPending	( void );
+
+			void		Enqueue				( const EventDestinationPair& eventPair );
+
+			void		ReleaseSlot			( unsigned int slot );
+			void		CompactListeners	( unsigned int id );
+			void		CollectListeners	( unsigned int id, const void* destination, ListenerVector& vec );
+
+			typedef std::vector< EventDestinationPair >		EventStream;
+			std::vector< EventStream >	m_vCaptureStreams;					// events captured per stream
+			bool						m_bCapturing	= false;			// between BeginCapture & EndCapture
+
+			static SGD_THREAD_LOCAL unsigned int	s_unCaptureStream;		// the calling thread's stream
+
+			// Posting (from threads other than the one that initialized):
+			//	- lock-free ring, received at the start of Update
+			//	- when the ring is full, a locked overflow list is used
+			//	  until Update receives it, so each thread's posts
+			//	  arrive in order
+			enum { POST_CAPACITY = 4096 };
+
+			MPSCQueue< EventDestinationPair >	m_qPosted;					// events posted by other threads
+			std::vector< EventDestinationPair >	m_vOverflow;				// posted events that did not fit
+			std::mutex							m_mtxOverflow;
+			std::atomic< bool >					m_bOverflowed;
+
+			static SGD_THREAD_LOCAL bool	s_bOwnerThread;					// the calling thread initialized the wrapper
+
+			void		Post				( const EventDestinationPair& eventPair );
+			void		ReceivePosted		( void );
 
 		};
 		//*************************************************************//
@@ -130,6 +232,12 @@ namespace SGD
 		// Instantiate static pointer to null (no instance yet)
 		/*static*/ EventManager* EventManager::s_Instance = nullptr;
 
+		// No thread captures until it selects a stream
+		/*static*/ SGD_THREAD_LOCAL unsigned int EventManager::s_unCaptureStream = NO_CAPTURE_STREAM;
+
+		// Only the initializing thread queues directly
+		/*static*/ SGD_THREAD_LOCAL bool EventManager::s_bOwnerThread = false;
+
 		// Singleton accessor
 		/*static*/ EventManager* EventManager::GetInstance( void )
 		{
@@ -161,6 +269,10 @@ namespace SGD
 			if( m_eStatus == E_INITIALIZED )
 				return false;
 
+
+			// Other threads post to the ring
+			s_bOwnerThread = true;
+
 			
 			// Success!
 			m_eStatus = E_INITIALIZED;
@@ -170,6 +282,16 @@ namespace SGD
 
 
 
+		//*************************************************************//
+		// CONSTRUCTOR
+		EventManager::EventManager( void )
+			: m_qPosted( POST_CAPACITY ), m_bOverflowed( false )
+		{
+		}
+		//*************************************************************//
+
+
+
 		//*************************************************************//
 		// UPDATE
 		bool EventManager::Update( void )
@@ -180,77 +302,45 @@ namespace SGD
 				return false;
 
 
+			// Receive the events posted by other threads
+			ReceivePosted();
+
+
 			// Iterate through the entire queue
-			while( m_qEvents.empty() == false )
+			//	(including events queued by the listeners)
+			while( m_unNextEvent < m_vEvents.size() )
 			{
 				// Dequeue the first event
-				EventDestinationPair eventPair = m_qEvents.front();
-				m_qEvents.pop();
+				EventDestinationPair eventPair = m_vEvents[ m_unNextEvent++ ];
 
 				
-				// Hold a local ref to the ID (for readability)
-				const EventID& id = eventPair.first->GetEventID();
+				// Interned ID (indexes the listener table)
+				unsigned int id = eventPair.first->GetEventID().GetIndex();
 
 
-				// Send the event to all registered listeners for processing
-				LMapRange range = m_mListeners.equal_range( id );
-				if( range.first != range.second )
-				{
-					// Copy the intended listeners
-					ListenerVector vec;
+				// Copy the intended listeners
+				//	(HandleEvent may register or unregister listeners)
+				CollectListeners( id, eventPair.second, m_vDispatch );
 
-					// All listeners?
-					if( eventPair.second == nullptr )
-					{
-						for( LMapIter iter = range.first; iter != range.second; ++iter )
-							vec.push_back( iter->second );
-					}
-					else 
-					{
-						// One intended listener (which may not exist)
-						for( LMapIter iter = range.first; iter != range.second; ++iter )
-						{
-							if( dynamic_cast< const void* >( iter->second ) == eventPair.second )
-							{
-								vec.push_back( iter->second );
-								break;
-							}
-						}
-					}
+				// Send the event to the current listeners
+				for( unsigned int i = 0; i < m_vDispatch.size(); i++ )
+				{
+					// Has this listener been removed from this event?
+					const Registration& reg = m_vRegistrations[ m_vDispatch[ i ].slot ];
+					if( reg.generation != m_vDispatch[ i ].generation )
+						continue;	// skip over the HandleEvent
 
-					// Send the event to the current listeners
-					for( unsigned int i = 0; i < vec.size(); i++ )
-					{
-						// Has a listener been removed from this event?
-						if( m_mUnlisteners.empty() == false )
-						{
-							LMapRange removed = m_mUnlisteners.equal_range( id );
-							if( removed.first != removed.second )
-							{
-								// Is this listener marked for removal from this event?
-								LMapIter iter = std::find( removed.first, removed.second, LMapValue( id, vec[i] ) );
-								if( iter != removed.second )
-								{
-									m_mUnlisteners.erase( iter );
-
-									// Skip over the HandleEvent
-									continue;
-								}
-							}
-						}
-
-						// Send event
-						vec[ i ]->HandleEvent( eventPair.first );
-					}
+					// Send event
+					reg.listener->HandleEvent( eventPair.first );
 				}
 				
 				// Deallocate the event
 				delete eventPair.first;
 			}
 
-
-			// Unregistered listeners have all been processed
-			m_mUnlisteners.clear();
+			m_vEvents.clear();
+			m_unNextEvent = 0;
+			ClearPending();
 			return true;
 		}
 		//*************************************************************//
@@ -268,15 +358,26 @@ namespace SGD
 
 			
 			// Deallocate all events in the queue
-			while( m_qEvents.empty() == false )
-			{
-				delete m_qEvents.front().first;
-				m_qEvents.pop();
-			}
+			ClearEvents();
+
+			// Deallocate all captured events
+			for( unsigned int s = 0; s < m_vCaptureStreams.size(); s++ )
+				for( unsigned int i = 0; i < m_vCaptureStreams[ s ].size(); i++ )
+					delete m_vCaptureStreams[ s ][ i ].first;
+			m_vCaptureStreams.clear();
+			m_bCapturing = false;
 
 			// Remove the registered listeners
-			m_mListeners.clear();
-			m_mUnlisteners.clear();
+			m_vListeners.clear();
+			m_vRegistrations.clear();
+			m_vFreeSlots.clear();
+			m_mTargets.clear();
+			m_mObjects.clear();
+
+			// Remove the coalescing rules
+			m_vCoalesce.clear();
+
+			s_bOwnerThread = false;
 
 
 			m_eStatus = E_DESTROYED;
@@ -289,6 +390,17 @@ namespace SGD
 		//*************************************************************//
 		// REGISTER FOR EVENT
 		bool EventManager::RegisterForEvent( IListener* listener, const char* eventID )
+		{	
+			// Sanity-check the parameter
+			SGD_ASSERT( eventID != nullptr, "EventManager::RegisterForEvent - event ID cannot be null" );
+			if( eventID == nullptr )
+				return false;
+
+			// Intern the C-style string parameter
+			return RegisterForEvent( listener, EventID( eventID ) );
+		}
+
+		bool EventManager::RegisterForEvent( IListener* listener, const EventID& eventID )
 		{	
 			// Sanity-check the wrapper's status
 			SGD_ASSERT( m_eStatus == E_INITIALIZED, "EventManager::RegisterForEvent - wrapper has not been initialized" );
@@ -300,24 +412,54 @@ namespace SGD
 			if( listener == nullptr )
 				return false;
 
-			SGD_ASSERT( eventID != nullptr, "EventManager::RegisterForEvent - event ID cannot be null" );
-			if( eventID == nullptr )
+			SGD_ASSERT( eventID.GetIndex() != 0, "EventManager::RegisterForEvent - event ID cannot be empty" );
+			if( eventID.GetIndex() == 0 )
 				return false;
 
 
-			// Convert the C-style string parameter to an EventID
-			EventID id = eventID;
+			// Key the listener by its object's address (the first time)
+			ObjectMap::iterator object = m_mObjects.find( listener );
+			if( object == m_mObjects.end() )
+				object = m_mObjects.insert( ObjectMap::value_type( listener, dynamic_cast< const void* >( listener ) ) ).first;
 
 
 			// Check if the listener is NOT already registered
-			LMapRange range = m_mListeners.equal_range( id );
-			for( LMapIter iter = range.first; iter != range.second; ++iter )
-				if( iter->second == listener )
-					return true;		// already registered!
+			unsigned int id = eventID.GetIndex();
+			TargetKey key = { object->second, id };
+			std::pair< TargetMap::iterator, bool > target = m_mTargets.insert( TargetMap::value_type( key, 0 ) );
+			if( target.second == false )
+				return true;		// already registered!
+
+
+			// Claim a registration slot (keeping its generation)
+			unsigned int slot;
+			if( m_vFreeSlots.empty() == false )
+			{
+				slot = m_vFreeSlots.back();
+				m_vFreeSlots.pop_back();
+			}
+			else
+			{
+				slot = m_vRegistrations.size();
+				Registration reg = { nullptr, 0 };
+				m_vRegistrations.push_back( reg );
+			}
+
+			m_vRegistrations[ slot ].listener = listener;
+			target.first->second = slot;
 
 
 			// Register the new listener
-			m_mListeners.insert( LMapValue( id, listener ) );
+			if( id >= m_vListeners.size() )
+				m_vListeners.resize( id + 1 );
+
+			// Drop the stale handles before the list would grow
+			//	(events that are never broadcast never compact it)
+			if( m_vListeners[ id ].size() == m_vListeners[ id ].capacity() )
+				CompactListeners( id );
+
+			ListenerHandle handle = { slot, m_vRegistrations[ slot ].generation };
+			m_vListeners[ id ].push_back( handle );
 			return true;
 		}
 		//*************************************************************//
@@ -327,6 +469,17 @@ namespace SGD
 		//*************************************************************//
 		// UNREGISTER FROM EVENT
 		bool EventManager::UnregisterFromEvent( IListener* listener, const char* eventID )
+		{	
+			// Unregister from all events?
+			if( eventID == nullptr )
+				return UnregisterFromEvent( listener, EventID() );
+
+			// Intern the C-style string parameter
+			return UnregisterFromEvent( listener, EventID( eventID ) );
+		}
+
+		//	- the empty EventID unregisters from all events
+		bool EventManager::UnregisterFromEvent( IListener* listener, const EventID& eventID )
 		{	
 			// Sanity-check the wrapper's status
 			SGD_ASSERT( m_eStatus == E_INITIALIZED, "EventManager::UnregisterFromEvent - wrapper has not been initialized" );
@@ -339,41 +492,37 @@ namespace SGD
 				return false;
 
 
-			// Should we unregister from all events?
-			if( eventID == nullptr )
+			// Never registered?
+			ObjectMap::iterator object = m_mObjects.find( listener );
+			if( object == m_mObjects.end() )
+				return true;
+
+
+			// Unregister from all events?
+			if( eventID.GetIndex() == 0 )
 			{
-				// Unregister from all events
-				LMapIter iter = m_mListeners.begin(); 
-				while( iter != m_mListeners.end() )
+				for( unsigned int id = 1; id < m_vListeners.size(); id++ )
 				{
-					if( iter->second == listener )
+					TargetKey key = { object->second, id };
+					TargetMap::iterator target = m_mTargets.find( key );
+					if( target != m_mTargets.end() )
 					{
-						m_mUnlisteners.insert( *iter );
-						iter = m_mListeners.erase( iter );
-						continue;	// may be listening to another event
+						ReleaseSlot( target->second );
+						m_mTargets.erase( target );
 					}
-					
-					++iter;
 				}
+
+				m_mObjects.erase( object );
 			}
-			else 
+			else
 			{
-				// Find all registered listeners for the event
-				EventID id = eventID;
-				LMapRange range = m_mListeners.equal_range( id );
-				
-				// Unregister from the event
-				LMapIter iter = range.first; 
-				while( iter != range.second )
+				// Cannot be listening to the same event twice
+				TargetKey key = { object->second, eventID.GetIndex() };
+				TargetMap::iterator target = m_mTargets.find( key );
+				if( target != m_mTargets.end() )
 				{
-					if( iter->second == listener )
-					{
-						m_mUnlisteners.insert( *iter );
-						iter = m_mListeners.erase( iter );
-						break;		// cannot be listening to the same event again
-					}
-					
-					++iter;
+					ReleaseSlot( target->second );
+					m_mTargets.erase( target );
 				}
 			}
 
@@ -397,9 +546,23 @@ namespace SGD
 			if( pEvent == nullptr )
 				return false;
 
+
+			// Is the calling thread capturing?
+			if( m_bCapturing == true && s_unCaptureStream < m_vCaptureStreams.size() )
+			{
+				m_vCaptureStreams[ s_unCaptureStream ].push_back( EventDestinationPair{ pEvent, destination } );
+				return true;
+			}
+
+			// Is it from another thread?
+			if( s_bOwnerThread == false )
+			{
+				Post( EventDestinationPair{ pEvent, destination } );
+				return true;
+			}
 			
 			// Queue the event
-			m_qEvents.push( EventDestinationPair{ pEvent, destination } );
+			Enqueue( EventDestinationPair{ pEvent, destination } );
 			
 			return true;
 		}
@@ -422,56 +585,27 @@ namespace SGD
 				return false;
 
 				
-			// Hold a local ref (for readability)
-			const EventID& id = pEvent->GetEventID();
+			// Interned ID (indexes the listener table)
+			unsigned int id = pEvent->GetEventID().GetIndex();
+
+
+			// Copy the intended listeners
+			//	(local, since this may be called from a HandleEvent)
+			ListenerVector vec;
+			CollectListeners( id, destination, vec );
 
 
 			// Send the event to all registered listeners to process
 			// (does not deallocate the event)
-			LMapRange range = m_mListeners.equal_range( id );
-			if( range.first != range.second )
+			for( unsigned int i = 0; i < vec.size(); i++ )
 			{
-				// Copy the intended listeners
-				ListenerVector vec;
+				// Has this listener been removed from the event?
+				const Registration& reg = m_vRegistrations[ vec[ i ].slot ];
+				if( reg.generation != vec[ i ].generation )
+					continue;
 
-				// All listeners?
-				if( destination == nullptr )
-				{
-					for( LMapIter iter = range.first; iter != range.second; ++iter )
-						vec.push_back( iter->second );
-				}
-				else 
-				{
-					// One intended listener (which may not exist)
-					for( LMapIter iter = range.first; iter != range.second; ++iter )
-					{
-						if( dynamic_cast< const void* >( iter->second ) == destination )
-						{
-							vec.push_back( iter->second );
-							break;
-						}
-					}
-				}
-
-
-				// Send the event to the current listeners
-				for( unsigned int i = 0; i < vec.size(); i++ )
-				{
-					// Has this listener been removed from the event?
-					if( m_mUnlisteners.empty() == false )
-					{
-						LMapRange removed = m_mUnlisteners.equal_range( id );
-						if( removed.first != removed.second )
-						{
-							LMapIter iter = std::find( removed.first, removed.second, LMapValue( id, vec[i] ) );
-							if( iter != removed.second )
-								continue;
-						}
-					}
-
-					// Send event
-					vec[ i ]->HandleEvent( pEvent );
-				}
+				// Send event
+				reg.listener->HandleEvent( pEvent );
 			}
 
 			return true;
@@ -490,21 +624,347 @@ namespace SGD
 				return false;
 
 			
-			// Deallocate all messages in the queue
-			while( m_qEvents.empty() == false )
+			// Deallocate all events in the queue
+			//	(the processed ones are already gone)
+			ReceivePosted();
+			for( unsigned int i = m_unNextEvent; i < m_vEvents.size(); i++ )
+				delete m_vEvents[ i ].first;
+
+			m_vEvents.clear();
+			m_unNextEvent = 0;
+			ClearPending();
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// SET COALESCING
+		bool EventManager::SetCoalescing( const EventID& eventID, bool coalesce, MergeProc pfMerge )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "EventManager::SetCoalescing - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return false;
+
+			// Sanity-check the parameter
+			SGD_ASSERT( eventID.GetIndex() != 0, "EventManager::SetCoalescing - event ID cannot be empty" );
+			if( eventID.GetIndex() == 0 )
+				return false;
+
+
+			// Store the rule (events already queued are not merged)
+			if( eventID.GetIndex() >= m_vCoalesce.size() )
 			{
-				delete m_qEvents.front().first;
-				m_qEvents.pop();
+				CoalesceRule none = { false, nullptr };
+				m_vCoalesce.resize( eventID.GetIndex() + 1, none );
 			}
 
+			m_vCoalesce[ eventID.GetIndex() ].coalesce	= coalesce;
+			m_vCoalesce[ eventID.GetIndex() ].merge		= pfMerge;
+			return true;
+		}
+		//*************************************************************//
+
 
-			// Unregistered listeners have been effectively been processed
-			m_mUnlisteners.clear();
+
+		//*************************************************************//
+		// BEGIN CAPTURE
+		bool EventManager::BeginCapture( unsigned int numStreams )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "EventManager::BeginCapture - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return false;
+
+			SGD_ASSERT( m_bCapturing == false, "EventManager::BeginCapture - already capturing" );
+			if( m_bCapturing == true )
+				return false;
+
+
+			// Allocate the streams up-front (jobs must not resize the vector)
+			m_vCaptureStreams.resize( numStreams );
+			m_bCapturing = true;
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// SET CAPTURE STREAM
+		bool EventManager::SetCaptureStream( unsigned int stream )
+		{
+			// Sanity-check the parameter
+			SGD_ASSERT( stream == NO_CAPTURE_STREAM || stream < m_vCaptureStreams.size(), "EventManager::SetCaptureStream - invalid stream" );
+			if( stream != NO_CAPTURE_STREAM && stream >= m_vCaptureStreams.size() )
+				return false;
+
+			s_unCaptureStream = stream;
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// END CAPTURE
+		bool EventManager::EndCapture( void )
+		{
+			SGD_ASSERT( m_bCapturing == true, "EventManager::EndCapture - not capturing" );
+			if( m_bCapturing == false )
+				return false;
+
+
+			// Merge the streams in order
+			for( unsigned int s = 0; s < m_vCaptureStreams.size(); s++ )
+			{
+				EventStream& stream = m_vCaptureStreams[ s ];
+				for( unsigned int i = 0; i < stream.size(); i++ )
+					Enqueue( stream[ i ] );
+
+				stream.clear();		// keep the memory for the next capture
+			}
+
+			s_unCaptureStream = NO_CAPTURE_STREAM;
+			m_bCapturing = false;
 			return true;
 		}
 		//*************************************************************//
 		
 
+
+
+		//*************************************************************//
+		// COLLECT LISTENERS
+		//	- copy the listeners of the event ID (or only the destination)
+		void EventManager::CollectListeners( unsigned int id, const void* destination, ListenerVector& vec )
+		{
+			vec.clear();
+
+			// Nobody registered for this event?
+			if( id >= m_vListeners.size() )
+				return;
+
+			// All listeners?
+			if( destination == nullptr )
+			{
+				CompactListeners( id );
+				vec.assign( m_vListeners[ id ].begin(), m_vListeners[ id ].end() );
+				return;
+			}
+
+			// One intended listener (which may not exist)
+			TargetKey key = { destination, id };
+			TargetMap::const_iterator iter = m_mTargets.find( key );
+			if( iter != m_mTargets.end() )
+			{
+				ListenerHandle handle = { iter->second, m_vRegistrations[ iter->second ].generation };
+				vec.push_back( handle );
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// RELEASE SLOT
+		//	- the new generation invalidates every copied handle
+		void EventManager::ReleaseSlot( unsigned int slot )
+		{
+			m_vRegistrations[ slot ].listener = nullptr;
+			++m_vRegistrations[ slot ].generation;
+
+			m_vFreeSlots.push_back( slot );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// COMPACT LISTENERS
+		//	- drop the stale handles of unregistered listeners
+		//	  (keeping the registration order)
+		void EventManager::CompactListeners( unsigned int id )
+		{
+			ListenerVector& listeners = m_vListeners[ id ];
+
+			unsigned int live = 0;
+			for( unsigned int i = 0; i < listeners.size(); i++ )
+			{
+				if( m_vRegistrations[ listeners[ i ].slot ].generation != listeners[ i ].generation )
+					continue;
+
+				listeners[ live++ ] = listeners[ i ];
+			}
+
+			listeners.resize( live );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// POST
+		//	- lock-free unless the ring is full
+		//	- once an event overflows, the later ones queue behind it
+		//	  (not in the ring) until it is received
+		void EventManager::Post( const EventDestinationPair& eventPair )
+		{
+			if( m_bOverflowed.load() == false && m_qPosted.Push( eventPair ) == true )
+				return;
+
+			std::lock_guard< std::mutex > lock( m_mtxOverflow );
+			m_vOverflow.push_back( eventPair );
+			m_bOverflowed.store( true );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// RECEIVE POSTED
+		//	- append the posted events to the queue
+		//	  (the ring first, then any overflow)
+		void EventManager::ReceivePosted( void )
+		{
+			EventDestinationPair eventPair;
+			while( m_qPosted.Pop( eventPair ) == true )
+				Enqueue( eventPair );
+
+			if( m_bOverflowed.load() == false )
+				return;
+
+			// Empty the ring again under the lock: a thread can fill it
+			// after the pass above, then overflow
+			std::lock_guard< std::mutex > lock( m_mtxOverflow );
+			while( m_qPosted.Pop( eventPair ) == true )
+				Enqueue( eventPair );
+
+			for( unsigned int i = 0; i < m_vOverflow.size(); i++ )
+				Enqueue( m_vOverflow[ i ] );
+			m_vOverflow.clear();
+			m_bOverflowed.store( false );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// ENQUEUE
+		//	- append the event to the queue, or merge it into the
+		//	  waiting event with the same destination & coalescing ID
+		void EventManager::Enqueue( const EventDestinationPair& eventPair )
+		{
+			unsigned int id = eventPair.first->GetEventID().GetIndex();
+
+			if( id < m_vCoalesce.size() && m_vCoalesce[ id ].coalesce == true )
+			{
+				TargetKey key = { eventPair.second, id };
+				bool inserted;
+				unsigned int& pending = FindPending( key, (unsigned int)m_vEvents.size(), inserted );
+
+				if( inserted == false )
+				{
+					// Still waiting? (not dispatched yet)
+					if( pending >= m_unNextEvent )
+					{
+						Event* pKept = const_cast< Event* >( m_vEvents[ pending ].first );
+						pKept->m_unCount += eventPair.first->m_unCount;
+
+						if( m_vCoalesce[ id ].merge != nullptr )
+							(*m_vCoalesce[ id ].merge)( pKept, eventPair.first );
+
+						delete eventPair.first;
+						return;
+					}
+
+					// Queued during its dispatch: it waits next
+					pending = (unsigned int)m_vEvents.size();
+				}
+			}
+
+			m_vEvents.push_back( eventPair );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// FIND PENDING
+		//	- the queue index waiting for the key, or a new slot holding
+		//	  'index' if there is none ('inserted' tells which)
+		unsigned int& EventManager::FindPending( const TargetKey& key, unsigned int index, bool& inserted )
+		{
+			// At most half full, so the probes stay short
+			if( ( m_unPendingCount + 1 ) * 2 > m_vPending.size() )
+				GrowPending();
+
+			size_t mask = m_vPending.size() - 1;
+			for( size_t i = TargetHash()( key ) & mask; ; i = ( i + 1 ) & mask )
+			{
+				PendingSlot& slot = m_vPending[ i ];
+
+				if( slot.epoch != m_unPendingEpoch )
+				{
+					slot.key	= key;
+					slot.index	= index;
+					slot.epoch	= m_unPendingEpoch;
+					++m_unPendingCount;
+
+					inserted = true;
+					return slot.index;
+				}
+
+				if( slot.key == key )
+				{
+					inserted = false;
+					return slot.index;
+				}
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// GROW PENDING
+		//	- double the table & re-insert the slots in use
+		//	  (the new slots are epoch 0: never in use)
+		void EventManager::GrowPending( void )
+		{
+			std::vector< PendingSlot > old( m_vPending.empty() ? 64 : m_vPending.size() * 2 );
+			old.swap( m_vPending );
+
+			m_unPendingCount = 0;
+			for( unsigned int i = 0; i < old.size(); i++ )
+			{
+				bool inserted;
+				if( old[ i ].epoch == m_unPendingEpoch )
+					FindPending( old[ i ].key, old[ i ].index, inserted );
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// CLEAR PENDING
+		//	- retire every slot by moving to the next epoch
+		void EventManager::ClearPending( void )
+		{
+			m_unPendingCount = 0;
+			if( ++m_unPendingEpoch != 0 )
+				return;
+
+			// Wrapped: no stale slot may match the new epoch
+			for( unsigned int i = 0; i < m_vPending.size(); i++ )
+				m_vPending[ i ].epoch = 0;
+			m_unPendingEpoch = 1;
+		}
+		//*************************************************************//
+
 	}	// namespace SGD_IMPLEMENTATION
 
 }	// namespace SGD
@@ -21,6 +21,7 @@ namespace SGD
 {
 	// Forward declarations
 	class Event;
+	class EventID;
 	class IListener;
 		
 
@@ -41,10 +42,38 @@ namespace SGD
 		virtual bool		RegisterForEvent	( IListener* listener, const char* eventID )				= 0;
 		virtual bool		UnregisterFromEvent	( IListener* listener, const char* eventID = nullptr )		= 0;
 
+		// Interned IDs skip the name lookup (the empty EventID unregisters from all events)
+		virtual bool		RegisterForEvent	( IListener* listener, const EventID& eventID )				= 0;
+		virtual bool		UnregisterFromEvent	( IListener* listener, const EventID& eventID )				= 0;
+
+		// QueueEvent is safe from any thread: events queued by threads other than the one
+		// that called Initialize (and not capturing) are received by the next Update
 		virtual bool		QueueEvent			( const Event* pEvent, const void* destination = nullptr )	= 0;
 		virtual bool		SendEventNow		( const Event* pEvent, const void* destination = nullptr )	= 0;
 
 		virtual bool		ClearEvents			( void )					= 0;
+
+
+		// Coalescing (for bursts of the same event):
+		//	- queued events with a coalescing ID are merged per destination until
+		//	  they are dispatched, so each listener receives the first one queued,
+		//	  with GetCount() = the number of events merged into it
+		//	- the merge function (optional) folds each later event into the kept
+		//	  one before the later one is deallocated (e.g. summing a payload)
+		typedef void (*MergeProc)( Event* pKept, const Event* pMerged );
+
+		virtual bool		SetCoalescing		( const EventID& eventID, bool coalesce, MergeProc pfMerge = nullptr )	= 0;
+
+
+		// Capture (for parallel jobs):
+		//	- between BeginCapture & EndCapture, events queued by a thread that selected
+		//	  a capture stream are stored in that stream instead of the queue
+		//	- EndCapture appends the streams to the queue in stream order (deterministic)
+		enum { NO_CAPTURE_STREAM = 0xFFFFFFFF };
+
+		virtual bool		BeginCapture		( unsigned int numStreams )	= 0;
+		virtual bool		SetCaptureStream	( unsigned int stream )		= 0;	// for the calling thread only
+		virtual bool		EndCapture			( void )					= 0;
 				
 		
 	protected:
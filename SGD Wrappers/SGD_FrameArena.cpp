@@ -0,0 +1,193 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_FrameArena.cpp 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To allocate short-lived Events & Messages from		|
+|					a pair of rewinding buffers instead of the heap		|
+|																		|
+\***********************************************************************/
+
+#include "SGD_FrameArena.h"
+
+
+// Uses ::operator new & delete for the buffers & the fallback
+#include <new>
+
+// Uses SGD_ASSERT for debug breaks
+#include "SGD_Utilities.h"
+
+
+namespace SGD
+{
+	//*****************************************************************//
+	// SINGLETON
+
+	// Instantiate static pointer to null (no instance yet)
+	/*static*/ FrameArena* FrameArena::s_pInstance = nullptr;
+
+	// Singleton accessor
+	/*static*/ FrameArena* FrameArena::GetInstance( void )
+	{
+		// Allocate singleton on first use
+		if( s_pInstance == nullptr )
+			s_pInstance = new FrameArena;
+
+		return s_pInstance;
+	}
+
+	// Singleton destructor
+	/*static*/ void FrameArena::DeleteInstance( void )
+	{
+		delete s_pInstance;
+		s_pInstance = nullptr;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// CONSTRUCTOR
+	FrameArena::FrameArena( void )
+		: m_unCurrent( 0 ), m_unMisses( 0 )
+	{
+		for( unsigned int b = 0; b < 2; b++ )
+		{
+			m_aBuffers[ b ].memory = (char*)::operator new( BUFFER_SIZE );
+			m_aBuffers[ b ].state = 0;
+		}
+	}
+
+	// DESTRUCTOR
+	FrameArena::~FrameArena( void )
+	{
+		// Blocks still alive would point into freed memory
+		SGD_ASSERT( GetLive( m_aBuffers[ 0 ].state ) == 0 && GetLive( m_aBuffers[ 1 ].state ) == 0,
+					"FrameArena::~FrameArena - blocks are still allocated" );
+
+		for( unsigned int b = 0; b < 2; b++ )
+			::operator delete( m_aBuffers[ b ].memory );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// ALLOCATE
+	//	- claim the next aligned block of the current buffer
+	//	  (advancing the offset & counting the block together)
+	void* FrameArena::Allocate( size_t size )
+	{
+		size_t rounded = ( size + ALIGNMENT - 1 ) & ~(size_t)( ALIGNMENT - 1 );
+		if( rounded == 0 )
+			rounded = ALIGNMENT;
+
+		Buffer& buffer = m_aBuffers[ m_unCurrent.load() ];
+		unsigned long long state = buffer.state.load();
+
+		for( ;; )
+		{
+			size_t offset = GetOffset( state );
+			if( offset + rounded > BUFFER_SIZE )
+			{
+				// Full
+				++m_unMisses;
+				return ::operator new( size );
+			}
+
+			// Claim it (state is reloaded on failure)
+			if( buffer.state.compare_exchange_weak( state, state + ( (unsigned long long)rounded << 32 ) + 1 ) == true )
+				return buffer.memory + offset;
+		}
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// DEALLOCATE
+	//	- arena blocks are only counted, the memory is reused
+	//	  when the buffer is rewound
+	void FrameArena::Deallocate( void* block )
+	{
+		if( block == nullptr )
+			return;
+
+		int buffer = FindBuffer( block );
+		if( buffer < 0 )
+		{
+			::operator delete( block );		// heap fallback
+			return;
+		}
+
+		SGD_ASSERT( GetLive( m_aBuffers[ buffer ].state ) != 0, "FrameArena::Deallocate - block was already deallocated" );
+		m_aBuffers[ buffer ].state.fetch_sub( 1 );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// NEXT FRAME
+	//	- switch to the other buffer when everything in it is gone
+	//	- otherwise rewind the current one (if it is empty), or keep
+	//	  filling it
+	void FrameArena::NextFrame( void )
+	{
+		unsigned int current = m_unCurrent.load();
+		unsigned int other = 1 - current;
+
+		if( TryRewind( other ) == true )
+			m_unCurrent.store( other );
+		else
+			TryRewind( current );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// GET USED
+	size_t FrameArena::GetUsed( void ) const
+	{
+		return GetOffset( m_aBuffers[ m_unCurrent.load() ].state.load() );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// FIND BUFFER
+	//	- index of the buffer containing the block, or -1 (heap)
+	int FrameArena::FindBuffer( const void* block ) const
+	{
+		const char* p = (const char*)block;
+
+		for( unsigned int b = 0; b < 2; b++ )
+			if( p >= m_aBuffers[ b ].memory && p < m_aBuffers[ b ].memory + BUFFER_SIZE )
+				return (int)b;
+
+		return -1;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// TRY REWIND
+	//	- reset the offset, only if no block is alive
+	bool FrameArena::TryRewind( unsigned int buffer )
+	{
+		unsigned long long state = m_aBuffers[ buffer ].state.load();
+
+		while( GetLive( state ) == 0 )
+		{
+			if( m_aBuffers[ buffer ].state.compare_exchange_weak( state, 0 ) == true )
+				return true;
+		}
+
+		return false;
+	}
+	//*****************************************************************//
+
+}	// namespace SGD
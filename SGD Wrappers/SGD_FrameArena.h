@@ -0,0 +1,90 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_FrameArena.h 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To allocate short-lived Events & Messages from		|
+|					a pair of rewinding buffers instead of the heap		|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_FRAMEARENA_H
+#define SGD_FRAMEARENA_H
+
+
+// Uses size_t
+#include <cstddef>
+
+// Uses std::atomic for allocating from any thread
+#include <atomic>
+
+
+namespace SGD
+{
+	//*****************************************************************//
+	// FrameArena
+	//	- SINGLETON bump allocator for objects that are deallocated
+	//	  within a frame or two (queued Events & Messages)
+	//	- double-buffered: NextFrame switches to the other buffer and
+	//	  rewinds it, so anything queued last frame survives until the
+	//	  managers dispatch it
+	//	- a buffer is only rewound once every block in it has been
+	//	  deallocated; when the buffer is full, the heap is used instead
+	//	- Allocate & Deallocate are safe from any thread (even during
+	//	  NextFrame), NextFrame must only be called from the main thread
+	class FrameArena
+	{
+	public:
+		static	FrameArena*		GetInstance		( void );
+		static	void			DeleteInstance	( void );
+
+
+		void*			Allocate		( size_t size );
+		void			Deallocate		( void* block );
+		void			NextFrame		( void );
+
+
+		// Stats:
+		size_t			GetCapacity		( void ) const	{	return BUFFER_SIZE;			}	// bytes per buffer
+		size_t			GetUsed			( void ) const;										// bytes in the current buffer
+		unsigned int	GetMisses		( void ) const	{	return m_unMisses.load();	}	// allocations that went to the heap
+
+
+	private:
+		FrameArena				( void );
+		~FrameArena				( void );
+
+		FrameArena				( const FrameArena& )	= delete;
+		FrameArena& operator=	( const FrameArena& )	= delete;
+
+		static	FrameArena*		s_pInstance;
+
+
+		// Buffer size & block alignment
+		enum { BUFFER_SIZE = 64 * 1024, ALIGNMENT = 16 };
+
+		// Buffer state:
+		//	- the next free byte & the blocks not deallocated yet share
+		//	  one word, so a buffer can only be rewound while it is empty
+		//	  (never between another thread's check & claim)
+		struct Buffer
+		{
+			char*								memory;
+			std::atomic< unsigned long long >	state;		// offset << 32 | live blocks
+		};
+
+		static size_t		GetOffset	( unsigned long long state )	{	return (size_t)( state >> 32 );				}
+		static unsigned int	GetLive		( unsigned long long state )	{	return (unsigned int)( state & 0xFFFFFFFF );	}
+
+		int				FindBuffer		( const void* block ) const;
+		bool			TryRewind		( unsigned int buffer );
+
+
+		Buffer							m_aBuffers[ 2 ];
+		std::atomic< unsigned int >		m_unCurrent;
+		std::atomic< unsigned int >		m_unMisses;
+	};
+
+}	// namespace SGD
+
+#endif	//SGD_FRAMEARENA_H
@@ -30,6 +30,28 @@
 
 // Uses _isnan
 #include <cfloat>
+#if !defined( _MSC_VER )
+	#define _isnan( x )		std::isnan( x )
+#endif
+
+// Uses SSE2 / AVX2 intrinsics (when enabled)
+//	- GCC & Clang also build the AVX2 path without -mavx2,
+//	  it runs if the CPU supports it
+#if defined( __AVX2__ )
+	#define SGD_GEOMETRY_AVX2
+	#define SGD_GEOMETRY_AVX2_TARGET
+	#define SGD_GEOMETRY_SSE2
+	#include <immintrin.h>
+#elif defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined( __SSE2__ )
+	#define SGD_GEOMETRY_SSE2
+	#include <emmintrin.h>
+	#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+		#define SGD_GEOMETRY_AVX2
+		#define SGD_GEOMETRY_AVX2_TARGET	__attribute__(( target( "avx2" ) ))
+		#define SGD_GEOMETRY_AVX2_RUNTIME
+		#include <immintrin.h>
+	#endif
+#endif
 
 
 namespace SGD
@@ -624,4 +646,295 @@ namespace SGD
 
 #pragma endregion
 
+
+#pragma region RECTANGLE_BATCH
+
+	// The batch tests read rectangles as 4 packed floats
+	static_assert( sizeof( Rectangle ) == 4 * sizeof( float ), "Rectangle must be 4 packed floats" );
+
+
+	//*****************************************************************//
+	// Append the set bits of the mask as indices (ascending)
+	//	- branch-free: always write, only advance on a hit
+	static inline unsigned int CompactHits( unsigned int mask, unsigned int first, unsigned int lanes, unsigned int* hits )
+	{
+		unsigned int numHits = 0;
+		for( unsigned int lane = 0; lane < lanes; lane++ )
+		{
+			hits[ numHits ] = first + lane;
+			numHits += ( mask >> lane ) & 1;
+		}
+		return numHits;
+	}
+
+
+	//*****************************************************************//
+	// Block kernels
+	//	- test whole blocks of 8 (AVX2) or 4 (SSE2) others from 'i'
+	//	- return the index of the first one left untested
+#if defined( SGD_GEOMETRY_AVX2 )
+	SGD_GEOMETRY_AVX2_TARGET
+	static unsigned int IntersectBlocksAVX2( const Rectangle& rect, const Rectangle* others, unsigned int count, unsigned int i, unsigned int* hits, unsigned int& numHits )
+	{
+		const __m256 L = _mm256_set1_ps( rect.left );
+		const __m256 T = _mm256_set1_ps( rect.top );
+		const __m256 R = _mm256_set1_ps( rect.right );
+		const __m256 B = _mm256_set1_ps( rect.bottom );
+
+		for( ; i + 8 <= count; i += 8 )
+		{
+			// Transpose 8 rects (lanes hold rects 0-3 & 4-7)
+			const float* p = &others[ i ].left;
+			__m256 r0 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( p +  0 ) ), _mm_loadu_ps( p + 16 ), 1 );
+			__m256 r1 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( p +  4 ) ), _mm_loadu_ps( p + 20 ), 1 );
+			__m256 r2 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( p +  8 ) ), _mm_loadu_ps( p + 24 ), 1 );
+			__m256 r3 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( p + 12 ) ), _mm_loadu_ps( p + 28 ), 1 );
+
+			__m256 t0 = _mm256_unpacklo_ps( r0, r1 );		// l0 l1 t0 t1
+			__m256 t1 = _mm256_unpacklo_ps( r2, r3 );		// l2 l3 t2 t3
+			__m256 t2 = _mm256_unpackhi_ps( r0, r1 );		// r0 r1 b0 b1
+			__m256 t3 = _mm256_unpackhi_ps( r2, r3 );		// r2 r3 b2 b3
+
+			__m256 oL = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			__m256 oT = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+			__m256 oR = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			__m256 oB = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+
+			// Same comparisons as IsIntersecting (ordered: NaN never hits)
+			__m256 hit = _mm256_and_ps( _mm256_cmp_ps( L, oR, _CMP_LT_OQ ), _mm256_cmp_ps( R, oL, _CMP_GT_OQ ) );
+			hit = _mm256_and_ps( hit, _mm256_and_ps( _mm256_cmp_ps( T, oB, _CMP_LT_OQ ), _mm256_cmp_ps( B, oT, _CMP_GT_OQ ) ) );
+			hit = _mm256_and_ps( hit, _mm256_and_ps( _mm256_cmp_ps( oL, oR, _CMP_LT_OQ ), _mm256_cmp_ps( oT, oB, _CMP_LT_OQ ) ) );
+
+			unsigned int mask = (unsigned int)_mm256_movemask_ps( hit );
+			if( mask != 0 )
+				numHits += CompactHits( mask, i, 8, hits + numHits );
+		}
+
+		return i;
+	}
+#endif
+
+#if defined( SGD_GEOMETRY_SSE2 )
+	static unsigned int IntersectBlocksSSE2( const Rectangle& rect, const Rectangle* others, unsigned int count, unsigned int i, unsigned int* hits, unsigned int& numHits )
+	{
+		const __m128 L = _mm_set1_ps( rect.left );
+		const __m128 T = _mm_set1_ps( rect.top );
+		const __m128 R = _mm_set1_ps( rect.right );
+		const __m128 B = _mm_set1_ps( rect.bottom );
+
+		for( ; i + 4 <= count; i += 4 )
+		{
+			// Transpose 4 rects into left, top, right, bottom vectors
+			const float* p = &others[ i ].left;
+			__m128 oL = _mm_loadu_ps( p +  0 );
+			__m128 oT = _mm_loadu_ps( p +  4 );
+			__m128 oR = _mm_loadu_ps( p +  8 );
+			__m128 oB = _mm_loadu_ps( p + 12 );
+			_MM_TRANSPOSE4_PS( oL, oT, oR, oB );
+
+			// Same comparisons as IsIntersecting (ordered: NaN never hits)
+			__m128 hit = _mm_and_ps( _mm_cmplt_ps( L, oR ), _mm_cmpgt_ps( R, oL ) );
+			hit = _mm_and_ps( hit, _mm_and_ps( _mm_cmplt_ps( T, oB ), _mm_cmpgt_ps( B, oT ) ) );
+			hit = _mm_and_ps( hit, _mm_and_ps( _mm_cmplt_ps( oL, oR ), _mm_cmplt_ps( oT, oB ) ) );
+
+			unsigned int mask = (unsigned int)_mm_movemask_ps( hit );
+			if( mask != 0 )
+				numHits += CompactHits( mask, i, 4, hits + numHits );
+		}
+
+		return i;
+	}
+#endif
+
+
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// IS RECTANGLE BATCH SUPPORTED
+		bool IsRectangleBatchSupported( RectangleBatchPath path )
+		{
+			switch( path )
+			{
+			case RECT_BATCH_SCALAR:
+				return true;
+
+#if defined( SGD_GEOMETRY_SSE2 )
+			case RECT_BATCH_SSE2:
+				return true;
+#endif
+
+#if defined( SGD_GEOMETRY_AVX2_RUNTIME )
+			case RECT_BATCH_AVX2:
+				__builtin_cpu_init();		// may run before the static constructors
+				return __builtin_cpu_supports( "avx2" ) != 0;
+#elif defined( SGD_GEOMETRY_AVX2 )
+			case RECT_BATCH_AVX2:
+				return true;
+#endif
+
+			default:
+				return false;
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// GET RECTANGLE BATCH PATH
+		//	- the widest supported path, chosen once before main
+		//	  (scalar until then)
+		static const RectangleBatchPath s_BatchPath =
+			IsRectangleBatchSupported( RECT_BATCH_AVX2 ) ? RECT_BATCH_AVX2
+			: IsRectangleBatchSupported( RECT_BATCH_SSE2 ) ? RECT_BATCH_SSE2
+			: RECT_BATCH_SCALAR;
+
+		RectangleBatchPath GetRectangleBatchPath( void )
+		{
+			return s_BatchPath;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// INTERSECT RECTANGLES
+		//	- the widest block kernel the path allows, then narrower ones,
+		//	  the odd ones out are tested one at a time
+		unsigned int IntersectRectangles( RectangleBatchPath path, const Rectangle& rect, const Rectangle* others, unsigned int count, unsigned int* hits )
+		{
+			unsigned int numHits	= 0;
+			unsigned int i			= 0;
+
+			// An empty rectangle never intersects
+			if( rect.left >= rect.right || rect.top >= rect.bottom || count == 0 )
+				return 0;
+
+#if defined( SGD_GEOMETRY_AVX2 )
+			if( path == RECT_BATCH_AVX2 )
+				i = IntersectBlocksAVX2( rect, others, count, i, hits, numHits );
+#endif
+
+#if defined( SGD_GEOMETRY_SSE2 )
+			if( path != RECT_BATCH_SCALAR )
+				i = IntersectBlocksSSE2( rect, others, count, i, hits, numHits );
+#endif
+
+			// Scalar remainder (or everything, without SIMD)
+			for( ; i < count; i++ )
+			{
+				hits[ numHits ] = i;
+				numHits += rect.IsIntersecting( others[ i ] ) ? 1 : 0;
+			}
+
+			return numHits;
+		}
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+
+	//*****************************************************************//
+	// One-vs-many
+	unsigned int IntersectRectangles( const Rectangle& rect, const Rectangle* others, unsigned int count, unsigned int* hits )
+	{
+		return SGD_IMPLEMENTATION::IntersectRectangles( SGD_IMPLEMENTATION::GetRectangleBatchPath(), rect, others, count, hits );
+	}
+
+
+	//*****************************************************************//
+	// Many-vs-many
+	unsigned int IntersectRectangles( const Rectangle* rects, unsigned int count, 
+									  const Rectangle* others, unsigned int otherCount,
+									  unsigned int* pairs, unsigned int maxPairs )
+	{
+		unsigned int numPairs = 0;
+
+		// Test each rect against every other in chunks
+		const unsigned int CHUNK = 64;
+		unsigned int hits[ CHUNK ];
+
+		for( unsigned int i = 0; i < count; i++ )
+		{
+			for( unsigned int first = 0; first < otherCount; first += CHUNK )
+			{
+				unsigned int num = otherCount - first;
+				if( num > CHUNK )
+					num = CHUNK;
+
+				unsigned int numHits = IntersectRectangles( rects[ i ], others + first, num, hits );
+				for( unsigned int h = 0; h < numHits; h++, numPairs++ )
+				{
+					if( numPairs < maxPairs )
+					{
+						pairs[ numPairs * 2 + 0 ] = i;
+						pairs[ numPairs * 2 + 1 ] = first + hits[ h ];
+					}
+				}
+			}
+		}
+
+		return numPairs;
+	}
+	//*****************************************************************//
+
+#pragma endregion
+
+
+#pragma region RECTANGLE_SWEEP
+
+	//*****************************************************************//
+	// Clip the [enter, exit) window to the times the moving span
+	// overlaps the other span along one axis
+	static inline bool SweepAxis( float minA, float maxA, float delta, float minB, float maxB, float& enter, float& exit )
+	{
+		// Not moving: must overlap the whole time
+		if( delta == 0.0f )
+			return ( minA < maxB ) && ( maxA > minB );
+
+		float t0 = ( minB - maxA ) / delta;		// edges meet
+		float t1 = ( maxB - minA ) / delta;		// edges part
+		if( t0 > t1 )
+		{
+			float temp = t0;
+			t0 = t1;
+			t1 = temp;
+		}
+
+		if( t0 > enter )
+			enter = t0;
+		if( t1 < exit )
+			exit = t1;
+
+		return enter < exit;
+	}
+
+
+	//*****************************************************************//
+	// Swept rectangle test
+	bool SweepRectangles( const Rectangle& rect, const Vector& delta, const Rectangle& other, float& time )
+	{
+		// Empty rectangles never intersect
+		if( (rect.left < rect.right) == false || (rect.top < rect.bottom) == false
+			|| (other.left < other.right) == false || (other.top < other.bottom) == false )
+			return false;
+
+		if( _isnan( delta.x ) != 0 || _isnan( delta.y ) != 0 )
+			return false;
+
+
+		// Overlapping on both axes at once, within the movement
+		float enter = 0.0f;
+		float exit	= 1.0f;
+		if( SweepAxis( rect.left, rect.right, delta.x, other.left, other.right, enter, exit ) == false
+			|| SweepAxis( rect.top, rect.bottom, delta.y, other.top, other.bottom, enter, exit ) == false )
+			return false;
+
+		time = enter;
+		return true;
+	}
+	//*****************************************************************//
+
+#pragma endregion
+
 }	// namespace SGD
@@ -243,6 +243,60 @@ namespace SGD
 
 	};	// class Vector
 
+
+	//*****************************************************************//
+	// Rectangle batch tests
+	//	- identical results to Rectangle::IsIntersecting (edges touching do NOT intersect)
+	//	- tests 4 rectangles per instruction with SSE2 (8 with AVX2),
+	//	  scalar fallback otherwise (the widest the CPU supports)
+	//	- 'others' is a packed array of rectangles
+	
+	// One-vs-many: stores the indices of the intersecting others (ascending)
+	//	- hits must hold 'count' indices
+	//	- returns the number of hits
+	unsigned int	IntersectRectangles	( const Rectangle& rect, const Rectangle* others, unsigned int count, unsigned int* hits );
+
+	// Many-vs-many: stores the intersecting (rect index, other index) pairs
+	//	- pairs are interleaved, ordered by rect index then other index
+	//	- at most 'maxPairs' pairs are stored (2 indices each)
+	//	- returns the total number of intersecting pairs (may exceed maxPairs)
+	unsigned int	IntersectRectangles	( const Rectangle* rects, unsigned int count, 
+										  const Rectangle* others, unsigned int otherCount,
+										  unsigned int* pairs, unsigned int maxPairs );
+
+
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// Rectangle batch paths
+		//	- the one-vs-many test on a given instruction set,
+		//	  for checking the paths against each other & timing them
+		//	- a path must be supported by the build & the CPU
+		enum RectangleBatchPath
+		{
+			RECT_BATCH_SCALAR,
+			RECT_BATCH_SSE2,		// 4 at a time
+			RECT_BATCH_AVX2,		// 8 at a time (then 4)
+		};
+
+		bool				IsRectangleBatchSupported	( RectangleBatchPath path );
+		RectangleBatchPath	GetRectangleBatchPath		( void );		// the one IntersectRectangles uses
+
+		unsigned int		IntersectRectangles			( RectangleBatchPath path, const Rectangle& rect, const Rectangle* others, unsigned int count, unsigned int* hits );
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+
+	//*****************************************************************//
+	// Swept rectangle test
+	//	- 'rect' moves by 'delta' while 'other' stays still
+	//	  (pass the relative movement when both move)
+	//	- same rules as Rectangle::IsIntersecting at every instant
+	//	- returns true if they intersect at any time within [0, 1];
+	//	  'time' receives the first time of contact (0 if already intersecting)
+	bool			SweepRectangles		( const Rectangle& rect, const Vector& delta, const Rectangle& other, float& time );
+
 }	// namespace SGD
 
 #endif	//SGD_GEOMETRY_H
@@ -37,6 +37,21 @@
 // Uses HandleManager for storing data
 #include "SGD_HandleManager.h"
 
+// Uses AssetIndex for finding textures by name
+#include "SGD_AssetIndex.h"
+
+// Uses SpriteBatch for sorting & transforming batched sprites
+#include "SGD_SpriteBatch.h"
+
+// Uses TextureAtlas for packing textures into pages
+#include "SGD_TextureAtlas.h"
+
+// Uses TextureLoader for decoding textures in the background
+#include "SGD_TextureLoader.h"
+
+// Uses ArchivedFile for reading images from the mounted archive
+#include "SGD_AssetArchive.h"
+
 // Uses SGD_ASSERT for debug breaks
 #include "SGD_Utilities.h"
 
@@ -58,6 +73,9 @@ namespace SGD
 			IDirect3DTexture9*		texture;			// texture
 			float					fWidth;				// width
 			float					fHeight;			// height
+			HTexture				hPage;				// atlas page (invalid when loaded on its own)
+			TextureAtlas::Region	region;				// area in the atlas page
+			bool					bLoading;			// queued on the loader thread (texture is the placeholder)
 		};
 		//*************************************************************//
 
@@ -103,6 +121,20 @@ namespace SGD
 			virtual	bool		DrawTextureSection		( HTexture handle, Point position, Rectangle section, float rotation, Vector rotationOffset, Color color, Size scale )	override;
 			virtual	bool		UnloadTexture			( HTexture& handle )							override;
 
+
+			virtual	bool		BeginBatch				( void )										override;
+			virtual	bool		EndBatch				( void )										override;
+			virtual	bool		DrawSprites				( const Sprite* sprites, unsigned int count )	override;
+
+			virtual	RenderStats	GetRenderStats			( void ) const									override	{	return m_Batch.GetStats();	}
+
+			virtual	bool		SetAtlasMode			( bool atlas, unsigned int pageSize )			override;
+
+			virtual	HTexture	LoadTextureAsync		( const wchar_t* filename, Color colorKey )		override;
+			virtual	HTexture	LoadTextureAsync		( const char* filename, Color colorKey )		override;
+			virtual	bool		IsTextureLoaded			( HTexture handle )								override;
+			virtual	unsigned int	WaitForTextures		( const HTexture* handles, unsigned int count, unsigned int milliseconds )	override;
+
 		private:
 			// SINGLETON
 			static	GraphicsManager*		s_Instance;		// the ONE instance
@@ -125,6 +157,7 @@ namespace SGD
 			EGraphicsManagerStatus		m_eStatus			= E_UNINITIALIZED;			// wrapper initialization status
 
 			HandleManager< TextureInfo > m_HandleManager;								// data storage
+			AssetIndex< HTexture >		m_Index;										// texture handles by file name
 
 			IDirect3D9*					m_pDirect3D			= nullptr;					// Direct3D api
 			IDirect3DDevice9*			m_pDevice			= nullptr;					// device
@@ -145,19 +178,38 @@ namespace SGD
 			wchar_t*					m_pwszBuffer		= nullptr;					// output buffer storage (preallocated to hasten ASCII -> UTF16 conversion)
 			int							m_nBufferSize		= 0;						// size (in wchar_t) of output buffer
 
+			SpriteBatch					m_Batch;										// queued sprites & frame stats
+			bool						m_bBatching			= false;					// between BeginBatch & EndBatch
+
+			TextureAtlas				m_Atlas;										// areas of the atlas pages
+			std::vector< HTexture >		m_vPages;										// atlas page textures (invalid when empty)
+			bool						m_bAtlas			= false;					// pack loaded textures into pages
+
+			TextureLoader< IDirect3DSurface9* >	m_Loader;								// decodes LoadTextureAsync files
+			IDirect3DTexture9*			m_pPlaceholder		= nullptr;					// drawn until a texture is loaded
+
 
 			// CLEAR SCREEN HELPER METHOD
 			bool			ClearScreen( void );
 
 
-			// TEXTURE REFERENCE HELPER METHOD
-			struct SearchInfo
-			{
-				const wchar_t*	filename;	// input
-				TextureInfo*	texture;	// output
-				HTexture		handle;		// output
-			};
-			static	bool	FindTextureByName( Handle handle, TextureInfo& data, SearchInfo* extra );
+			// SPRITE BATCH HELPER METHOD
+			bool			SubmitBatch( void );
+
+
+			// TEXTURE ATLAS HELPER METHODS
+			HTexture		LoadAtlasTexture( const wchar_t* filename, Color colorKey );
+			HTexture		OpenAtlasPage( const TextureAtlas::Region& region );
+			void			MapToAtlas( Sprite* sprites, unsigned int count );
+			void			RemoveFromAtlas( HTexture page, const TextureAtlas::Region& region );
+			static	void	ClearAtlasArea( IDirect3DTexture9* texture, const RECT& area );
+
+
+			// ASYNCHRONOUS LOADING HELPER METHODS
+			static	bool	DecodeImage( void* device, const wchar_t* filename, Color colorKey, IDirect3DSurface9*& image );
+			void			FinishLoads( void );
+			bool			UploadImage( IDirect3DSurface9* image, TextureInfo& data );
+			static	HRESULT	CopyImage( IDirect3DTexture9* texture, const RECT& area, IDirect3DSurface9* image );
 
 
 			// WINDOW INITIALIZATION HELPER METHODS
@@ -299,7 +351,8 @@ namespace SGD
 
 
 			// Attempt to create the device
-			hResult = m_pDirect3D->CreateDevice( D3DADAPTER_DEFAULT, D3DDEVTYPE_HAL, hWnd, D3DCREATE_HARDWARE_VERTEXPROCESSING, &m_PresentParams, &m_pDevice );
+			//	(multithreaded: the texture loader thread creates its image surfaces)
+			hResult = m_pDirect3D->CreateDevice( D3DADAPTER_DEFAULT, D3DDEVTYPE_HAL, hWnd, D3DCREATE_HARDWARE_VERTEXPROCESSING | D3DCREATE_MULTITHREADED, &m_PresentParams, &m_pDevice );
 			if( FAILED( hResult ) )
 			{
 				m_pDirect3D->Release();
@@ -430,6 +483,10 @@ namespace SGD
 			m_pwszBuffer		= new wchar_t[ m_nBufferSize ];
 
 
+			// Decode LoadTextureAsync files on the loader thread
+			m_Loader.Initialize( &GraphicsManager::DecodeImage, m_pDevice );
+
+
 			// Success!
 			m_eStatus = E_INITIALIZED;
 			return true;
@@ -478,6 +535,16 @@ namespace SGD
 			if( m_eStatus != E_INITIALIZED )
 				return false;
 
+
+			// Submit a batch that was never ended
+			SGD_ASSERT( m_bBatching == false, "GraphicsManager::Update - EndBatch was not called" );
+			if( m_bBatching == true )
+				EndBatch();
+
+
+			// Upload the textures the loader thread has decoded
+			FinishLoads();
+
 			
 			// Centered output onto fullscreen display?
 			float offsetX = (m_WindowSize.width - m_DesiredSize.width) / 2;
@@ -542,6 +609,10 @@ namespace SGD
 			}
 
 
+			// Publish the frame's stats
+			m_Batch.EndFrame();
+
+
 			// End sprite rendering
 			HRESULT hResult = m_pSprite->End();
 			if( FAILED( hResult ) )
@@ -679,20 +750,43 @@ namespace SGD
 			}
 
 
+			// Stop the loader thread & release the images it decoded
+			m_Loader.Stop();
+
+			TextureLoader< IDirect3DSurface9* >::Job job;
+			while( m_Loader.PopFinished( job ) == true )
+				if( job.image != nullptr )
+					job.image->Release();
+
+
 			// Deallocate output buffer
 			delete[] m_pwszBuffer;
 			m_pwszBuffer = nullptr;
 			m_nBufferSize = 0;
 
 
-			// Clear handles
+			// Clear handles & queued sprites
 			m_HandleManager.Clear();
+			m_Index.Clear();
+
+			m_Batch.Clear();
+			m_bBatching = false;
+
+			m_Atlas.Clear();
+			m_vPages.clear();
+			m_bAtlas = false;
 
 
 			// Release resources
 			m_pTexture->Release();
 			m_pTexture = nullptr;
 
+			if( m_pPlaceholder != nullptr )
+			{
+				m_pPlaceholder->Release();
+				m_pPlaceholder = nullptr;
+			}
+
 			m_pFont->Release();
 			m_pFont = nullptr;
 
@@ -1049,6 +1143,13 @@ namespace SGD
 				return false;
 
 
+			// Keep the order with the queued sprites
+			if( m_bBatching == true )
+				SubmitBatch();
+
+			m_Batch.CountDraw( HTexture(), 0 );
+
+
 			RECT region = { (LONG)position.x, (LONG)position.y };
 			
 			int result = m_pFont->DrawTextW( m_pSprite, text, -1, &region, DT_NOCLIP, (D3DCOLOR)color );
@@ -1134,6 +1235,13 @@ namespace SGD
 			if( dX == 0 && dY == 0 || lineWidth <= 0 )
 				return false;
 
+
+			// Keep the order with the queued sprites
+			if( m_bBatching == true )
+				SubmitBatch();
+
+			m_Batch.CountDraw( HTexture(), 0 );
+
 			
 			// Store original transform
 			D3DXMATRIX original, world;
@@ -1271,6 +1379,13 @@ namespace SGD
 				return false;
 
 
+			// Keep the order with the queued sprites
+			if( m_bBatching == true )
+				SubmitBatch();
+
+			m_Batch.CountDraw( HTexture(), 0 );
+
+
 			HRESULT result = 0;
 			
 			// Store original transform
@@ -1430,15 +1545,31 @@ namespace SGD
 				return SGD::INVALID_HANDLE;
 
 
-			// Attempt to find the texture in the Handle Manager
-			SearchInfo search = { filename, nullptr, SGD::INVALID_HANDLE };
-			m_HandleManager.ForEach( &GraphicsManager::FindTextureByName, &search );
+			// Attempt to find the texture in the index
+			HTexture handle = m_Index.Find( filename );
 
 			// If it was found, increase the reference & return the existing handle
-			if( search.texture != NULL )
+			// (once it has finished loading)
+			if( handle != SGD::INVALID_HANDLE )
+			{
+				m_HandleManager.GetData( handle )->unRefCount++;
+
+				if( m_HandleManager.GetData( handle )->bLoading == true )
+					WaitForTextures( &handle, 1, 0xFFFFFFFF );
+
+				return handle;
+			}
+
+
+			// Pack it into an atlas page?
+			if( m_bAtlas == true )
 			{
-				search.texture->unRefCount++;
-				return search.handle;
+				handle = LoadAtlasTexture( filename, colorKey );
+				if( handle != SGD::INVALID_HANDLE )
+				{
+					m_Index.Insert( filename, handle );
+					return handle;
+				}
 			}
 
 
@@ -1448,8 +1579,17 @@ namespace SGD
 			D3DSURFACE_DESC surface = { };
 
 
-			// Attempt to load from file
-			HRESULT hResult = D3DXCreateTextureFromFileExW( m_pDevice, filename, 0, 0, D3DX_DEFAULT, 0, D3DFMT_UNKNOWN, D3DPOOL_MANAGED, D3DX_DEFAULT, D3DX_DEFAULT, (D3DCOLOR)colorKey, &info, nullptr, &data.texture );
+			// Attempt to load from the mounted archive (in place), or from file
+			const unsigned char*			bytes	= nullptr;
+			size_t							size	= 0;
+			std::vector< unsigned char >	buffer;
+			ArchivedFile					archive;
+
+			HRESULT hResult;
+			if( archive.Read( filename, bytes, size, buffer ) == true )
+				hResult = D3DXCreateTextureFromFileInMemoryEx( m_pDevice, bytes, (UINT)size, 0, 0, D3DX_DEFAULT, 0, D3DFMT_UNKNOWN, D3DPOOL_MANAGED, D3DX_DEFAULT, D3DX_DEFAULT, (D3DCOLOR)colorKey, &info, nullptr, &data.texture );
+			else
+				hResult = D3DXCreateTextureFromFileExW( m_pDevice, filename, 0, 0, D3DX_DEFAULT, 0, D3DFMT_UNKNOWN, D3DPOOL_MANAGED, D3DX_DEFAULT, D3DX_DEFAULT, (D3DCOLOR)colorKey, &info, nullptr, &data.texture );
 			if( FAILED( hResult ) )
 			{
 				// MESSAGE
@@ -1487,8 +1627,10 @@ namespace SGD
 			data.fHeight = (float)surface.Height;
 
 
-			// Store texture into the Handle Manager
-			return m_HandleManager.StoreData( data );
+			// Store texture into the Handle Manager & index its name
+			handle = m_HandleManager.StoreData( data );
+			m_Index.Insert( filename, handle );
+			return handle;
 		}
 		//*************************************************************//
 
@@ -1552,6 +1694,28 @@ namespace SGD
 			if( data == nullptr )
 				return false;
 
+			// Still a placeholder? (the size is not known yet)
+			if( data->texture == m_pPlaceholder )
+				return true;
+
+
+			// Queue it?
+			if( m_bBatching == true )
+			{
+				Sprite sprite;
+				sprite.handle			= handle;
+				sprite.position			= position;
+				sprite.rotation			= rotation;
+				sprite.rotationOffset	= rotationOffset;
+				sprite.color			= color;
+				sprite.scale			= scale;
+
+				MapToAtlas( m_Batch.Add( &sprite, 1 ), 1 );
+				return true;
+			}
+
+			m_Batch.CountDraw( ( data->hPage != SGD::INVALID_HANDLE ) ? data->hPage : handle, 1 );
+
 			
 			// Store original transform
 			D3DXMATRIX original, world;
@@ -1587,8 +1751,16 @@ namespace SGD
 			m_pSprite->SetTransform( &world );
 
 
-			// Draw the texture
-			HRESULT result = m_pSprite->Draw( data->texture, nullptr, nullptr, nullptr, (D3DCOLOR)color );
+			// Draw the texture (or its area of the atlas page)
+			HRESULT result;
+			if( data->hPage == SGD::INVALID_HANDLE )
+				result = m_pSprite->Draw( data->texture, nullptr, nullptr, nullptr, (D3DCOLOR)color );
+			else
+			{
+				Rectangle section = TextureAtlas::MapSection( data->region, Rectangle{} );
+				RECT source = { (LONG)section.left, (LONG)section.top, (LONG)section.right, (LONG)section.bottom };
+				result = m_pSprite->Draw( data->texture, &source, nullptr, nullptr, (D3DCOLOR)color );
+			}
 
 
 			// Restore the transform
@@ -1638,6 +1810,25 @@ namespace SGD
 			if( section.IsEmpty() == true )
 				return false;
 
+
+			// Queue it?
+			if( m_bBatching == true )
+			{
+				Sprite sprite;
+				sprite.handle			= handle;
+				sprite.position			= position;
+				sprite.section			= section;
+				sprite.rotation			= rotation;
+				sprite.rotationOffset	= rotationOffset;
+				sprite.color			= color;
+				sprite.scale			= scale;
+
+				MapToAtlas( m_Batch.Add( &sprite, 1 ), 1 );
+				return true;
+			}
+
+			m_Batch.CountDraw( ( data->hPage != SGD::INVALID_HANDLE ) ? data->hPage : handle, 1 );
+
 		
 			// Store original transform
 			D3DXMATRIX original, world;
@@ -1673,7 +1864,10 @@ namespace SGD
 			m_pSprite->SetTransform( &world );
 
 
-			// Draw the texture
+			// Draw the texture (offset into the atlas page)
+			if( data->hPage != SGD::INVALID_HANDLE )
+				section = TextureAtlas::MapSection( data->region, section );
+
 			RECT source = { (LONG)section.left, (LONG)section.top, (LONG)section.right, (LONG)section.bottom };
 			HRESULT result = m_pSprite->Draw( data->texture, &source, nullptr, nullptr, (D3DCOLOR)color );
 
@@ -1699,6 +1893,777 @@ namespace SGD
 
 
 
+		//*************************************************************//
+		// BEGIN BATCH
+		bool GraphicsManager::BeginBatch( void )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "GraphicsManager::BeginBatch - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return false;
+
+			SGD_ASSERT( m_bBatching == false, "GraphicsManager::BeginBatch - already batching" );
+			if( m_bBatching == true )
+				return false;
+
+
+			m_bBatching = true;
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// END BATCH
+		bool GraphicsManager::EndBatch( void )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "GraphicsManager::EndBatch - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return false;
+
+			SGD_ASSERT( m_bBatching == true, "GraphicsManager::EndBatch - not batching" );
+			if( m_bBatching == false )
+				return false;
+
+
+			m_bBatching = false;
+			return SubmitBatch();
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// DRAW SPRITES
+		bool GraphicsManager::DrawSprites( const Sprite* sprites, unsigned int count )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "GraphicsManager::DrawSprites - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return false;
+
+			SGD_ASSERT( sprites != nullptr || count == 0, "GraphicsManager::DrawSprites - sprites cannot be null" );
+			if( sprites == nullptr )
+				return false;
+
+
+			MapToAtlas( m_Batch.Add( sprites, count ), count );
+
+			// Submit now?
+			if( m_bBatching == false )
+				return SubmitBatch();
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// SUBMIT BATCH
+		//	- draw the queued sprites one run (texture & blend mode) at a time,
+		//	  so the sprite object merges each run into one draw call
+		bool GraphicsManager::SubmitBatch( void )
+		{
+			if( m_Batch.IsEmpty() == true )
+				return true;
+
+
+			// Transform relative to the current (fullscreen) transform
+			D3DXMATRIX original;
+			m_pSprite->GetTransform( &original );
+
+			SpriteBatch::Transform base = { original._11, original._12, original._21, original._22, original._41, original._42 };
+			m_Batch.Prepare( base );
+
+
+			bool		success	= true;
+			BlendMode	blend	= BlendMode::Alpha;
+
+			for( unsigned int r = 0; r < m_Batch.GetNumRuns(); r++ )
+			{
+				const SpriteBatch::Run& run = m_Batch.GetRun( r );
+				const Sprite& first = m_Batch.GetSprite( run.first );
+
+				// Get the texture info once per run
+				TextureInfo* data = m_HandleManager.GetData( first.handle );
+				SGD_ASSERT( data != nullptr, "GraphicsManager::DrawSprites - handle has expired" );
+				if( data == nullptr )
+				{
+					success = false;
+					continue;
+				}
+
+				// Change the blend state (flushing the previous runs)
+				if( first.blend != blend )
+				{
+					m_pSprite->Flush();
+					m_pDevice->SetRenderState( D3DRS_DESTBLEND, ( first.blend == BlendMode::Additive ) ? D3DBLEND_ONE : D3DBLEND_INVSRCALPHA );
+					blend = first.blend;
+				}
+
+				for( unsigned int i = run.first; i < run.first + run.count; i++ )
+				{
+					const Sprite& sprite = m_Batch.GetSprite( i );
+					const SpriteBatch::Transform& t = m_Batch.GetTransform( i );
+
+					// Whole placeholders are skipped (the size is not known yet)
+					if( sprite.section.IsEmpty() == true && data->texture == m_pPlaceholder )
+						continue;
+
+					D3DXMATRIX world(	t.m11,	t.m12,	0.0f,	0.0f,
+										t.m21,	t.m22,	0.0f,	0.0f,
+										0.0f,	0.0f,	1.0f,	0.0f,
+										t.dx,	t.dy,	0.0f,	1.0f	);
+					m_pSprite->SetTransform( &world );
+
+					HRESULT result;
+					if( sprite.section.IsEmpty() == true )
+						result = m_pSprite->Draw( data->texture, nullptr, nullptr, nullptr, (D3DCOLOR)sprite.color );
+					else
+					{
+						RECT source = { (LONG)sprite.section.left, (LONG)sprite.section.top, (LONG)sprite.section.right, (LONG)sprite.section.bottom };
+						result = m_pSprite->Draw( data->texture, &source, nullptr, nullptr, (D3DCOLOR)sprite.color );
+					}
+
+					if( FAILED( result ) )
+						success = false;
+				}
+
+				m_Batch.CountDraw( first.handle, run.count );
+			}
+
+
+			// Restore the blend state & transform
+			if( blend != BlendMode::Alpha )
+			{
+				m_pSprite->Flush();
+				m_pDevice->SetRenderState( D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA );
+			}
+
+			m_pSprite->SetTransform( &original );
+			m_Batch.Clear();
+
+
+			if( success == false )
+			{
+				// MESSAGE
+				Alert( "!!! GraphicsManager::DrawSprites - failed to draw sprites !!!\n" );
+				return false;
+			}
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// SET ATLAS MODE
+		bool GraphicsManager::SetAtlasMode( bool atlas, unsigned int pageSize )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "GraphicsManager::SetAtlasMode - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return false;
+
+			// Textures loaded from now on are not packed
+			if( atlas == false )
+			{
+				m_bAtlas = false;
+				return true;
+			}
+
+			SGD_ASSERT( pageSize > 0 && ( pageSize & ( pageSize - 1 ) ) == 0, "GraphicsManager::SetAtlasMode - page size must be a power of 2" );
+			if( pageSize == 0 || ( pageSize & ( pageSize - 1 ) ) != 0 )
+				return false;
+
+
+			// Limit the pages to the largest texture the device supports
+			D3DCAPS9 caps = { };
+			m_pDevice->GetDeviceCaps( &caps );
+
+			while( pageSize > 1 && ( pageSize > caps.MaxTextureWidth || pageSize > caps.MaxTextureHeight ) )
+				pageSize >>= 1;
+
+
+			// Change the page size?
+			if( pageSize != m_Atlas.GetPageSize() )
+			{
+				SGD_ASSERT( m_Atlas.IsEmpty() == true, "GraphicsManager::SetAtlasMode - cannot change the page size while pages are in use" );
+				if( m_Atlas.IsEmpty() == false )
+					return false;
+
+				m_Atlas.Initialize( pageSize );
+				m_vPages.clear();
+			}
+
+			m_bAtlas = true;
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// LOAD ATLAS TEXTURE
+		//	- loads the image straight into a free area of an atlas page
+		//	  (colour-keyed, but not stretched to a power of 2)
+		//	- returns INVALID_HANDLE when it does not fit or cannot be read,
+		//	  so LoadTexture loads it on its own
+		HTexture GraphicsManager::LoadAtlasTexture( const wchar_t* filename, Color colorKey )
+		{
+			// Read it from the mounted archive (in place)?
+			const unsigned char*			bytes	= nullptr;
+			size_t							size	= 0;
+			std::vector< unsigned char >	buffer;
+			ArchivedFile					archive;
+			bool							archived = archive.Read( filename, bytes, size, buffer );
+
+
+			// Find an area for the image
+			D3DXIMAGE_INFO info = { };
+			HRESULT hResult = ( archived == true )
+				? D3DXGetImageInfoFromFileInMemory( bytes, (UINT)size, &info )
+				: D3DXGetImageInfoFromFileW( filename, &info );
+			if( FAILED( hResult ) )
+				return SGD::INVALID_HANDLE;
+
+			TextureAtlas::Region region;
+			if( m_Atlas.Insert( info.Width, info.Height, region ) == false )
+				return SGD::INVALID_HANDLE;
+
+			HTexture hPage = OpenAtlasPage( region );
+			if( hPage == SGD::INVALID_HANDLE )
+				return SGD::INVALID_HANDLE;
+
+			IDirect3DTexture9* texture = m_HandleManager.GetData( hPage )->texture;
+
+
+			// Load the image into its area
+			RECT area = { (LONG)region.x, (LONG)region.y, (LONG)( region.x + region.width ), (LONG)( region.y + region.height ) };
+			IDirect3DSurface9* surface = nullptr;
+
+			hResult = texture->GetSurfaceLevel( 0, &surface );
+			if( SUCCEEDED( hResult ) )
+			{
+				if( archived == true )
+					hResult = D3DXLoadSurfaceFromFileInMemory( surface, nullptr, &area, bytes, (UINT)size, nullptr, D3DX_FILTER_NONE, (D3DCOLOR)colorKey, nullptr );
+				else
+					hResult = D3DXLoadSurfaceFromFileW( surface, nullptr, &area, filename, nullptr, D3DX_FILTER_NONE, (D3DCOLOR)colorKey, nullptr );
+				surface->Release();
+			}
+
+			if( FAILED( hResult ) )
+			{
+				RemoveFromAtlas( hPage, region );
+				return SGD::INVALID_HANDLE;
+			}
+
+
+			// Texture loaded successfully (sharing the page)
+			TextureInfo data = { };
+			data.wszFilename	= _wcsdup( filename );
+			data.unRefCount		= 1;
+			data.texture		= texture;
+			data.fWidth			= (float)region.width;
+			data.fHeight		= (float)region.height;
+			data.hPage			= hPage;
+			data.region			= region;
+
+			data.texture->AddRef();
+
+			// Store texture into the Handle Manager
+			return m_HandleManager.StoreData( data );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// OPEN ATLAS PAGE
+		//	- the page for an inserted region (created when it is new)
+		//	- returns INVALID_HANDLE, and gives the region back, when the
+		//	  page cannot be created
+		HTexture GraphicsManager::OpenAtlasPage( const TextureAtlas::Region& region )
+		{
+			if( region.page >= m_vPages.size() )
+				m_vPages.resize( region.page + 1 );
+
+			if( m_vPages[ region.page ] != SGD::INVALID_HANDLE )
+				return m_vPages[ region.page ];
+
+
+			// Create the page
+			UINT size = m_Atlas.GetPageSize();
+
+			TextureInfo page = { };
+			HRESULT hResult = D3DXCreateTexture( m_pDevice, size, size, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &page.texture );
+			if( FAILED( hResult ) )
+			{
+				// MESSAGE
+				char szBuffer[ 128 ];
+				_snprintf_s( szBuffer, 128, _TRUNCATE, "!!! GraphicsManager::LoadTexture - failed to create atlas page (0x%X) !!!\n", hResult );
+				Alert( szBuffer );
+				//OutputDebugStringA( szBuffer );
+
+				m_Atlas.Remove( region );
+				return SGD::INVALID_HANDLE;
+			}
+
+			RECT all = { 0, 0, (LONG)size, (LONG)size };
+			ClearAtlasArea( page.texture, all );
+
+			page.unRefCount	= 1;
+			page.fWidth		= (float)size;
+			page.fHeight	= (float)size;
+
+			m_vPages[ region.page ] = m_HandleManager.StoreData( page );
+			return m_vPages[ region.page ];
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// MAP TO ATLAS
+		//	- point queued sprites of packed textures at their page,
+		//	  so the batch sorts them into one run per page
+		void GraphicsManager::MapToAtlas( Sprite* sprites, unsigned int count )
+		{
+			for( unsigned int i = 0; i < count; i++ )
+			{
+				const TextureInfo* data = m_HandleManager.GetData( sprites[ i ].handle );
+				if( data == nullptr || data->hPage == SGD::INVALID_HANDLE )
+					continue;
+
+				sprites[ i ].section	= TextureAtlas::MapSection( data->region, sprites[ i ].section );
+				sprites[ i ].handle		= data->hPage;
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// REMOVE FROM ATLAS
+		//	- clears the area, so it cannot bleed into a later neighbour,
+		//	  and releases the page once it is empty
+		void GraphicsManager::RemoveFromAtlas( HTexture page, const TextureAtlas::Region& region )
+		{
+			TextureInfo* data = m_HandleManager.GetData( page );
+			if( data == nullptr )
+				return;
+
+			if( m_Atlas.Remove( region ) == true )
+			{
+				data->texture->Release();
+
+				m_HandleManager.RemoveData( page, nullptr );
+				m_vPages[ region.page ] = SGD::INVALID_HANDLE;
+			}
+			else
+			{
+				RECT area = { (LONG)region.x, (LONG)region.y, (LONG)( region.x + region.width ), (LONG)( region.y + region.height ) };
+				ClearAtlasArea( data->texture, area );
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// CLEAR ATLAS AREA
+		/*static*/ void GraphicsManager::ClearAtlasArea( IDirect3DTexture9* texture, const RECT& area )
+		{
+			D3DLOCKED_RECT locked = { };
+			if( FAILED( texture->LockRect( 0, &locked, &area, 0 ) ) )
+				return;
+
+			for( LONG y = 0; y < area.bottom - area.top; y++ )
+				memset( (char*)locked.pBits + y * locked.Pitch, 0, ( area.right - area.left ) * sizeof( D3DCOLOR ) );
+
+			texture->UnlockRect( 0 );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// LOAD TEXTURE ASYNC
+		//	- stores the texture as a placeholder & queues the file
+		//	  for the loader thread (FinishLoads swaps it in)
+		HTexture GraphicsManager::LoadTextureAsync( const wchar_t* filename, Color colorKey )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "GraphicsManager::LoadTextureAsync - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return SGD::INVALID_HANDLE;
+
+			SGD_ASSERT( filename != nullptr && filename[0] != L'\0', "GraphicsManager::LoadTextureAsync - invalid filename" );
+			if( filename == nullptr || filename[0] == L'\0' )
+				return SGD::INVALID_HANDLE;
+
+
+			// Attempt to find the texture in the index
+			HTexture handle = m_Index.Find( filename );
+
+			// If it was found (loaded or loading), increase the reference & return the existing handle
+			if( handle != SGD::INVALID_HANDLE )
+			{
+				m_HandleManager.GetData( handle )->unRefCount++;
+				return handle;
+			}
+
+
+			// Create the placeholder on first use (1 translucent grey texel,
+			// stretched over the section)
+			if( m_pPlaceholder == nullptr )
+			{
+				HRESULT hResult = D3DXCreateTexture( m_pDevice, 1, 1, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &m_pPlaceholder );
+				if( FAILED( hResult ) )
+				{
+					m_pPlaceholder = nullptr;
+
+					// MESSAGE
+					char szBuffer[ 128 ];
+					_snprintf_s( szBuffer, 128, _TRUNCATE, "!!! GraphicsManager::LoadTextureAsync - failed to create the placeholder (0x%X) !!!\n", hResult );
+					Alert( szBuffer );
+					//OutputDebugStringA( szBuffer );
+
+					return SGD::INVALID_HANDLE;
+				}
+
+				D3DLOCKED_RECT area;
+				m_pPlaceholder->LockRect( 0, &area, 0, 0 );
+				((DWORD*)area.pBits)[ 0 ] = D3DCOLOR_ARGB( 128, 128, 128, 128 );
+				m_pPlaceholder->UnlockRect( 0 );
+			}
+
+
+			// Store the placeholder into the Handle Manager & index its name
+			TextureInfo data = { };
+			data.wszFilename	= _wcsdup( filename );
+			data.unRefCount		= 1;
+			data.texture		= m_pPlaceholder;
+			data.fWidth			= 1.0f;
+			data.fHeight		= 1.0f;
+			data.bLoading		= true;
+
+			data.texture->AddRef();
+
+			handle = m_HandleManager.StoreData( data );
+			m_Index.Insert( filename, handle );
+
+
+			// Decode it in the background
+			m_Loader.Queue( handle, filename, colorKey );
+			return handle;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// LOAD TEXTURE ASYNC
+		HTexture GraphicsManager::LoadTextureAsync( const char* filename, Color colorKey )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "GraphicsManager::LoadTextureAsync - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return SGD::INVALID_HANDLE;
+
+			SGD_ASSERT( filename != nullptr && filename[0] != '\0', "GraphicsManager::LoadTextureAsync - invalid filename" );
+			if( filename == nullptr || filename[0] == '\0' )
+				return SGD::INVALID_HANDLE;
+
+
+			// Convert the filename to UTF16
+			wchar_t widename[ MAX_PATH * 4 ];
+			int ret = MultiByteToWideChar( CP_UTF8, 0, filename, -1, widename, MAX_PATH * 4 );
+
+			if( ret == 0 )
+			{
+				// MESSAGE
+				char szBuffer[ 256 ];
+				_snprintf_s( szBuffer, 256, _TRUNCATE, "!!! GraphicsManager::LoadTextureAsync - invalid filename \"%hs\" (0x%X) !!!", filename, GetLastError() );
+				Alert( szBuffer );
+				//OutputDebugStringA( szBuffer );
+				//OutputDebugStringA( "\n" );
+
+				return SGD::INVALID_HANDLE;
+			}
+
+
+			// Use the UTF16 load
+			return LoadTextureAsync( widename, colorKey );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// IS TEXTURE LOADED
+		bool GraphicsManager::IsTextureLoaded( HTexture handle )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "GraphicsManager::IsTextureLoaded - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return false;
+
+			if( m_HandleManager.IsHandleValid( handle ) == false )
+				return false;
+
+			// Loaded once the placeholder has been swapped out
+			return m_HandleManager.GetData( handle )->texture != m_pPlaceholder;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// WAIT FOR TEXTURES
+		//	- invalid & unloaded handles count as done
+		unsigned int GraphicsManager::WaitForTextures( const HTexture* handles, unsigned int count, unsigned int milliseconds )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "GraphicsManager::WaitForTextures - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return 0;
+
+			SGD_ASSERT( handles != nullptr || count == 0, "GraphicsManager::WaitForTextures - handles cannot be null" );
+			if( handles == nullptr )
+				return 0;
+
+
+			DWORD start = GetTickCount();
+
+			for( ; ; )
+			{
+				// Upload what has been decoded
+				FinishLoads();
+
+				unsigned int done = 0;
+				for( unsigned int i = 0; i < count; i++ )
+					if( m_HandleManager.IsHandleValid( handles[ i ] ) == false
+						|| m_HandleManager.GetData( handles[ i ] )->bLoading == false )
+						done++;
+
+				if( done == count || milliseconds == 0 )
+					return done;
+
+
+				// Out of time?
+				DWORD wait = 0xFFFFFFFF;
+				if( milliseconds != 0xFFFFFFFF )
+				{
+					DWORD elapsed = GetTickCount() - start;
+					if( elapsed >= milliseconds )
+						return done;
+
+					wait = milliseconds - elapsed;
+				}
+
+				// Wait for the loader thread (unless it has nothing left)
+				if( m_Loader.WaitForFinished( wait ) == false && m_Loader.GetNumPending() == 0 )
+					return done;
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// DECODE IMAGE
+		//	- runs on the loader thread: reads & colour-keys the file into
+		//	  a scratch surface (system memory, never drawn)
+		//	- touches nothing but the device, which is multithreaded
+		/*static*/ bool GraphicsManager::DecodeImage( void* device, const wchar_t* filename, Color colorKey, IDirect3DSurface9*& image )
+		{
+			image = nullptr;
+
+			// Read it from the mounted archive (in place)?
+			const unsigned char*			bytes	= nullptr;
+			size_t							size	= 0;
+			std::vector< unsigned char >	buffer;
+			ArchivedFile					archive;
+			bool							archived = archive.Read( filename, bytes, size, buffer );
+
+			D3DXIMAGE_INFO info = { };
+			HRESULT hResult = ( archived == true )
+				? D3DXGetImageInfoFromFileInMemory( bytes, (UINT)size, &info )
+				: D3DXGetImageInfoFromFileW( filename, &info );
+			if( FAILED( hResult ) )
+				return false;
+
+			hResult = ((IDirect3DDevice9*)device)->CreateOffscreenPlainSurface( info.Width, info.Height, D3DFMT_A8R8G8B8, D3DPOOL_SCRATCH, &image, nullptr );
+			if( FAILED( hResult ) )
+			{
+				image = nullptr;
+				return false;
+			}
+
+			if( archived == true )
+				hResult = D3DXLoadSurfaceFromFileInMemory( image, nullptr, nullptr, bytes, (UINT)size, nullptr, D3DX_FILTER_NONE, (D3DCOLOR)colorKey, nullptr );
+			else
+				hResult = D3DXLoadSurfaceFromFileW( image, nullptr, nullptr, filename, nullptr, D3DX_FILTER_NONE, (D3DCOLOR)colorKey, nullptr );
+			if( FAILED( hResult ) )
+			{
+				image->Release();
+				image = nullptr;
+				return false;
+			}
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// FINISH LOADS
+		//	- uploads the decoded images & swaps them in for the placeholders
+		void GraphicsManager::FinishLoads( void )
+		{
+			TextureLoader< IDirect3DSurface9* >::Job job;
+			while( m_Loader.PopFinished( job ) == true )
+			{
+				// Unloaded while it was loading?
+				if( m_HandleManager.IsHandleValid( job.handle ) == false )
+				{
+					if( job.image != nullptr )
+						job.image->Release();
+					continue;
+				}
+
+
+				// Upload it (this can store an atlas page, so the texture
+				// info is looked up afterwards)
+				TextureInfo loaded = { };
+				bool success = ( job.success == true && UploadImage( job.image, loaded ) == true );
+
+				if( job.image != nullptr )
+					job.image->Release();
+
+				TextureInfo* data = m_HandleManager.GetData( job.handle );
+				data->bLoading = false;
+
+				if( success == false )
+				{
+					// MESSAGE
+					wchar_t wszBuffer[ 256 ];
+					_snwprintf_s( wszBuffer, 256, _TRUNCATE, L"!!! GraphicsManager::LoadTextureAsync - failed to load texture file \"%ws\" !!!", job.filename.c_str() );
+					Alert( wszBuffer );
+					//OutputDebugStringW( wszBuffer );
+					//OutputDebugStringA( "\n" );
+
+					continue;
+				}
+
+
+				// Swap out the placeholder
+				data->texture->Release();
+
+				data->texture	= loaded.texture;
+				data->fWidth	= loaded.fWidth;
+				data->fHeight	= loaded.fHeight;
+				data->hPage		= loaded.hPage;
+				data->region	= loaded.region;
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// UPLOAD IMAGE
+		//	- copies a decoded image into an atlas page (in atlas mode)
+		//	  or a texture of its own
+		//	- an image of its own is not stretched: when the device needs
+		//	  power of 2 textures, the rest is left transparent
+		bool GraphicsManager::UploadImage( IDirect3DSurface9* image, TextureInfo& data )
+		{
+			D3DSURFACE_DESC desc = { };
+			image->GetDesc( &desc );
+
+			RECT area = { 0, 0, (LONG)desc.Width, (LONG)desc.Height };
+
+
+			// Pack it into an atlas page?
+			TextureAtlas::Region region;
+			if( m_bAtlas == true && m_Atlas.Insert( desc.Width, desc.Height, region ) == true )
+			{
+				HTexture hPage = OpenAtlasPage( region );
+				if( hPage != SGD::INVALID_HANDLE )
+				{
+					IDirect3DTexture9* texture = m_HandleManager.GetData( hPage )->texture;
+
+					RECT page = { (LONG)region.x, (LONG)region.y, (LONG)( region.x + region.width ), (LONG)( region.y + region.height ) };
+					if( SUCCEEDED( CopyImage( texture, page, image ) ) )
+					{
+						data.texture	= texture;
+						data.fWidth		= (float)region.width;
+						data.fHeight	= (float)region.height;
+						data.hPage		= hPage;
+						data.region		= region;
+
+						data.texture->AddRef();
+						return true;
+					}
+
+					RemoveFromAtlas( hPage, region );
+				}
+			}
+
+
+			// Create a texture of its own (with mipmaps, like LoadTexture)
+			HRESULT hResult = D3DXCreateTexture( m_pDevice, desc.Width, desc.Height, D3DX_DEFAULT, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &data.texture );
+			if( FAILED( hResult ) )
+				return false;
+
+			hResult = CopyImage( data.texture, area, image );
+			if( FAILED( hResult ) )
+			{
+				data.texture->Release();
+				data.texture = nullptr;
+				return false;
+			}
+
+			D3DXFilterTexture( data.texture, nullptr, 0, D3DX_DEFAULT );
+
+
+			// Store the buffer size
+			D3DSURFACE_DESC surface = { };
+			data.texture->GetLevelDesc( 0, &surface );
+
+			data.fWidth  = (float)surface.Width;
+			data.fHeight = (float)surface.Height;
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// COPY IMAGE
+		/*static*/ HRESULT GraphicsManager::CopyImage( IDirect3DTexture9* texture, const RECT& area, IDirect3DSurface9* image )
+		{
+			IDirect3DSurface9* surface = nullptr;
+
+			HRESULT hResult = texture->GetSurfaceLevel( 0, &surface );
+			if( FAILED( hResult ) )
+				return hResult;
+
+			hResult = D3DXLoadSurfaceFromSurface( surface, nullptr, &area, image, nullptr, nullptr, D3DX_FILTER_NONE, 0 );
+			surface->Release();
+			return hResult;
+		}
+		//*************************************************************//
+
+
+
 		//*************************************************************//
 		// UNLOAD TEXTURE
 		bool GraphicsManager::UnloadTexture( HTexture& handle )	
@@ -1728,11 +2693,19 @@ namespace SGD
 				data->texture->Release();
 
 				// Deallocate the name
+				m_Index.Remove( data->wszFilename );
 				delete[] data->wszFilename;
 
+				// Give back the atlas area
+				HTexture				page	= data->hPage;
+				TextureAtlas::Region	region	= data->region;
+
 				// Remove the audio info from the handle manager
 				m_HandleManager.RemoveData( handle, nullptr );
 				data = nullptr;
+
+				if( page != SGD::INVALID_HANDLE )
+					RemoveFromAtlas( page, region );
 			}
 
 
@@ -1744,26 +2717,6 @@ namespace SGD
 
 
 
-		//*************************************************************//
-		// FIND TEXTURE BY NAME
-		/*static*/ bool GraphicsManager::FindTextureByName( Handle handle, TextureInfo& data, SearchInfo* extra )
-		{		
-			// Compare the names
-			if( wcscmp( data.wszFilename, extra->filename ) == 0 )
-			{
-				// Texture does exist!
-				extra->texture	= &data;
-				extra->handle	= handle;
-				return false;
-			}
-
-			// Did not find yet
-			return true;
-		}
-		//*************************************************************//
-
-
-
 		//*************************************************************//
 		// INITIALIZE WINDOW
 		HWND GraphicsManager::InitializeWindow( const wchar_t* title, LONG width, LONG height )
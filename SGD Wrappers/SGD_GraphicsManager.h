@@ -27,6 +27,45 @@ namespace SGD
 	// Forward declaration of global variable
 	extern const float PI;
 
+
+	//*****************************************************************//
+	// BlendMode
+	//	- how a sprite is combined with what is behind it
+	enum class BlendMode
+	{
+		Alpha,			// blended by the sprite's alpha (default)
+		Additive,		// added to the background (glows, sparks)
+	};
+
+
+	//*****************************************************************//
+	// Sprite
+	//	- one textured quad for DrawSprites
+	//	- same parameters as DrawTextureSection
+	//	  (an empty section draws the whole texture)
+	struct Sprite
+	{
+		HTexture	handle;
+		Point		position;
+		Rectangle	section;
+		float		rotation		= 0.0f;
+		Vector		rotationOffset;
+		Color		color;
+		Size		scale			= Size{ 1.0f, 1.0f };
+		BlendMode	blend			= BlendMode::Alpha;
+	};
+
+
+	//*****************************************************************//
+	// RenderStats
+	//	- counts for the last frame presented by Update
+	struct RenderStats
+	{
+		unsigned int	sprites;			// textured quads drawn
+		unsigned int	drawCalls;			// submissions to the device
+		unsigned int	textureSwitches;	// submissions that changed the texture
+	};
+
 	
 	//*****************************************************************//
 	// GraphicsManager
@@ -67,6 +106,48 @@ namespace SGD
 		virtual	bool		UnloadTexture		( HTexture& handle )										= 0;
 
 
+		// Batching:
+		//	- between BeginBatch & EndBatch, DrawTexture, DrawTextureSection & DrawSprites
+		//	  are queued, then EndBatch transforms them in one pass and submits them
+		//	  sorted by blend mode & texture (one draw call per run)
+		//	- sprites sharing a texture & blend mode keep their order, others may be
+		//	  reordered: only batch sprites whose overlap order does not matter
+		//	- DrawString, DrawLine & DrawRectangle submit the queued sprites first
+		//	- outside a batch, DrawSprites sorts & submits its own sprites
+		virtual	bool		BeginBatch			( void )										= 0;
+		virtual	bool		EndBatch			( void )										= 0;
+		virtual	bool		DrawSprites			( const Sprite* sprites, unsigned int count )	= 0;
+
+		virtual	RenderStats	GetRenderStats		( void ) const									= 0;
+
+
+		// Atlas mode:
+		//	- textures loaded while it is on are packed into shared square pages,
+		//	  so sprites from different images batch into one run & draw without
+		//	  changing the texture
+		//	- the handles & sections do not change for the callers
+		//	- images larger than a page are still loaded on their own
+		//	- the page size cannot change while pages are in use
+		virtual	bool		SetAtlasMode		( bool atlas = true, unsigned int pageSize = 2048 )	= 0;
+
+
+		// Asynchronous loading:
+		//	- LoadTextureAsync returns the handle at once, and a loader thread
+		//	  decodes & colour-keys the file; Update uploads it once it is ready
+		//	- until then, sections of it draw as a translucent placeholder box
+		//	  (whole-texture draws are skipped: the size is not known yet)
+		//	- WaitForTextures uploads the finished textures & returns how many
+		//	  of the handles are done, waiting up to 'milliseconds' for the rest
+		//	  (0 = only check, e.g. for a loading bar; 0xFFFFFFFF = until done)
+		//	- IsTextureLoaded is false while loading & after a failed load
+		//	  (a failed handle stays a placeholder until it is unloaded)
+		//	- LoadTexture on a file that is still loading waits for it
+		virtual	HTexture	LoadTextureAsync	( const wchar_t* filename, Color colorKey = {0,0,0,0} )		= 0;
+		virtual	HTexture	LoadTextureAsync	( const char* filename, Color colorKey = {0,0,0,0} )		= 0;
+		virtual	bool		IsTextureLoaded		( HTexture handle )											= 0;
+		virtual	unsigned int	WaitForTextures	( const HTexture* handles, unsigned int count, unsigned int milliseconds = 0xFFFFFFFF )	= 0;
+
+
 	protected:
 		GraphicsManager					( void )					= default;
 		virtual	~GraphicsManager		( void )					= default;
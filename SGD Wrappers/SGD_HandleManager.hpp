@@ -280,7 +280,7 @@ namespace SGD
 
 			// Clear the data (does not deallocate individual objects)
 			m_vData.clear();
-			m_vData.swap( std::move( DataVector() ) );		// force the collapse
+			DataVector().swap( m_vData );					// force the collapse
 
 			return true;
 		}
@@ -299,7 +299,7 @@ namespace SGD
 			SGD_ASSERT( pFunction != nullptr, "HandleManager::ForEach - invalid function pointer" );
 
 			// Iterate through all the (valid) stored data
-			DataVector::const_iterator iter;
+			typename DataVector::const_iterator iter;
 			for( iter = m_vData.cbegin(); iter != m_vData.cend(); ++iter )
 			{
 				if( iter->first != SGD::INVALID_HANDLE )
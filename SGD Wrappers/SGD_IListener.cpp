@@ -35,6 +35,16 @@ namespace SGD
 	{
 		return EventManager::GetInstance()->UnregisterFromEvent( this, eventID );
 	}
+
+	bool IListener::RegisterForEvent( const EventID& eventID )
+	{
+		return EventManager::GetInstance()->RegisterForEvent( this, eventID );
+	}
+
+	bool IListener::UnregisterFromEvent( const EventID& eventID )
+	{
+		return EventManager::GetInstance()->UnregisterFromEvent( this, eventID );
+	}
 	//*****************************************************************//
 
 
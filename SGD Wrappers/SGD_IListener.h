@@ -19,8 +19,9 @@
 
 namespace SGD
 {
-	// Forward declaration
+	// Forward declarations
 	class Event;
+	class EventID;
 
 
 	//*****************************************************************//
@@ -37,6 +38,8 @@ namespace SGD
 		// EventManager Interactions:
 		bool			RegisterForEvent	( const char* eventID );
 		bool			UnregisterFromEvent	( const char* eventID = nullptr );
+		bool			RegisterForEvent	( const EventID& eventID );		// interned (faster)
+		bool			UnregisterFromEvent	( const EventID& eventID );
 
 		// Listener Interface:
 		virtual void	HandleEvent			( const SGD::Event* pEvent )	= 0;	// Callback function to process events
@@ -0,0 +1,82 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_MPSCQueue.h 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To pass items from any number of threads to			|
+|					one consuming thread without locking				|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_MPSCQUEUE_H
+#define SGD_MPSCQUEUE_H
+
+
+// Uses size_t
+#include <cstddef>
+
+// Uses std::atomic for claiming cells without a lock
+#include <atomic>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// MPSCQueue<>
+		//	- bounded multi-producer, single-consumer ring
+		//	- each cell carries a sequence number: producers claim a
+		//	  position with one compare-exchange, then publish the cell
+		//	  by advancing its sequence; the consumer only reads cells
+		//	  that have been published
+		//	- Push is safe from any thread & fails when the ring is full,
+		//	  Pop must only be called from the consuming thread
+		//	- the capacity is rounded up to a power of two
+		template< typename DataType >
+		class MPSCQueue
+		{
+		public:
+			explicit MPSCQueue	( size_t capacity );
+			~MPSCQueue			( void );
+
+
+			bool		Push			( const DataType& data );		// false if full
+			bool		Pop				( DataType& data );				// false if empty
+
+			size_t		GetCapacity		( void ) const	{	return m_uMask + 1;		}
+
+
+		private:
+			MPSCQueue				( const MPSCQueue& )	= delete;	// Copy constructor
+			MPSCQueue&	operator=	( const MPSCQueue& )	= delete;	// Assignment operator
+
+
+			struct Cell
+			{
+				std::atomic< size_t >	sequence;		// position it can be written (== pos) or read (== pos + 1)
+				DataType				data;
+			};
+
+			// Cache line (keeps the producers' counter off the consumer's line)
+			enum { CACHE_LINE = 64 };
+
+			Cell*					m_pCells;
+			size_t					m_uMask;
+			char					m_aPad0[ CACHE_LINE ];
+			std::atomic< size_t >	m_uEnqueue;				// next position to claim (producers)
+			char					m_aPad1[ CACHE_LINE ];
+			size_t					m_uDequeue;				// next position to read (consumer)
+		};
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+
+// Template definitions are within the .hpp
+#define	INC_SGD_MPSC_QUEUE_HPP
+#include "SGD_MPSCQueue.hpp"
+#undef	INC_SGD_MPSC_QUEUE_HPP
+
+#endif //SGD_MPSCQUEUE_H
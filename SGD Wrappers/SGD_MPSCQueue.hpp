@@ -0,0 +1,115 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_MPSCQueue.hpp 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To pass items from any number of threads to			|
+|					one consuming thread without locking				|
+|																		|
+\***********************************************************************/
+
+// This .hpp can ONLY be included from SGD_MPSCQueue.h
+#ifndef INC_SGD_MPSC_QUEUE_HPP
+#error	FILE "SGD_MPSCQueue.hpp" CANNOT BE INCLUDED EXPLICITLY
+#else
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// CONSTRUCTOR
+		//	- cell 'i' starts out writable at position 'i'
+		template< typename DataType >
+		MPSCQueue< DataType >::MPSCQueue( size_t capacity )
+			: m_uEnqueue( 0 ), m_uDequeue( 0 )
+		{
+			size_t size = 2;
+			while( size < capacity )
+				size <<= 1;
+
+			m_pCells	= new Cell[ size ];
+			m_uMask		= size - 1;
+
+			for( size_t i = 0; i < size; i++ )
+				m_pCells[ i ].sequence.store( i, std::memory_order_relaxed );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// DESTRUCTOR
+		//	- the owner is responsible for what is still queued
+		template< typename DataType >
+		MPSCQueue< DataType >::~MPSCQueue( void )
+		{
+			delete[] m_pCells;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// PUSH
+		//	- claim the next position whose cell has been read
+		//	- publish the data by advancing the cell's sequence
+		template< typename DataType >
+		bool MPSCQueue< DataType >::Push( const DataType& data )
+		{
+			Cell* cell;
+			size_t pos = m_uEnqueue.load( std::memory_order_relaxed );
+
+			for( ;; )
+			{
+				cell = &m_pCells[ pos & m_uMask ];
+				size_t sequence = cell->sequence.load( std::memory_order_acquire );
+				ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+
+				if( difference == 0 )
+				{
+					// Writable: claim it (pos is reloaded on failure)
+					if( m_uEnqueue.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) == true )
+						break;
+				}
+				else if( difference < 0 )
+					return false;		// full: the consumer has not read it yet
+				else
+					pos = m_uEnqueue.load( std::memory_order_relaxed );		// another producer claimed it
+			}
+
+			cell->data = data;
+			cell->sequence.store( pos + 1, std::memory_order_release );
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// POP
+		//	- read the next published cell
+		//	- hand it back to the producers one lap later
+		template< typename DataType >
+		bool MPSCQueue< DataType >::Pop( DataType& data )
+		{
+			Cell* cell = &m_pCells[ m_uDequeue & m_uMask ];
+			size_t sequence = cell->sequence.load( std::memory_order_acquire );
+
+			if( (ptrdiff_t)sequence - (ptrdiff_t)( m_uDequeue + 1 ) < 0 )
+				return false;		// empty (or still being written)
+
+			data = cell->data;
+			cell->sequence.store( m_uDequeue + m_uMask + 1, std::memory_order_release );
+			++m_uDequeue;
+			return true;
+		}
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+
+#endif //INC_SGD_MPSC_QUEUE_HPP
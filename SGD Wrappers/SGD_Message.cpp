@@ -19,12 +19,26 @@
 // Uses Message Manager
 #include "SGD_MessageManager.h"
 
+// Uses FrameArena for allocation
+#include "SGD_FrameArena.h"
+
 
 namespace SGD
 {
 	//*****************************************************************//
 	// MESSAGE METHODS
 
+	// Allocation:
+	/*static*/ void* Message::operator new( size_t size )
+	{
+		return FrameArena::GetInstance()->Allocate( size );
+	}
+
+	/*static*/ void Message::operator delete( void* p )
+	{
+		FrameArena::GetInstance()->Deallocate( p );
+	}
+
 	// MessageManager Interaction:
 	bool Message::QueueMessage( void ) const
 	{
@@ -17,6 +17,9 @@
 #define SGD_MESSAGE_H
 
 
+// Uses size_t for allocation
+#include <cstddef>
+
 //*********************************************************************//
 // Forward enum class declaration (MUST BE DEFINED SOMEWHERE)
 enum class MessageID;
@@ -38,6 +41,13 @@ namespace SGD
 		virtual	~Message( void )	= default;
 		
 
+		// Allocation:
+		//	- new / delete use the FrameArena (queued messages only
+		//	  live until the MessageManager's next Update)
+		static void*	operator new	( size_t size );
+		static void		operator delete	( void* p );
+
+
 		// MessageManager Interaction:
 		bool	QueueMessage	( void )	const;			// message will be stored & deallocated by the MessageManager
 		bool	SendMessageNow	( void )	const;			// message will NOT be stored or deallocated!
@@ -0,0 +1,344 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_MessageBus.cpp 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To queue messages by value & deliver each type		|
+|					to the function registered for it					|
+|																		|
+\***********************************************************************/
+
+#include "SGD_MessageBus.h"
+
+
+namespace SGD
+{
+	//*****************************************************************//
+	// SINGLETON
+
+	// Instantiate static pointer to null (no instance yet)
+	/*static*/ MessageBus* MessageBus::s_pInstance = nullptr;
+
+	// No thread captures until it selects a stream
+	/*static*/ SGD_THREAD_LOCAL unsigned int MessageBus::s_unCaptureStream = NO_CAPTURE_STREAM;
+
+	// Only the initializing thread queues directly
+	/*static*/ SGD_THREAD_LOCAL bool MessageBus::s_bOwnerThread = false;
+
+	// Singleton accessor
+	/*static*/ MessageBus* MessageBus::GetInstance( void )
+	{
+		// Allocate singleton on first use
+		if( s_pInstance == nullptr )
+			s_pInstance = new MessageBus;
+
+		return s_pInstance;
+	}
+
+	// Singleton destructor
+	/*static*/ void MessageBus::DeleteInstance( void )
+	{
+		delete s_pInstance;
+		s_pInstance = nullptr;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// CONSTRUCTOR
+	MessageBus::MessageBus( void )
+		: m_qPosted( POST_CAPACITY ), m_bOverflowed( false )
+	{
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// INITIALIZE
+	bool MessageBus::Initialize( void )
+	{
+		// Sanity-check the status
+		SGD_ASSERT( m_bInitialized == false, "MessageBus::Initialize - bus has already been initialized" );
+		if( m_bInitialized == true )
+			return false;
+
+
+		// Other threads post to the ring
+		s_bOwnerThread = true;
+
+		m_bInitialized = true;
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// UPDATE
+	bool MessageBus::Update( void )
+	{
+		// Sanity-check the status
+		SGD_ASSERT( m_bInitialized == true, "MessageBus::Update - bus has not been initialized" );
+		if( m_bInitialized == false )
+			return false;
+
+
+		// Receive the messages posted by other threads
+		ReceivePosted();
+
+
+		// Iterate through the entire queue
+		//	(including messages queued by the handlers)
+		while( m_unNextMessage < m_vMessages.size() )
+		{
+			// Copy it out (a handler may grow the queue)
+			Envelope envelope = m_vMessages[ m_unNextMessage++ ];
+			Deliver( envelope );
+		}
+
+		m_vMessages.clear();
+		m_unNextMessage = 0;
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// TERMINATE
+	bool MessageBus::Terminate( void )
+	{
+		// Sanity-check the status
+		SGD_ASSERT( m_bInitialized == true, "MessageBus::Terminate - bus has not been initialized" );
+		if( m_bInitialized == false )
+			return false;
+
+
+		// Drop the queued & captured messages (nothing to deallocate)
+		Clear();
+
+		m_vCaptureStreams.clear();
+		m_bCapturing = false;
+
+		// Remove the handlers
+		m_vHandlers.clear();
+
+		s_bOwnerThread = false;
+
+		m_bInitialized = false;
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// CLEAR
+	bool MessageBus::Clear( void )
+	{
+		// Sanity-check the status
+		SGD_ASSERT( m_bInitialized == true, "MessageBus::Clear - bus has not been initialized" );
+		if( m_bInitialized == false )
+			return false;
+
+
+		ReceivePosted();
+		m_vMessages.clear();
+		m_unNextMessage = 0;
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// BEGIN CAPTURE
+	bool MessageBus::BeginCapture( unsigned int numStreams )
+	{
+		// Sanity-check the status
+		SGD_ASSERT( m_bInitialized == true, "MessageBus::BeginCapture - bus has not been initialized" );
+		if( m_bInitialized == false )
+			return false;
+
+		SGD_ASSERT( m_bCapturing == false, "MessageBus::BeginCapture - already capturing" );
+		if( m_bCapturing == true )
+			return false;
+
+
+		// Allocate the streams up-front (jobs must not resize the vector)
+		m_vCaptureStreams.resize( numStreams );
+		m_bCapturing = true;
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// SET CAPTURE STREAM
+	bool MessageBus::SetCaptureStream( unsigned int stream )
+	{
+		// Sanity-check the parameter
+		SGD_ASSERT( stream == NO_CAPTURE_STREAM || stream < m_vCaptureStreams.size(), "MessageBus::SetCaptureStream - invalid stream" );
+		if( stream != NO_CAPTURE_STREAM && stream >= m_vCaptureStreams.size() )
+			return false;
+
+		s_unCaptureStream = stream;
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// END CAPTURE
+	bool MessageBus::EndCapture( void )
+	{
+		SGD_ASSERT( m_bCapturing == true, "MessageBus::EndCapture - not capturing" );
+		if( m_bCapturing == false )
+			return false;
+
+
+		// Merge the streams in order
+		for( unsigned int s = 0; s < m_vCaptureStreams.size(); s++ )
+		{
+			std::vector< Envelope >& stream = m_vCaptureStreams[ s ];
+			m_vMessages.insert( m_vMessages.end(), stream.begin(), stream.end() );
+
+			stream.clear();		// keep the memory for the next capture
+		}
+
+		s_unCaptureStream = NO_CAPTURE_STREAM;
+		m_bCapturing = false;
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// SET HANDLER
+	bool MessageBus::SetHandler( unsigned int type, Thunk thunk, GenericProc pfHandler )
+	{
+		// Sanity-check the status
+		SGD_ASSERT( m_bInitialized == true, "MessageBus::Subscribe - bus has not been initialized" );
+		if( m_bInitialized == false )
+			return false;
+
+		// Sanity-check the parameter
+		SGD_ASSERT( pfHandler != nullptr, "MessageBus::Subscribe - handler cannot be null" );
+		if( pfHandler == nullptr )
+			return false;
+
+
+		if( type >= m_vHandlers.size() )
+		{
+			Handler none = { nullptr, nullptr };
+			m_vHandlers.resize( type + 1, none );
+		}
+
+		m_vHandlers[ type ].thunk	= thunk;
+		m_vHandlers[ type ].handler	= pfHandler;
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// QUEUE ENVELOPE
+	bool MessageBus::QueueEnvelope( const Envelope& envelope )
+	{
+		// Sanity-check the status
+		SGD_ASSERT( m_bInitialized == true, "MessageBus::Queue - bus has not been initialized" );
+		if( m_bInitialized == false )
+			return false;
+
+
+		// Is the calling thread capturing?
+		if( m_bCapturing == true && s_unCaptureStream < m_vCaptureStreams.size() )
+		{
+			m_vCaptureStreams[ s_unCaptureStream ].push_back( envelope );
+			return true;
+		}
+
+		// Is it from another thread?
+		if( s_bOwnerThread == false )
+		{
+			Post( envelope );
+			return true;
+		}
+
+		// Queue the message
+		m_vMessages.push_back( envelope );
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// DELIVER
+	//	- call the handler registered for the message's type
+	bool MessageBus::Deliver( const Envelope& envelope ) const
+	{
+		if( envelope.type >= m_vHandlers.size() || m_vHandlers[ envelope.type ].handler == nullptr )
+		{
+			SGD_PRINT( L"MessageBus - no handler for the message type\n" );
+			return false;
+		}
+
+		const Handler& handler = m_vHandlers[ envelope.type ];
+		(*handler.thunk)( handler.handler, envelope.payload.bytes );
+		return true;
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// POST
+	//	- lock-free unless the ring is full
+	//	- once a message overflows, the later ones queue behind it
+	//	  (not in the ring) until it is received
+	void MessageBus::Post( const Envelope& envelope )
+	{
+		if( m_bOverflowed.load() == false && m_qPosted.Push( envelope ) == true )
+			return;
+
+		std::lock_guard< std::mutex > lock( m_mtxOverflow );
+		m_vOverflow.push_back( envelope );
+		m_bOverflowed.store( true );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// RECEIVE POSTED
+	//	- append the posted messages to the queue
+	//	  (the ring first, then any overflow)
+	void MessageBus::ReceivePosted( void )
+	{
+		Envelope envelope;
+		while( m_qPosted.Pop( envelope ) == true )
+			m_vMessages.push_back( envelope );
+
+		if( m_bOverflowed.load() == false )
+			return;
+
+		// Empty the ring again under the lock: a thread can fill it
+		// after the pass above, then overflow
+		std::lock_guard< std::mutex > lock( m_mtxOverflow );
+		while( m_qPosted.Pop( envelope ) == true )
+			m_vMessages.push_back( envelope );
+
+		m_vMessages.insert( m_vMessages.end(), m_vOverflow.begin(), m_vOverflow.end() );
+		m_vOverflow.clear();
+		m_bOverflowed.store( false );
+	}
+	//*****************************************************************//
+
+}	// namespace SGD
@@ -0,0 +1,169 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_MessageBus.h 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To queue messages by value & deliver each type		|
+|					to the function registered for it					|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_MESSAGEBUS_H
+#define SGD_MESSAGEBUS_H
+
+
+// Uses MPSCQueue for receiving messages from other threads
+#include "SGD_MPSCQueue.h"
+
+// Uses std::vector for storing queued & captured messages
+#include <vector>
+
+// Uses std::mutex for the posting overflow
+#include <atomic>
+#include <mutex>
+
+// Uses SGD_THREAD_LOCAL for the capture streams
+#include "SGD_Utilities.h"
+
+
+//*********************************************************************//
+// Forward enum class declaration (MUST BE DEFINED SOMEWHERE)
+enum class MessageID;
+
+
+namespace SGD
+{
+	//*****************************************************************//
+	// MessageBus
+	//	- SINGLETON queue of typed messages, stored by value (no heap
+	//	  allocation, virtual destructor or cast per message)
+	//	- a message type is any trivially copyable class up to
+	//	  MAX_MESSAGE_SIZE bytes with a 'static const MessageID ID'
+	//	- one handler function per message type, called in queue order
+	//	- Queue is safe from any thread: messages queued by threads other
+	//	  than the one that called Initialize (and not capturing) are
+	//	  received by the next Update
+	class MessageBus
+	{
+	public:
+		static	MessageBus*		GetInstance		( void );
+		static	void			DeleteInstance	( void );
+
+
+		bool		Initialize		( void );
+		bool		Update			( void );
+		bool		Terminate		( void );
+
+		template< typename MessageType >
+		bool		Subscribe		( void (*pfHandler)( const MessageType& ) );	// replaces the type's handler
+
+		template< typename MessageType >
+		bool		Queue			( const MessageType& message );					// delivered by the next Update
+
+		template< typename MessageType >
+		bool		SendNow			( const MessageType& message );					// delivered immediately
+
+		bool		Clear			( void );
+
+
+		// Capture (for parallel jobs):
+		//	- between BeginCapture & EndCapture, messages queued by a thread that selected
+		//	  a capture stream are stored in that stream instead of the queue
+		//	- EndCapture appends the streams to the queue in stream order (deterministic)
+		enum { NO_CAPTURE_STREAM = 0xFFFFFFFF };
+
+		bool		BeginCapture		( unsigned int numStreams );
+		bool		SetCaptureStream	( unsigned int stream );		// for the calling thread only
+		bool		EndCapture			( void );
+
+
+		// Largest message type (bytes)
+		enum { MAX_MESSAGE_SIZE = 32 };
+
+
+	private:
+		MessageBus				( void );
+		~MessageBus				( void )				= default;
+
+		MessageBus				( const MessageBus& )	= delete;
+		MessageBus& operator=	( const MessageBus& )	= delete;
+
+		static	MessageBus*		s_pInstance;
+
+
+		// Envelope:
+		//	- the message's type (MessageID) & its bytes
+		struct Envelope
+		{
+			unsigned int	type;
+			union
+			{
+				char		bytes[ MAX_MESSAGE_SIZE ];
+				long long	alignLong;
+				double		alignDouble;
+				void*		alignPointer;
+			}				payload;
+		};
+
+		// Handler:
+		//	- the registered function, called through the thunk
+		//	  instantiated for its message type
+		typedef void (*GenericProc)( void );
+		typedef void (*Thunk)( GenericProc pfHandler, const void* payload );
+
+		struct Handler
+		{
+			Thunk			thunk;
+			GenericProc		handler;
+		};
+
+		template< typename MessageType >
+		static	void	Invoke			( GenericProc pfHandler, const void* payload );
+
+		template< typename MessageType >
+		static	void	Seal			( const MessageType& message, Envelope& envelope );
+
+		bool			SetHandler		( unsigned int type, Thunk thunk, GenericProc pfHandler );
+		bool			QueueEnvelope	( const Envelope& envelope );
+		bool			Deliver			( const Envelope& envelope ) const;
+		void			Post			( const Envelope& envelope );
+		void			ReceivePosted	( void );
+
+
+		bool							m_bInitialized	= false;
+
+		std::vector< Envelope >			m_vMessages;					// message queue (keeps its memory)
+		unsigned int					m_unNextMessage	= 0;			// first message not processed yet
+
+		std::vector< Handler >			m_vHandlers;					// by message type
+
+		std::vector< std::vector< Envelope > >	m_vCaptureStreams;		// messages captured per stream
+		bool							m_bCapturing	= false;		// between BeginCapture & EndCapture
+
+		static SGD_THREAD_LOCAL unsigned int	s_unCaptureStream;		// the calling thread's stream
+
+
+		// Posting (from threads other than the one that initialized):
+		//	- lock-free ring, received at the start of Update
+		//	- when the ring is full, a locked overflow list is used
+		//	  until Update receives it, so each thread's posts
+		//	  arrive in order
+		enum { POST_CAPACITY = 4096 };
+
+		SGD_IMPLEMENTATION::MPSCQueue< Envelope >	m_qPosted;			// messages posted by other threads
+		std::vector< Envelope >			m_vOverflow;					// posted messages that did not fit
+		std::mutex						m_mtxOverflow;
+		std::atomic< bool >				m_bOverflowed;
+
+		static SGD_THREAD_LOCAL bool	s_bOwnerThread;					// the calling thread initialized the bus
+	};
+
+}	// namespace SGD
+
+
+// Template definitions are within the .hpp
+#define	INC_SGD_MESSAGE_BUS_HPP
+#include "SGD_MessageBus.hpp"
+#undef	INC_SGD_MESSAGE_BUS_HPP
+
+#endif	//SGD_MESSAGEBUS_H
@@ -0,0 +1,93 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_MessageBus.hpp 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To queue messages by value & deliver each type		|
+|					to the function registered for it					|
+|																		|
+\***********************************************************************/
+
+// This .hpp can ONLY be included from SGD_MessageBus.h
+#ifndef INC_SGD_MESSAGE_BUS_HPP
+#error	FILE "SGD_MessageBus.hpp" CANNOT BE INCLUDED EXPLICITLY
+#else
+
+
+// Uses memcpy for sealing the envelopes
+#include <cstring>
+
+// Uses std::is_trivially_copyable for validating the message types
+#include <type_traits>
+
+
+namespace SGD
+{
+	//*****************************************************************//
+	// SUBSCRIBE
+	template< typename MessageType >
+	bool MessageBus::Subscribe( void (*pfHandler)( const MessageType& ) )
+	{
+		return SetHandler( (unsigned int)MessageType::ID, &MessageBus::Invoke< MessageType >,
+						   reinterpret_cast< GenericProc >( pfHandler ) );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// QUEUE
+	template< typename MessageType >
+	bool MessageBus::Queue( const MessageType& message )
+	{
+		Envelope envelope;
+		Seal( message, envelope );
+		return QueueEnvelope( envelope );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// SEND NOW
+	template< typename MessageType >
+	bool MessageBus::SendNow( const MessageType& message )
+	{
+		Envelope envelope;
+		Seal( message, envelope );
+		return Deliver( envelope );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// INVOKE
+	//	- call the handler with the payload as its message type
+	template< typename MessageType >
+	/*static*/ void MessageBus::Invoke( GenericProc pfHandler, const void* payload )
+	{
+		( *reinterpret_cast< void (*)( const MessageType& ) >( pfHandler ) )( *static_cast< const MessageType* >( payload ) );
+	}
+	//*****************************************************************//
+
+
+
+	//*****************************************************************//
+	// SEAL
+	//	- copy the message's bytes into the envelope
+	template< typename MessageType >
+	/*static*/ void MessageBus::Seal( const MessageType& message, Envelope& envelope )
+	{
+		static_assert( sizeof( MessageType ) <= MAX_MESSAGE_SIZE, "MessageBus - message type is larger than MAX_MESSAGE_SIZE" );
+		static_assert( std::is_trivially_copyable< MessageType >::value, "MessageBus - message type must be trivially copyable" );
+
+		envelope.type = (unsigned int)MessageType::ID;
+		memcpy( envelope.payload.bytes, &message, sizeof( MessageType ) );
+	}
+	//*****************************************************************//
+
+}	// namespace SGD
+
+
+#endif //INC_SGD_MESSAGE_BUS_HPP
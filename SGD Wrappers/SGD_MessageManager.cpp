@@ -22,12 +22,17 @@
 // Uses TSTRING for text
 #include "SGD_String.h"
 
-// Uses std::queue for storing messages
-#include <queue>
+// Uses std::vector for storing queued & captured messages
+#include <vector>
 
 // Uses Message (virtual destructor)
 #include "SGD_Message.h"
 
+// Uses MPSCQueue & std::mutex for receiving messages from other threads
+#include "SGD_MPSCQueue.h"
+#include <atomic>
+#include <mutex>
+
 // Uses SGD_ASSERT for debug breaks
 #include "SGD_Utilities.h"
 
@@ -55,13 +60,17 @@ namespace SGD
 			virtual bool		SendMessageNow			( const Message* pMsg )	override;
 
 			virtual bool		ClearMessages			( void )				override;
+
+			virtual bool		BeginCapture			( unsigned int numStreams )	override;
+			virtual bool		SetCaptureStream		( unsigned int stream )		override;
+			virtual bool		EndCapture				( void )					override;
 						
 
 		private:
 			// SINGLETON
 			static	MessageManager*		s_Instance;		// the ONE instance
 
-			MessageManager				( void )					= default;		// Default constructor
+			MessageManager				( void );									// Default constructor
 			virtual	~MessageManager		( void )					= default;		// Destructor
 
 			MessageManager				( const MessageManager& )	= delete;		// Copy constructor
@@ -78,11 +87,35 @@ namespace SGD
 
 			EMessageManagerStatus		m_eStatus	= E_UNINITIALIZED;		// wrapper initialization status
 			
-			typedef std::queue< const Message* > MessageQueue;
-			MessageQueue				m_qMessages;						// message queue
+			typedef std::vector< const Message* > MessageQueue;
+			MessageQueue				m_vMessages;						// message queue (keeps its memory)
+			unsigned int				m_unNextMessage	= 0;				// first message not processed yet
 
 			typedef void (*MessageProcedure)( const Message* );
 			MessageProcedure			m_pCallback	= nullptr;				// callback function
+
+			typedef std::vector< const Message* > MessageStream;
+			std::vector< MessageStream >	m_vCaptureStreams;				// messages captured per stream
+			bool							m_bCapturing	= false;		// between BeginCapture & EndCapture
+
+			static SGD_THREAD_LOCAL unsigned int	s_unCaptureStream;		// the calling thread's stream
+
+			// Posting (from threads other than the one that initialized):
+			//	- lock-free ring, received at the start of Update
+			//	- when the ring is full, a locked overflow list is used
+			//	  until Update receives it, so each thread's posts
+			//	  arrive in order
+			enum { POST_CAPACITY = 4096 };
+
+			MPSCQueue< const Message* >		m_qPosted;						// messages posted by other threads
+			std::vector< const Message* >	m_vOverflow;					// posted messages that did not fit
+			std::mutex						m_mtxOverflow;
+			std::atomic< bool >				m_bOverflowed;
+
+			static SGD_THREAD_LOCAL bool	s_bOwnerThread;					// the calling thread initialized the wrapper
+
+			void		Post				( const Message* pMsg );
+			void		ReceivePosted		( void );
 		};
 		//*************************************************************//
 
@@ -116,6 +149,12 @@ namespace SGD
 		// Instantiate static pointer to null (no instance yet)
 		/*static*/ MessageManager* MessageManager::s_Instance = nullptr;
 
+		// No thread captures until it selects a stream
+		/*static*/ SGD_THREAD_LOCAL unsigned int MessageManager::s_unCaptureStream = NO_CAPTURE_STREAM;
+
+		// Only the initializing thread queues directly
+		/*static*/ SGD_THREAD_LOCAL bool MessageManager::s_bOwnerThread = false;
+
 		// Singleton accessor
 		/*static*/ MessageManager* MessageManager::GetInstance( void )
 		{
@@ -156,6 +195,9 @@ namespace SGD
 			// Store the callback function
 			m_pCallback = pfMessageProc;
 
+			// Other threads post to the ring
+			s_bOwnerThread = true;
+
 
 			// Success!
 			m_eStatus = E_INITIALIZED;
@@ -165,6 +207,16 @@ namespace SGD
 
 
 
+		//*************************************************************//
+		// CONSTRUCTOR
+		MessageManager::MessageManager( void )
+			: m_qPosted( POST_CAPACITY ), m_bOverflowed( false )
+		{
+		}
+		//*************************************************************//
+
+
+
 		//*************************************************************//
 		// UPDATE
 		bool MessageManager::Update( void )
@@ -175,14 +227,22 @@ namespace SGD
 				return false;
 
 
+			// Receive the messages posted by other threads
+			ReceivePosted();
+
+
 			// Iterate through the entire queue
-			while( m_qMessages.empty() == false )
+			//	(including messages queued by the callback)
+			while( m_unNextMessage < m_vMessages.size() )
 			{
-				(*m_pCallback)( m_qMessages.front() );		// send the message to the callback function to process
-				delete m_qMessages.front();					// deallocate the message (virtual destructor)
-				m_qMessages.pop();							// remove the message from the queue
+				const Message* pMsg = m_vMessages[ m_unNextMessage++ ];		// remove the message from the queue
+				(*m_pCallback)( pMsg );										// send the message to the callback function to process
+				delete pMsg;												// deallocate the message (virtual destructor)
 			}
 
+			m_vMessages.clear();
+			m_unNextMessage = 0;
+
 
 			return true;
 		}
@@ -201,15 +261,20 @@ namespace SGD
 
 			
 			// Deallocate all messages in the queue
-			while( m_qMessages.empty() == false )
-			{
-				delete m_qMessages.front();
-				m_qMessages.pop();
-			}
+			ClearMessages();
+
+			// Deallocate all captured messages
+			for( unsigned int s = 0; s < m_vCaptureStreams.size(); s++ )
+				for( unsigned int i = 0; i < m_vCaptureStreams[ s ].size(); i++ )
+					delete m_vCaptureStreams[ s ][ i ];
+			m_vCaptureStreams.clear();
+			m_bCapturing = false;
 
 			// Remove the callback function
 			m_pCallback = nullptr;
 
+			s_bOwnerThread = false;
+
 
 			m_eStatus = E_DESTROYED;
 			return true;
@@ -232,9 +297,23 @@ namespace SGD
 			if( pMsg == nullptr )
 				return false;
 
+
+			// Is the calling thread capturing?
+			if( m_bCapturing == true && s_unCaptureStream < m_vCaptureStreams.size() )
+			{
+				m_vCaptureStreams[ s_unCaptureStream ].push_back( pMsg );
+				return true;
+			}
+
+			// Is it from another thread?
+			if( s_bOwnerThread == false )
+			{
+				Post( pMsg );
+				return true;
+			}
 			
 			// Queue the message
-			m_qMessages.push( pMsg );
+			m_vMessages.push_back( pMsg );
 
 
 			return true;
@@ -280,18 +359,131 @@ namespace SGD
 
 			
 			// Deallocate all messages in the queue
-			while( m_qMessages.empty() == false )
+			//	(the processed ones are already gone)
+			ReceivePosted();
+			for( unsigned int i = m_unNextMessage; i < m_vMessages.size(); i++ )
+				delete m_vMessages[ i ];
+
+			m_vMessages.clear();
+			m_unNextMessage = 0;
+
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// BEGIN CAPTURE
+		bool MessageManager::BeginCapture( unsigned int numStreams )
+		{
+			// Sanity-check the wrapper's status
+			SGD_ASSERT( m_eStatus == E_INITIALIZED, "MessageManager::BeginCapture - wrapper has not been initialized" );
+			if( m_eStatus != E_INITIALIZED )
+				return false;
+
+			SGD_ASSERT( m_bCapturing == false, "MessageManager::BeginCapture - already capturing" );
+			if( m_bCapturing == true )
+				return false;
+
+
+			// Allocate the streams up-front (jobs must not resize the vector)
+			m_vCaptureStreams.resize( numStreams );
+			m_bCapturing = true;
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// SET CAPTURE STREAM
+		bool MessageManager::SetCaptureStream( unsigned int stream )
+		{
+			// Sanity-check the parameter
+			SGD_ASSERT( stream == NO_CAPTURE_STREAM || stream < m_vCaptureStreams.size(), "MessageManager::SetCaptureStream - invalid stream" );
+			if( stream != NO_CAPTURE_STREAM && stream >= m_vCaptureStreams.size() )
+				return false;
+
+			s_unCaptureStream = stream;
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// END CAPTURE
+		bool MessageManager::EndCapture( void )
+		{
+			SGD_ASSERT( m_bCapturing == true, "MessageManager::EndCapture - not capturing" );
+			if( m_bCapturing == false )
+				return false;
+
+
+			// Merge the streams in order
+			for( unsigned int s = 0; s < m_vCaptureStreams.size(); s++ )
 			{
-				delete m_qMessages.front();
-				m_qMessages.pop();
-			}
+				MessageStream& stream = m_vCaptureStreams[ s ];
+				for( unsigned int i = 0; i < stream.size(); i++ )
+					m_vMessages.push_back( stream[ i ] );
 
+				stream.clear();		// keep the memory for the next capture
+			}
 
+			s_unCaptureStream = NO_CAPTURE_STREAM;
+			m_bCapturing = false;
 			return true;
 		}
 		//*************************************************************//
 		
 
+
+
+		//*************************************************************//
+		// POST
+		//	- lock-free unless the ring is full
+		//	- once a message overflows, the later ones queue behind it
+		//	  (not in the ring) until it is received
+		void MessageManager::Post( const Message* pMsg )
+		{
+			if( m_bOverflowed.load() == false && m_qPosted.Push( pMsg ) == true )
+				return;
+
+			std::lock_guard< std::mutex > lock( m_mtxOverflow );
+			m_vOverflow.push_back( pMsg );
+			m_bOverflowed.store( true );
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// RECEIVE POSTED
+		//	- append the posted messages to the queue
+		//	  (the ring first, then any overflow)
+		void MessageManager::ReceivePosted( void )
+		{
+			const Message* pMsg;
+			while( m_qPosted.Pop( pMsg ) == true )
+				m_vMessages.push_back( pMsg );
+
+			if( m_bOverflowed.load() == false )
+				return;
+
+			// Empty the ring again under the lock: a thread can fill it
+			// after the pass above, then overflow
+			std::lock_guard< std::mutex > lock( m_mtxOverflow );
+			while( m_qPosted.Pop( pMsg ) == true )
+				m_vMessages.push_back( pMsg );
+
+			m_vMessages.insert( m_vMessages.end(), m_vOverflow.begin(), m_vOverflow.end() );
+			m_vOverflow.clear();
+			m_bOverflowed.store( false );
+		}
+		//*************************************************************//
+		
 	}	// namespace SGD_IMPLEMENTATION
 
 }	// namespace SGD
@@ -37,11 +37,24 @@ namespace SGD
 		virtual	bool		Update					( void )				= 0;
 		virtual	bool		Terminate				( void )				= 0;
 
+		// QueueMessage is safe from any thread: messages queued by threads other than the one
+		// that called Initialize (and not capturing) are received by the next Update
 		virtual bool		QueueMessage			( const Message* pMsg )	= 0;
 		virtual bool		SendMessageNow			( const Message* pMsg )	= 0;
 
 		virtual bool		ClearMessages			( void )				= 0;
 
+
+		// Capture (for parallel jobs):
+		//	- between BeginCapture & EndCapture, messages queued by a thread that selected
+		//	  a capture stream are stored in that stream instead of the queue
+		//	- EndCapture appends the streams to the queue in stream order (deterministic)
+		enum { NO_CAPTURE_STREAM = 0xFFFFFFFF };
+
+		virtual bool		BeginCapture			( unsigned int numStreams )	= 0;
+		virtual bool		SetCaptureStream		( unsigned int stream )		= 0;	// for the calling thread only
+		virtual bool		EndCapture				( void )					= 0;
+
 		
 	protected:
 		MessageManager				( void )					= default;
@@ -0,0 +1,176 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_SpriteBatch.cpp 								|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To sort queued sprites by blend mode & texture		|
+|					and transform them in one pass						|
+|																		|
+\***********************************************************************/
+
+#include "SGD_SpriteBatch.h"
+
+// Uses std::sort for ordering the runs
+#include <algorithm>
+
+// Uses sinf & cosf for rotation
+#include <cmath>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// CONSTRUCTOR
+		SpriteBatch::SpriteBatch( void )
+		{
+			RenderStats none = { 0, 0, 0 };
+			m_Frame		= none;
+			m_LastFrame	= none;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// ADD
+		Sprite* SpriteBatch::Add( const Sprite* sprites, unsigned int count )
+		{
+			size_t first = m_vSprites.size();
+			m_vSprites.insert( m_vSprites.end(), sprites, sprites + count );
+
+			return m_vSprites.data() + first;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// CLEAR
+		//	- keep the memory for the next batch
+		void SpriteBatch::Clear( void )
+		{
+			m_vSprites.clear();
+			m_vOrder.clear();
+			m_vTransforms.clear();
+			m_vRuns.clear();
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// PREPARE
+		//	- same transform as DrawTexture:
+		//		scale, rotate around the scaled offset, translate,
+		//		then apply the base transform
+		void SpriteBatch::Prepare( const Transform& base )
+		{
+			unsigned int count = (unsigned int)m_vSprites.size();
+
+			// Sort by blend mode, then texture (same keys keep their order)
+			//	- the index breaks ties, so std::sort is stable without
+			//	  std::stable_sort's temporary buffer
+			m_vOrder.resize( count );
+			for( unsigned int i = 0; i < count; i++ )
+				m_vOrder[ i ] = i;
+
+			const std::vector< Sprite >& sprites = m_vSprites;
+			std::sort( m_vOrder.begin(), m_vOrder.end(),
+				[ &sprites ]( unsigned int a, unsigned int b )
+				{
+					if( sprites[ a ].blend != sprites[ b ].blend )
+						return sprites[ a ].blend < sprites[ b ].blend;
+					if( sprites[ a ].handle != sprites[ b ].handle )
+						return sprites[ a ].handle < sprites[ b ].handle;
+					return a < b;
+				} );
+
+
+			// Transform & split into runs
+			m_vTransforms.resize( count );
+			m_vRuns.clear();
+
+			for( unsigned int i = 0; i < count; i++ )
+			{
+				const Sprite& sprite = m_vSprites[ m_vOrder[ i ] ];
+
+				float cosine = 1.0f;
+				float sine   = 0.0f;
+				if( sprite.rotation != 0.0f )
+				{
+					cosine = cosf( sprite.rotation );
+					sine   = sinf( sprite.rotation );
+				}
+
+				// Local transform
+				float offsetX = sprite.rotationOffset.x * sprite.scale.width;
+				float offsetY = sprite.rotationOffset.y * sprite.scale.height;
+
+				float m11 =  sprite.scale.width  * cosine;
+				float m12 =  sprite.scale.width  * sine;
+				float m21 = -sprite.scale.height * sine;
+				float m22 =  sprite.scale.height * cosine;
+				float dx  = offsetX - offsetX * cosine + offsetY * sine   + sprite.position.x;
+				float dy  = offsetY - offsetX * sine   - offsetY * cosine + sprite.position.y;
+
+				// World transform
+				Transform& world = m_vTransforms[ i ];
+				world.m11 = m11 * base.m11 + m12 * base.m21;
+				world.m12 = m11 * base.m12 + m12 * base.m22;
+				world.m21 = m21 * base.m11 + m22 * base.m21;
+				world.m22 = m21 * base.m12 + m22 * base.m22;
+				world.dx  = dx  * base.m11 + dy  * base.m21 + base.dx;
+				world.dy  = dx  * base.m12 + dy  * base.m22 + base.dy;
+
+
+				// Start a new run?
+				if( i == 0
+					|| sprite.handle != GetSprite( i - 1 ).handle
+					|| sprite.blend  != GetSprite( i - 1 ).blend )
+				{
+					Run run = { i, 0 };
+					m_vRuns.push_back( run );
+				}
+
+				++m_vRuns.back().count;
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// COUNT DRAW
+		void SpriteBatch::CountDraw( HTexture texture, unsigned int sprites )
+		{
+			m_Frame.sprites += sprites;
+			++m_Frame.drawCalls;
+
+			if( texture != m_hBound )
+			{
+				++m_Frame.textureSwitches;
+				m_hBound = texture;
+			}
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// END FRAME
+		//	- the next frame starts without a bound texture
+		void SpriteBatch::EndFrame( void )
+		{
+			m_LastFrame = m_Frame;
+
+			RenderStats none = { 0, 0, 0 };
+			m_Frame		= none;
+			m_hBound	= HTexture();
+		}
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
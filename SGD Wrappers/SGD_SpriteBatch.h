@@ -0,0 +1,99 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_SpriteBatch.h 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To sort queued sprites by blend mode & texture		|
+|					and transform them in one pass						|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_SPRITEBATCH_H
+#define SGD_SPRITEBATCH_H
+
+
+// Uses Sprite, BlendMode & RenderStats
+#include "SGD_GraphicsManager.h"
+
+// Uses std::vector for storing the queued sprites
+#include <vector>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// SpriteBatch
+		//	- sprite queue shared by the GraphicsManager implementations
+		//	- Prepare sorts the queue by blend mode & texture (stable),
+		//	  computes every world transform in one pass and splits it
+		//	  into runs, which the device submits one at a time
+		//	- also counts the frame's RenderStats
+		class SpriteBatch
+		{
+		public:
+			// Transform:
+			//	- 2D affine matrix in the D3DX row-vector layout
+			//	  ( [x y 1] * M, the translation in the last row )
+			struct Transform
+			{
+				float	m11, m12;
+				float	m21, m22;
+				float	dx,  dy;
+			};
+
+			// Run:
+			//	- prepared sprites sharing a texture & blend mode
+			struct Run
+			{
+				unsigned int	first;
+				unsigned int	count;
+			};
+
+
+			SpriteBatch					( void );
+
+
+			// Queue:
+			//	- Add returns the queued copies (valid until the next Add),
+			//	  so the device can point them at its atlas pages
+			Sprite*				Add				( const Sprite* sprites, unsigned int count );
+			bool				IsEmpty			( void ) const		{	return m_vSprites.empty();	}
+			void				Clear			( void );
+
+			// Sort, transform (relative to the base) & split into runs
+			void				Prepare			( const Transform& base );
+
+			unsigned int		GetNumRuns		( void ) const						{	return (unsigned int)m_vRuns.size();		}
+			const Run&			GetRun			( unsigned int run ) const			{	return m_vRuns[ run ];						}
+			const Sprite&		GetSprite		( unsigned int index ) const		{	return m_vSprites[ m_vOrder[ index ] ];		}
+			const Transform&	GetTransform	( unsigned int index ) const		{	return m_vTransforms[ index ];				}
+
+
+			// Stats:
+			//	- CountDraw records one submission (non-texture draws
+			//	  pass an invalid handle & no sprites)
+			//	- EndFrame publishes the frame's counts
+			void				CountDraw		( HTexture texture, unsigned int sprites );
+			void				EndFrame		( void );
+			RenderStats			GetStats		( void ) const		{	return m_LastFrame;		}
+
+
+		private:
+			std::vector< Sprite >		m_vSprites;			// queued (in call order)
+			std::vector< unsigned int >	m_vOrder;			// prepared order (indices into m_vSprites)
+			std::vector< Transform >	m_vTransforms;		// world transforms (prepared order)
+			std::vector< Run >			m_vRuns;
+
+			RenderStats					m_Frame;			// counts so far
+			RenderStats					m_LastFrame;		// counts for the last frame
+			HTexture					m_hBound;			// texture of the last submission
+		};
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+#endif	//SGD_SPRITEBATCH_H
@@ -0,0 +1,256 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_TextureAtlas.cpp 								|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To pack loaded images into shared texture pages		|
+|																		|
+\***********************************************************************/
+
+#include "SGD_TextureAtlas.h"
+
+// Uses SGD_ASSERT
+#include "SGD_Utilities.h"
+
+// Uses std::min & std::max for the fit & clipping
+#include <algorithm>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// INITIALIZE
+		//	- each image takes its size plus the gutter, and the page is
+		//	  treated as one gutter larger so images can touch its edges
+		void TextureAtlas::Initialize( unsigned int pageSize, unsigned int gutter )
+		{
+			m_vPages.clear();
+			m_unPageSize	= pageSize;
+			m_unGutter		= gutter;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// CLEAR
+		void TextureAtlas::Clear( void )
+		{
+			m_vPages.clear();
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// IS EMPTY
+		bool TextureAtlas::IsEmpty( void ) const
+		{
+			for( unsigned int p = 0; p < m_vPages.size(); p++ )
+				if( m_vPages[ p ].images > 0 )
+					return false;
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// INSERT
+		bool TextureAtlas::Insert( unsigned int width, unsigned int height, Region& region )
+		{
+			if( width == 0 || height == 0 || width > m_unPageSize || height > m_unPageSize )
+				return false;
+
+			unsigned int needWidth	= width  + m_unGutter;
+			unsigned int needHeight	= height + m_unGutter;
+
+
+			// Find the tightest free area (best short side, then long side)
+			unsigned int bestPage	= (unsigned int)m_vPages.size();
+			unsigned int bestArea	= 0;
+			unsigned int bestShort	= ~0u;
+			unsigned int bestLong	= ~0u;
+
+			for( unsigned int p = 0; p < m_vPages.size(); p++ )
+			{
+				const std::vector< Area >& free = m_vPages[ p ].free;
+				for( unsigned int a = 0; a < free.size(); a++ )
+				{
+					if( free[ a ].width < needWidth || free[ a ].height < needHeight )
+						continue;
+
+					unsigned int leftoverX = free[ a ].width  - needWidth;
+					unsigned int leftoverY = free[ a ].height - needHeight;
+					unsigned int shortSide = std::min( leftoverX, leftoverY );
+					unsigned int longSide  = std::max( leftoverX, leftoverY );
+
+					if( shortSide < bestShort || ( shortSide == bestShort && longSide < bestLong ) )
+					{
+						bestPage	= p;
+						bestArea	= a;
+						bestShort	= shortSide;
+						bestLong	= longSide;
+					}
+				}
+
+				// Prefer the earliest page that fits
+				if( bestShort != ~0u )
+					break;
+			}
+
+
+			// Open a new page?
+			if( bestPage == m_vPages.size() )
+			{
+				m_vPages.push_back( Page() );
+				ResetPage( m_vPages.back() );
+				bestArea = 0;
+			}
+
+
+			// Place the image in the area's corner
+			Page& page = m_vPages[ bestPage ];
+			Area area = page.free[ bestArea ];
+			page.free.erase( page.free.begin() + bestArea );
+
+			region.page		= bestPage;
+			region.x		= area.x;
+			region.y		= area.y;
+			region.width	= width;
+			region.height	= height;
+			page.images++;
+
+
+			// Split the rest along the shorter leftover side
+			unsigned int leftoverX = area.width  - needWidth;
+			unsigned int leftoverY = area.height - needHeight;
+
+			Area right	= { area.x + needWidth, area.y, leftoverX, needHeight };
+			Area below	= { area.x, area.y + needHeight, needWidth, leftoverY };
+
+			if( leftoverX < leftoverY )
+				below.width		= area.width;		// below spans the whole area
+			else
+				right.height	= area.height;		// right spans the whole area
+
+			if( right.width > 0 && right.height > 0 )
+				page.free.push_back( right );
+			if( below.width > 0 && below.height > 0 )
+				page.free.push_back( below );
+
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// REMOVE
+		bool TextureAtlas::Remove( const Region& region )
+		{
+			SGD_ASSERT( region.page < m_vPages.size() && m_vPages[ region.page ].images > 0, "TextureAtlas::Remove - invalid region" );
+			if( region.page >= m_vPages.size() || m_vPages[ region.page ].images == 0 )
+				return false;
+
+			Page& page = m_vPages[ region.page ];
+
+			// Last image?
+			if( --page.images == 0 )
+			{
+				ResetPage( page );
+				return true;
+			}
+
+			Area area = { region.x, region.y, region.width + m_unGutter, region.height + m_unGutter };
+			page.free.push_back( area );
+			MergeFree( page );
+			return false;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// MAP SECTION
+		/*static*/ Rectangle TextureAtlas::MapSection( const Region& region, Rectangle section )
+		{
+			float width		= (float)region.width;
+			float height	= (float)region.height;
+
+			if( section.IsEmpty() == true )
+				section = Rectangle{ 0.0f, 0.0f, width, height };
+
+			section.left	= std::max( section.left,	0.0f );
+			section.top		= std::max( section.top,	0.0f );
+			section.right	= std::min( section.right,	width );
+			section.bottom	= std::min( section.bottom,	height );
+
+			section.Offset( (float)region.x, (float)region.y );
+			return section;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// RESET PAGE
+		void TextureAtlas::ResetPage( Page& page ) const
+		{
+			Area all = { 0, 0, m_unPageSize + m_unGutter, m_unPageSize + m_unGutter };
+
+			page.free.assign( 1, all );
+			page.images = 0;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// MERGE FREE
+		//	- join free areas that share a whole edge, so the space of
+		//	  removed images can hold larger ones again
+		/*static*/ void TextureAtlas::MergeFree( Page& page )
+		{
+			std::vector< Area >& free = page.free;
+
+			bool merged = true;
+			while( merged == true )
+			{
+				merged = false;
+
+				for( unsigned int a = 0; a < free.size() && merged == false; a++ )
+				{
+					for( unsigned int b = 0; b < free.size(); b++ )
+					{
+						if( a == b )
+							continue;
+
+						// b directly right of a?
+						if( free[ a ].y == free[ b ].y && free[ a ].height == free[ b ].height
+							&& free[ a ].x + free[ a ].width == free[ b ].x )
+							free[ a ].width += free[ b ].width;
+
+						// b directly below a?
+						else if( free[ a ].x == free[ b ].x && free[ a ].width == free[ b ].width
+							&& free[ a ].y + free[ a ].height == free[ b ].y )
+							free[ a ].height += free[ b ].height;
+
+						else
+							continue;
+
+						free.erase( free.begin() + b );
+						merged = true;
+						break;
+					}
+				}
+			}
+		}
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
@@ -0,0 +1,99 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_TextureAtlas.h 									|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To pack loaded images into shared texture pages		|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_TEXTUREATLAS_H
+#define SGD_TEXTUREATLAS_H
+
+
+// Uses Rectangle
+#include "SGD_Geometry.h"
+
+// Uses std::vector for storing the pages & free areas
+#include <vector>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// TextureAtlas
+		//	- rectangle packer shared by the GraphicsManager implementations
+		//	  (they own the page textures)
+		//	- guillotine packer: each image takes the free area it fits
+		//	  most tightly, and the rest is split along its shorter side
+		//	- images are kept a gutter apart, so sampling at an edge
+		//	  never reaches a neighbour
+		//	- a removed image frees its area for later ones;
+		//	  a page that empties starts over
+		class TextureAtlas
+		{
+		public:
+			// Region:
+			//	- where an image lives (in texels)
+			struct Region
+			{
+				unsigned int	page;
+				unsigned int	x, y;
+				unsigned int	width, height;
+			};
+
+
+			// Setup
+			void			Initialize		( unsigned int pageSize, unsigned int gutter = 1 );
+			void			Clear			( void );
+
+			unsigned int	GetPageSize		( void ) const		{	return m_unPageSize;						}
+			unsigned int	GetNumPages		( void ) const		{	return (unsigned int)m_vPages.size();		}
+			bool			IsEmpty			( void ) const;		// no images placed
+
+
+			// Insert:
+			//	- opens a new page when the image fits nowhere else
+			//	- false if it is larger than a page
+			bool			Insert			( unsigned int width, unsigned int height, Region& region );
+
+			// Remove:
+			//	- true if the page is now empty
+			bool			Remove			( const Region& region );
+
+
+			// Map a texture section (empty = whole image) into the page,
+			// clipped to the image
+			static	Rectangle	MapSection	( const Region& region, Rectangle section );
+
+
+		private:
+			struct Area
+			{
+				unsigned int	x, y;
+				unsigned int	width, height;
+			};
+
+			struct Page
+			{
+				std::vector< Area >		free;		// free areas (gutter included)
+				unsigned int			images;		// images placed
+			};
+
+			void			ResetPage		( Page& page ) const;
+			static	void	MergeFree		( Page& page );
+
+
+			std::vector< Page >		m_vPages;
+			unsigned int			m_unPageSize	= 0;
+			unsigned int			m_unGutter		= 1;
+		};
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+#endif	//SGD_TEXTUREATLAS_H
@@ -0,0 +1,116 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_TextureLoader.h 								|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To decode image files on a background thread		|
+|																		|
+\***********************************************************************/
+
+#ifndef SGD_TEXTURELOADER_H
+#define SGD_TEXTURELOADER_H
+
+
+// Uses HTexture & Color for the jobs
+#include "SGD_Handle.h"
+#include "SGD_Color.h"
+
+// Uses std::wstring for the file names
+#include <string>
+
+// Uses std::deque for the queues
+#include <deque>
+
+// Uses std::thread, std::mutex & std::condition_variable for the loader thread
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// TextureLoader<>
+		//	- one loader thread shared by a GraphicsManager implementation's
+		//	  LoadTextureAsync calls
+		//	- the loader thread only runs the decode function (file -> image
+		//	  in memory), the GraphicsManager turns finished jobs into
+		//	  textures on its own thread (PopFinished)
+		//	- the decode function must not touch the GraphicsManager's data
+		//	- the thread starts with the first job & stops in Stop
+		template< typename ImageType >
+		class TextureLoader
+		{
+		public:
+			// Job:
+			//	- one file to decode for the texture 'handle'
+			struct Job
+			{
+				HTexture		handle;
+				std::wstring	filename;
+				Color			colorKey;
+				bool			success;
+				ImageType		image;
+			};
+
+			// Decode function: runs on the loader thread
+			typedef bool (*DecodeFunction)( void* context, const wchar_t* filename, Color colorKey, ImageType& image );
+
+
+			TextureLoader			( void )	= default;
+			~TextureLoader			( void );
+
+
+			// Setup
+			void			Initialize		( DecodeFunction decode, void* context );
+			void			Stop			( void );		// joins the thread & drops the unstarted jobs
+
+
+			// Queue a file to decode
+			void			Queue			( HTexture handle, const wchar_t* filename, Color colorKey );
+
+			// Take a finished job (false if there is none yet)
+			bool			PopFinished		( Job& job );
+
+			// Wait up to 'milliseconds' for a finished job
+			// (false if there is none & none will come in time)
+			bool			WaitForFinished	( unsigned int milliseconds );
+
+			// Jobs queued or decoding
+			unsigned int	GetNumPending	( void ) const;
+
+
+		private:
+			TextureLoader			( const TextureLoader& )	= delete;	// Copy constructor
+			TextureLoader&	operator=	( const TextureLoader& )	= delete;	// Assignment operator
+
+
+			void			Run				( void );		// loader thread
+
+
+			DecodeFunction				m_pDecode		= nullptr;
+			void*						m_pContext		= nullptr;
+
+			std::thread					m_Thread;
+			mutable std::mutex			m_Mutex;			// guards everything below
+			std::condition_variable		m_cvQueued;			// a job was queued (or Stop)
+			std::condition_variable		m_cvFinished;		// a job was finished
+			std::deque< Job >			m_dQueued;			// waiting for the thread
+			std::deque< Job >			m_dFinished;		// waiting for PopFinished
+			unsigned int				m_unDecoding	= 0;
+			bool						m_bStopping		= false;
+		};
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+
+// Template definitions are within the .hpp
+#define	INC_SGD_TEXTURE_LOADER_HPP
+#include "SGD_TextureLoader.hpp"
+#undef	INC_SGD_TEXTURE_LOADER_HPP
+
+#endif //SGD_TEXTURELOADER_H
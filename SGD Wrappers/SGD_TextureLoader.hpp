@@ -0,0 +1,194 @@
+/***********************************************************************\
+|																		|
+|	File:			SGD_TextureLoader.hpp 								|
+|	Author:			Eva-Lotta Wahlberg									|
+|																		|
+|	Purpose:		To decode image files on a background thread		|
+|																		|
+\***********************************************************************/
+
+// This .hpp can ONLY be included from SGD_TextureLoader.h
+#ifndef INC_SGD_TEXTURE_LOADER_HPP
+#error	FILE "SGD_TextureLoader.hpp" CANNOT BE INCLUDED EXPLICITLY
+#else
+
+
+// Uses SGD_ASSERT for debug breaks
+#include "SGD_Utilities.h"
+
+// Uses std::chrono for the wait time
+#include <chrono>
+
+// Uses std::move to hand the images over without copying them
+#include <utility>
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// DESTRUCTOR
+		template< typename ImageType >
+		TextureLoader< ImageType >::~TextureLoader( void )
+		{
+			Stop();
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// INITIALIZE
+		template< typename ImageType >
+		void TextureLoader< ImageType >::Initialize( DecodeFunction decode, void* context )
+		{
+			SGD_ASSERT( m_Thread.joinable() == false, "TextureLoader::Initialize - the loader thread is running" );
+
+			m_pDecode	= decode;
+			m_pContext	= context;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// STOP
+		//	- the job being decoded is finished first, so the caller
+		//	  still gets its image back from PopFinished (to release it)
+		template< typename ImageType >
+		void TextureLoader< ImageType >::Stop( void )
+		{
+			if( m_Thread.joinable() == false )
+				return;
+
+			{
+				std::lock_guard< std::mutex > lock( m_Mutex );
+				m_bStopping = true;
+				m_dQueued.clear();
+			}
+
+			m_cvQueued.notify_one();
+			m_Thread.join();
+
+			m_bStopping = false;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// QUEUE
+		template< typename ImageType >
+		void TextureLoader< ImageType >::Queue( HTexture handle, const wchar_t* filename, Color colorKey )
+		{
+			SGD_ASSERT( m_pDecode != nullptr, "TextureLoader::Queue - loader has not been initialized" );
+
+			Job job;
+			job.handle		= handle;
+			job.filename	= filename;
+			job.colorKey	= colorKey;
+			job.success		= false;
+			job.image		= ImageType();
+
+			{
+				std::lock_guard< std::mutex > lock( m_Mutex );
+				m_dQueued.push_back( std::move( job ) );
+			}
+
+			// Start the thread with the first job
+			if( m_Thread.joinable() == false )
+				m_Thread = std::thread( &TextureLoader::Run, this );
+			else
+				m_cvQueued.notify_one();
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// POP FINISHED
+		template< typename ImageType >
+		bool TextureLoader< ImageType >::PopFinished( Job& job )
+		{
+			std::lock_guard< std::mutex > lock( m_Mutex );
+			if( m_dFinished.empty() == true )
+				return false;
+
+			job = std::move( m_dFinished.front() );
+			m_dFinished.pop_front();
+			return true;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// WAIT FOR FINISHED
+		//	- 0xFFFFFFFF waits until one is finished
+		template< typename ImageType >
+		bool TextureLoader< ImageType >::WaitForFinished( unsigned int milliseconds )
+		{
+			std::unique_lock< std::mutex > lock( m_Mutex );
+
+			// Finished, or nothing left to wait for
+			auto ready = [this]{ return m_dFinished.empty() == false || ( m_dQueued.empty() == true && m_unDecoding == 0 ); };
+
+			if( milliseconds == 0xFFFFFFFF )
+				m_cvFinished.wait( lock, ready );
+			else
+				m_cvFinished.wait_for( lock, std::chrono::milliseconds( milliseconds ), ready );
+
+			return m_dFinished.empty() == false;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// GET NUM PENDING
+		template< typename ImageType >
+		unsigned int TextureLoader< ImageType >::GetNumPending( void ) const
+		{
+			std::lock_guard< std::mutex > lock( m_Mutex );
+			return (unsigned int)m_dQueued.size() + m_unDecoding;
+		}
+		//*************************************************************//
+
+
+
+		//*************************************************************//
+		// RUN
+		//	- decode the jobs in order, outside the lock
+		template< typename ImageType >
+		void TextureLoader< ImageType >::Run( void )
+		{
+			std::unique_lock< std::mutex > lock( m_Mutex );
+
+			for( ; ; )
+			{
+				m_cvQueued.wait( lock, [this]{ return m_bStopping == true || m_dQueued.empty() == false; } );
+				if( m_bStopping == true )
+					break;
+
+				Job job = std::move( m_dQueued.front() );
+				m_dQueued.pop_front();
+				m_unDecoding++;
+
+				lock.unlock();
+				job.success = m_pDecode( m_pContext, job.filename.c_str(), job.colorKey, job.image );
+				lock.lock();
+
+				m_unDecoding--;
+				m_dFinished.push_back( std::move( job ) );
+				m_cvFinished.notify_all();
+			}
+		}
+		//*************************************************************//
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
+
+
+#endif //INC_SGD_TEXTURE_LOADER_HPP
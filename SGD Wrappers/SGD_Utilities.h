@@ -29,6 +29,16 @@
 #endif
 
 
+//*********************************************************************//
+// THREAD MACROS:
+//	- SGD_THREAD_LOCAL	- one copy of the (static) variable per thread
+#if defined( _MSC_VER ) && _MSC_VER < 1900
+	#define SGD_THREAD_LOCAL	__declspec( thread )
+#else
+	#define SGD_THREAD_LOCAL	thread_local
+#endif
+
+
 namespace SGD
 {	
 	//*****************************************************************//
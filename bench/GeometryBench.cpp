@@ -0,0 +1,251 @@
+//*********************************************************************//
+//	File:		GeometryBench.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Checks the SIMD paths of SGD::IntersectRectangles
+//				against Rectangle::IsIntersecting & reports how many
+//				rectangles each path tests per second
+//*********************************************************************//
+
+#include "../SGD Wrappers/SGD_Geometry.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace SGD::SGD_IMPLEMENTATION;
+
+
+//*********************************************************************//
+// Command line
+struct GeometryOptions
+{
+	unsigned int	seed		= 1;
+	unsigned int	count		= 1023;		// others per test (odd: the tail runs too)
+	unsigned int	tests		= 20000;	// timed one-vs-many tests per path
+	bool			checkOnly	= false;	// skip the timing (ctest)
+};
+
+static const char* s_szPaths[] = { "scalar", "sse2", "avx2" };	// by RectangleBatchPath
+
+static void PrintUsage( const char* program )
+{
+	printf( "usage: %s [--seed N] [--count N] [--tests N] [--check-only 0|1]\n"
+			"  checks every supported path against Rectangle::IsIntersecting,\n"
+			"  then times N one-vs-many tests of --count rectangles on each\n",
+			program );
+}
+
+static bool ParseOptions( int argc, char* argv[], GeometryOptions& options )
+{
+	for( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[ i ];
+		if( i + 1 >= argc )
+			return false;	// every option takes a value
+
+		const char* value = argv[ ++i ];
+		if( strcmp( arg, "--seed" ) == 0 )
+			options.seed = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--count" ) == 0 )
+			options.count = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--tests" ) == 0 )
+			options.tests = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--check-only" ) == 0 )
+			options.checkOnly = strtoul( value, nullptr, 0 ) != 0;
+		else
+			return false;
+	}
+
+	return options.count > 0 && options.tests > 0;
+}
+
+
+//*********************************************************************//
+// Random rectangles
+//	- on a coarse grid, so edges often touch exactly
+//	- some are zero-area, inverted or NaN (never intersect)
+class RectGenerator
+{
+public:
+	explicit RectGenerator( unsigned int seed ) : m_uState( seed ^ 0x9E3779B9u ) {}
+
+	unsigned int Next( unsigned int range )
+	{
+		m_uState = m_uState * 1664525u + 1013904223u;
+		return ( m_uState >> 8 ) % range;
+	}
+
+	SGD::Rectangle NextRect( void )
+	{
+		float left		= (float)Next( 32 ) * 4.0f;
+		float top		= (float)Next( 32 ) * 4.0f;
+		float width		= (float)Next( 9 ) * 4.0f;		// 0: zero width
+		float height	= (float)Next( 9 ) * 4.0f;
+
+		SGD::Rectangle rect( left, top, left + width, top + height );
+
+		switch( Next( 16 ) )
+		{
+		case 0:		// inverted
+			rect = SGD::Rectangle( rect.right, rect.bottom, rect.left, rect.top );
+			break;
+
+		case 1:		// fractional edges
+			rect.left	+= 0.5f;
+			rect.bottom	+= 0.25f;
+			break;
+
+		case 2:		// NaN edge
+			rect.right = std::numeric_limits< float >::quiet_NaN();
+			break;
+		}
+
+		return rect;
+	}
+
+private:
+	unsigned int m_uState;
+};
+
+
+//*********************************************************************//
+// Reference
+//	- the hits IntersectRectangles must find
+static unsigned int ReferenceHits( const SGD::Rectangle& rect, const SGD::Rectangle* others, unsigned int count, unsigned int* hits )
+{
+	unsigned int numHits = 0;
+	for( unsigned int i = 0; i < count; i++ )
+		if( rect.IsIntersecting( others[ i ] ) == true )
+			hits[ numHits++ ] = i;
+
+	return numHits;
+}
+
+
+//*********************************************************************//
+// CheckPath
+//	- every count from 0 to 67 (each tail length after the
+//	  8- & 4-wide blocks), from several offsets into the array
+//	- the rect is drawn from the same grid, so it often shares
+//	  edges with (or equals) the others
+//	- returns the number of mismatching tests
+static unsigned int CheckPath( RectangleBatchPath path, unsigned int seed )
+{
+	RectGenerator random( seed );
+
+	std::vector< SGD::Rectangle > others( 128 );
+	std::vector< unsigned int > expected( 128 ), hits( 128 );
+
+	unsigned int failures = 0;
+	unsigned int tests = 0;
+
+	for( unsigned int round = 0; round < 200; round++ )
+	{
+		for( unsigned int i = 0; i < others.size(); i++ )
+			others[ i ] = random.NextRect();
+
+		for( unsigned int count = 0; count <= 67; count++ )
+		{
+			unsigned int first = random.Next( (unsigned int)others.size() - count + 1 );
+
+			SGD::Rectangle rect = ( count > 0 && random.Next( 4 ) == 0 )
+				? others[ first + random.Next( count ) ]		// identical to one of them
+				: random.NextRect();
+
+			unsigned int numExpected = ReferenceHits( rect, &others[ first ], count, expected.data() );
+			unsigned int numHits = IntersectRectangles( path, rect, &others[ first ], count, hits.data() );
+			++tests;
+
+			if( numHits != numExpected || memcmp( hits.data(), expected.data(), numHits * sizeof( unsigned int ) ) != 0 )
+			{
+				if( failures++ < 5 )
+					printf( "  %s: %u hits instead of %u (count %u, rect %g %g %g %g)\n",
+							s_szPaths[ path ], numHits, numExpected, count, rect.left, rect.top, rect.right, rect.bottom );
+			}
+		}
+	}
+
+	printf( "check %-6s  %u tests, %u failed\n", s_szPaths[ path ], tests, failures );
+	return failures;
+}
+
+
+//*********************************************************************//
+// TimePath
+//	- returns the rectangles tested per second
+static double TimePath( RectangleBatchPath path, const GeometryOptions& options, unsigned long long& totalHits )
+{
+	RectGenerator random( options.seed );
+
+	std::vector< SGD::Rectangle > others( options.count );
+	for( unsigned int i = 0; i < others.size(); i++ )
+		others[ i ] = random.NextRect();
+
+	std::vector< SGD::Rectangle > rects( 64 );
+	for( unsigned int i = 0; i < rects.size(); i++ )
+		rects[ i ] = random.NextRect();
+
+	std::vector< unsigned int > hits( options.count );
+
+	totalHits = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for( unsigned int t = 0; t < options.tests; t++ )
+		totalHits += IntersectRectangles( path, rects[ t % rects.size() ], others.data(), options.count, hits.data() );
+
+	std::chrono::duration< double > seconds = std::chrono::steady_clock::now() - start;
+	return (double)options.tests * options.count / seconds.count();
+}
+
+
+//*********************************************************************//
+// main
+int main( int argc, char* argv[] )
+{
+	GeometryOptions options;
+	if( ParseOptions( argc, argv, options ) == false )
+	{
+		PrintUsage( argv[ 0 ] );
+		return 1;
+	}
+
+
+	// Every path must match the scalar test exactly
+	unsigned int failures = 0;
+	for( int path = RECT_BATCH_SCALAR; path <= RECT_BATCH_AVX2; path++ )
+	{
+		if( IsRectangleBatchSupported( (RectangleBatchPath)path ) == false )
+			printf( "check %-6s  not supported\n", s_szPaths[ path ] );
+		else
+			failures += CheckPath( (RectangleBatchPath)path, options.seed );
+	}
+
+	if( failures > 0 || options.checkOnly == true )
+		return failures > 0 ? 1 : 0;
+
+
+	// Timing
+	printf( "\n%u tests of %u rectangles (IntersectRectangles uses %s)\n",
+			options.tests, options.count, s_szPaths[ GetRectangleBatchPath() ] );
+	printf( "path        Mrects/s   speedup       hits\n" );
+
+	double scalar = 0.0;
+	for( int path = RECT_BATCH_SCALAR; path <= RECT_BATCH_AVX2; path++ )
+	{
+		if( IsRectangleBatchSupported( (RectangleBatchPath)path ) == false )
+			continue;
+
+		unsigned long long totalHits;
+		double rate = TimePath( (RectangleBatchPath)path, options, totalHits );
+		if( path == RECT_BATCH_SCALAR )
+			scalar = rate;
+
+		printf( "%-10s %9.1f %8.2fx %10llu\n", s_szPaths[ path ], rate / 1e6, rate / scalar, totalHits );
+	}
+
+	return 0;
+}
@@ -0,0 +1,751 @@
+//*********************************************************************//
+//	File:		HeadlessBench.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Runs the GameplayState on the null backends for a
+//				number of frames & reports how long they took
+//				(built as software_bench, it also renders them)
+//*********************************************************************//
+
+#include "NullBackends.h"
+#if defined( SGD_SOFTWARE_GRAPHICS )
+#include "SoftwareGraphics.h"
+#endif
+#include "../SGD Wrappers/SGD_AssetArchive.h"
+#include "../SGD Wrappers/SGD_FrameArena.h"
+#include "../SGD Wrappers/SGD_Event.h"
+#include "../SGD Wrappers/SGD_EventManager.h"
+#include "../SGD Wrappers/SGD_IListener.h"
+#include "../SGD Wrappers/SGD_Message.h"
+#include "../SGD Wrappers/SGD_MessageManager.h"
+
+#include "../source/Game.h"
+#include "../source/GameplayState.h"
+#include "../source/EntityManager.h"
+#include "../source/Entity.h"
+#include "../source/JobSystem.h"
+#include "../source/MessageID.h"
+#include "../source/Profiler.h"
+#include "../source/Projectile.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+//*********************************************************************//
+// Allocation counters
+//	- every global new / delete in the process (any thread)
+static std::atomic< unsigned long long >	s_ullAllocations( 0 );
+static std::atomic< unsigned long long >	s_ullFrees( 0 );
+static std::atomic< unsigned long long >	s_ullBytes( 0 );
+
+void* operator new( size_t size )
+{
+	++s_ullAllocations;
+	s_ullBytes += size;
+
+	void* p = malloc( size != 0 ? size : 1 );
+	if( p == nullptr )
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[]( size_t size )
+{
+	return operator new( size );
+}
+
+void operator delete( void* p ) throw()
+{
+	if( p == nullptr )
+		return;
+
+	++s_ullFrees;
+	free( p );
+}
+
+void operator delete[]( void* p ) throw()
+{
+	operator delete( p );
+}
+
+// nothrow forms (the standard library's temporary buffers) must pair with the above
+void* operator new( size_t size, const std::nothrow_t& ) throw()
+{
+	++s_ullAllocations;
+	s_ullBytes += size;
+
+	return malloc( size != 0 ? size : 1 );
+}
+
+void* operator new[]( size_t size, const std::nothrow_t& nothrow ) throw()
+{
+	return operator new( size, nothrow );
+}
+
+void operator delete( void* p, const std::nothrow_t& ) throw()
+{
+	operator delete( p );
+}
+
+void operator delete[]( void* p, const std::nothrow_t& ) throw()
+{
+	operator delete( p );
+}
+
+
+//*********************************************************************//
+// Command line
+struct BenchOptions
+{
+	unsigned int	frames		= 1200;		// 10 simulated seconds
+	unsigned int	seed		= 1;
+	unsigned int	threads		= 0;		// 0 = one per extra core
+	unsigned int	projectiles	= 0;		// extra projectiles spawned up-front
+	const char*		script		= nullptr;	// generated from the seed if none
+	unsigned int	producers	= 0;		// > 0 runs the queue contention test instead
+	unsigned int	posts		= 100000;	// events & messages per producer
+	const char*		screenshot	= nullptr;	// last frame as .ppm (software_bench)
+	const char*		archive		= nullptr;	// asset archive to read from (pack_assets)
+	int				collision	= -1;		// enemy / projectile EntityManager::CollisionMode (-1 = the game's)
+	unsigned int	scaling		= 0;		// > 0 runs the parallel update scaling test on this many entities
+};
+
+static const char* s_szCollisionModes[] = { "brute", "hash", "sap" };	// by EntityManager::CollisionMode
+
+static void PrintUsage( const char* program )
+{
+	printf( "usage: %s [--frames N] [--seed N] [--threads N] [--projectiles N] [--collision brute|hash|sap] [--script FILE] [--screenshot FILE] [--archive FILE]\n"
+			"       %s --producers N [--posts N]\n"
+			"       %s --scaling N [--frames N] [--seed N]\n"
+			"  runs the GameplayState for N frames (one %.4f s step each)\n"
+			"  script lines are \"<step> <key> down|up\"\n"
+			"  --screenshot: saves the last frame as a .ppm (software_bench only)\n"
+			"  --archive: loads the assets from a pack_assets archive\n"
+			"  --collision: broad phase of the enemy / projectile pairs\n"
+			"  --producers: N threads each queue --posts events & messages\n"
+			"  while the main thread updates the managers, checking each\n"
+			"  thread's posts arrive in order\n"
+			"  --posts: events & messages per producer (default 100000)\n"
+			"  --scaling: updates N synthetic entities on 1, 2, 4 & 8 threads\n"
+			"  & checks every thread count gives the same result\n",
+			program, program, program, Game::GetFixedTimestep() );
+}
+
+static bool ParseOptions( int argc, char* argv[], BenchOptions& options )
+{
+	for( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[ i ];
+		if( i + 1 >= argc )
+			return false;	// every option takes a value
+
+		const char* value = argv[ ++i ];
+		if( strcmp( arg, "--frames" ) == 0 )
+			options.frames = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--seed" ) == 0 )
+			options.seed = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--threads" ) == 0 )
+			options.threads = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--projectiles" ) == 0 )
+			options.projectiles = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--script" ) == 0 )
+			options.script = value;
+		else if( strcmp( arg, "--producers" ) == 0 )
+			options.producers = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--posts" ) == 0 )
+			options.posts = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--screenshot" ) == 0 )
+			options.screenshot = value;
+		else if( strcmp( arg, "--archive" ) == 0 )
+			options.archive = value;
+		else if( strcmp( arg, "--scaling" ) == 0 )
+			options.scaling = (unsigned int)strtoul( value, nullptr, 0 );
+		else if( strcmp( arg, "--collision" ) == 0 )
+		{
+			for( int mode = EntityManager::COLLISION_BRUTE_FORCE; mode <= EntityManager::COLLISION_SWEEP_AND_PRUNE; mode++ )
+				if( strcmp( value, s_szCollisionModes[ mode ] ) == 0 )
+					options.collision = mode;
+
+			if( options.collision < 0 )
+				return false;
+		}
+		else
+			return false;
+	}
+
+	return true;
+}
+
+
+//*********************************************************************//
+// GameplayEntities
+//	- the EntityManager of the running GameplayState (nullptr in the menus)
+static EntityManager* GameplayEntities( void )
+{
+	GameplayState* pGameplay = dynamic_cast< GameplayState* >( Game::GetInstance()->GetCurrentState() );
+	return ( pGameplay != nullptr ) ? pGameplay->GetEntityManager() : nullptr;
+}
+
+
+//*********************************************************************//
+// SpawnProjectiles
+//	- fill the band below the enemy formation with slow projectiles,
+//	  so they are updated & collision tested without ending the level
+static void SpawnProjectiles( unsigned int count, unsigned int seed )
+{
+	EntityManager* pEntities = GameplayState::GetInstance()->GetEntityManager();
+	SGD::Size screen = Game::GetInstance()->GetScreenSize();
+
+	// Own generator, so the game's rand() sequence is untouched
+	unsigned int state = seed ^ 0x9E3779B9u;
+
+	for( unsigned int i = 0; i < count; i++ )
+	{
+		float r[ 3 ];
+		for( unsigned int k = 0; k < 3; k++ )
+		{
+			state = state * 1664525u + 1013904223u;
+			r[ k ] = ( state >> 8 ) / 16777216.0f;	// [0, 1)
+		}
+
+		Projectile* projectile = new Projectile;
+		projectile->SetImage( GameplayState::GetInstance()->GetEnemyImg() );
+		projectile->SetSize( SGD::Size{ 8, 8 } );
+		projectile->SetPosition( SGD::Point{ r[ 0 ] * screen.width, screen.height * 0.8f + r[ 1 ] * ( screen.height * 0.2f - 8 ) } );
+		projectile->SetVelocity( SGD::Vector{ ( r[ 2 ] - 0.5f ) * 60.0f, 0 } );
+
+		pEntities->AddEntity( projectile, 2 );
+		projectile->Release();
+	}
+}
+
+
+//*********************************************************************//
+// Queue contention
+//	- producer threads queue events & messages as fast as they can,
+//	  the main thread keeps updating the managers until all arrive
+//	- each producer's posts must arrive in the order it queued them,
+//	  even when the post rings overflow
+static const SGD::EventID			s_BenchEvent( "BENCH_POST" );
+static unsigned long long			s_ullMessagesReceived = 0;
+
+// Producer & sequence number of a post
+struct PostStamp
+{
+	unsigned int	producer;
+	unsigned int	sequence;
+};
+
+class StampedEvent : public SGD::Event
+{
+public:
+	StampedEvent( const PostStamp& stamp ) : SGD::Event( s_BenchEvent ), m_Stamp( stamp ) {}
+	const PostStamp&	GetStamp	( void ) const		{	return m_Stamp;	}
+
+private:
+	PostStamp	m_Stamp;
+};
+
+class StampedMessage : public SGD::Message
+{
+public:
+	StampedMessage( const PostStamp& stamp ) : SGD::Message( MessageID::MSG_DESTROY_ENTITY ), m_Stamp( stamp ) {}
+	const PostStamp&	GetStamp	( void ) const		{	return m_Stamp;	}
+
+private:
+	PostStamp	m_Stamp;
+};
+
+// Next sequence number expected from each producer
+class PostOrder
+{
+public:
+	unsigned long long	outOfOrder	= 0;
+
+	void Resize( unsigned int producers )		{	m_vNext.assign( producers, 0 );	}
+	void Check( const PostStamp& stamp )
+	{
+		if( stamp.producer >= m_vNext.size() )
+		{
+			++outOfOrder;
+			return;
+		}
+
+		if( stamp.sequence != m_vNext[ stamp.producer ] )
+			++outOfOrder;
+		m_vNext[ stamp.producer ] = stamp.sequence + 1;
+	}
+
+private:
+	std::vector< unsigned int >	m_vNext;
+};
+
+static PostOrder					s_MessageOrder;
+
+class PostCounter : public SGD::IListener
+{
+public:
+	unsigned long long	received	= 0;
+	PostOrder			order;
+
+	virtual void		HandleEvent	( const SGD::Event* pEvent ) override
+	{
+		++received;
+		order.Check( static_cast< const StampedEvent* >( pEvent )->GetStamp() );
+	}
+};
+
+static void CountMessage( const SGD::Message* pMsg )
+{
+	++s_ullMessagesReceived;
+	if( pMsg->GetMessageID() == MessageID::MSG_DESTROY_ENTITY )
+		s_MessageOrder.Check( static_cast< const StampedMessage* >( pMsg )->GetStamp() );
+}
+
+static int RunContention( const BenchOptions& options )
+{
+	// Create the singletons before the producers can
+	SGD::FrameArena::GetInstance();
+	Profiler::GetInstance();
+
+	SGD::EventManager*		pEvents		= SGD::EventManager::GetInstance();
+	SGD::MessageManager*	pMessages	= SGD::MessageManager::GetInstance();
+	pEvents->Initialize();
+	pMessages->Initialize( &CountMessage );
+
+	int result = 0;
+	{
+		PostCounter counter;
+		counter.RegisterForEvent( s_BenchEvent );
+		counter.order.Resize( options.producers );
+		s_MessageOrder.Resize( options.producers );
+
+		unsigned long long expected = (unsigned long long)options.producers * options.posts;
+		unsigned int updates = 0;
+
+		long long start = Profiler::GetTicks();
+
+		std::vector< std::thread > producers;
+		for( unsigned int t = 0; t < options.producers; t++ )
+			producers.push_back( std::thread( [&options, t]()
+			{
+				for( unsigned int i = 0; i < options.posts; i++ )
+				{
+					PostStamp stamp = { t, i };
+					( new StampedEvent( stamp ) )->QueueEvent();
+					( new StampedMessage( stamp ) )->QueueMessage();
+				}
+			} ) );
+
+		while( counter.received < expected || s_ullMessagesReceived < expected )
+		{
+			SGD::FrameArena::GetInstance()->NextFrame();
+			pEvents->Update();
+			pMessages->Update();
+			++updates;
+		}
+
+		long long end = Profiler::GetTicks();
+
+		for( unsigned int t = 0; t < producers.size(); t++ )
+			producers[ t ].join();
+
+
+		// Report
+		double seconds = (double)( end - start ) / (double)Profiler::GetInstance()->GetFrequency();
+
+		printf( "producers      %u x %u events & messages\n", options.producers, options.posts );
+		printf( "time           %.3f s (%u updates)\n", seconds, updates );
+		printf( "posts/s        %.0f\n", expected * 2 / seconds );
+		printf( "received       %llu events, %llu messages\n", counter.received, s_ullMessagesReceived );
+		printf( "out of order   %llu events, %llu messages\n", counter.order.outOfOrder, s_MessageOrder.outOfOrder );
+		printf( "frame arena    %u misses (heap fallbacks)\n", SGD::FrameArena::GetInstance()->GetMisses() );
+
+		if( counter.received != expected || s_ullMessagesReceived != expected )
+			result = 1;
+		if( counter.order.outOfOrder != 0 || s_MessageOrder.outOfOrder != 0 )
+			result = 1;
+	}
+
+	pMessages->Terminate();
+	pEvents->Terminate();
+	SGD::MessageManager::DeleteInstance();
+	SGD::EventManager::DeleteInstance();
+	SGD::FrameArena::DeleteInstance();
+	Profiler::DeleteInstance();
+	return result;
+}
+
+
+//*********************************************************************//
+// Parallel update scaling
+//	- a synthetic scene (no GameplayState) in one parallel bucket:
+//	  entities wander across a field & queue an event on every bounce
+//	- the same scene is updated on 1, 2, 4 & 8 threads; the final
+//	  transforms & the order the events arrive in must match
+static const SGD::EventID			s_ScalingBounce( "BENCH_BOUNCE" );
+static const float					SCALING_FIELD	= 4096.0f;		// square field size
+
+class ScalingEntity : public Entity
+{
+public:
+	ScalingEntity( unsigned int id, float turnRate ) : m_unId( id ), m_fTurnRate( turnRate ) {}
+
+	unsigned int	GetId	( void ) const		{	return m_unId;	}
+
+	virtual void	Update	( float elapsedTime ) override
+	{
+		// Wander: turn by a smooth pseudo-random amount
+		m_fPhase += elapsedTime * m_fTurnRate;
+
+		float turn = 0.0f;
+		for( unsigned int k = 1; k <= 8; k++ )
+			turn += sinf( m_fPhase * k + m_unId ) / k;
+
+		SGD::Vector velocity = GetVelocity();
+		velocity.Rotate( turn * elapsedTime );
+
+		// Bounce off the edges of the field
+		SGD::Point position = GetPosition();
+		bool bounced = false;
+		if( ( position.x < 0 && velocity.x < 0 ) || ( position.x >= SCALING_FIELD && velocity.x > 0 ) )
+		{
+			velocity.x	= -velocity.x;
+			bounced		= true;
+		}
+		if( ( position.y < 0 && velocity.y < 0 ) || ( position.y >= SCALING_FIELD && velocity.y > 0 ) )
+		{
+			velocity.y	= -velocity.y;
+			bounced		= true;
+		}
+
+		SetVelocity( velocity );
+		if( bounced == true )
+			( new SGD::Event( s_ScalingBounce, nullptr, this ) )->QueueEvent();
+
+		Entity::Update( elapsedTime );
+	}
+
+private:
+	unsigned int	m_unId;
+	float			m_fTurnRate;
+	float			m_fPhase	= 0.0f;
+};
+
+class BounceCounter : public SGD::IListener
+{
+public:
+	unsigned long long	received	= 0;
+	unsigned int		hash		= 2166136261u;		// FNV-1a of the senders' ids, in arrival order
+
+	virtual void		HandleEvent	( const SGD::Event* pEvent ) override
+	{
+		++received;
+		hash = ( hash ^ reinterpret_cast< const ScalingEntity* >( pEvent->GetSender() )->GetId() ) * 16777619u;
+	}
+};
+
+static unsigned int HashBits( unsigned int hash, float value )
+{
+	unsigned int bits;
+	memcpy( &bits, &value, sizeof( bits ) );
+	return ( hash ^ bits ) * 16777619u;
+}
+
+static int RunScaling( const BenchOptions& options )
+{
+	// Create the singletons before the workers can
+	SGD::FrameArena::GetInstance();
+	Profiler::GetInstance();
+
+	SGD::EventManager*		pEvents		= SGD::EventManager::GetInstance();
+	SGD::MessageManager*	pMessages	= SGD::MessageManager::GetInstance();
+	pEvents->Initialize();
+	pMessages->Initialize( &CountMessage );
+
+	const unsigned int	threadCounts[]	= { 1, 2, 4, 8 };
+	const float			step			= Game::GetFixedTimestep();
+
+	printf( "scaling        %u entities x %u updates (seed %u, %u hardware threads)\n",
+			options.scaling, options.frames, options.seed, std::thread::hardware_concurrency() );
+	printf( "threads    update ms   speedup     bounces      result\n" );
+
+	int result = 0;
+	double baseline = 0.0;
+	unsigned int baselineHash = 0;
+
+	for( unsigned int t = 0; t < sizeof( threadCounts ) / sizeof( threadCounts[ 0 ] ); t++ )
+	{
+		JobSystem::GetInstance()->Initialize( threadCounts[ t ] );
+
+		BounceCounter counter;
+		counter.RegisterForEvent( s_ScalingBounce );
+
+		// The same scene every time
+		EntityManager* pEntities = new EntityManager;
+		pEntities->SetParallelUpdate( 0, true );
+
+		std::vector< ScalingEntity* > scene;		// the manager keeps them alive
+		scene.reserve( options.scaling );
+
+		unsigned int state = options.seed ^ 0x9E3779B9u;
+		for( unsigned int i = 0; i < options.scaling; i++ )
+		{
+			float r[ 4 ];
+			for( unsigned int k = 0; k < 4; k++ )
+			{
+				state = state * 1664525u + 1013904223u;
+				r[ k ] = ( state >> 8 ) / 16777216.0f;	// [0, 1)
+			}
+
+			ScalingEntity* pEntity = new ScalingEntity( i, 0.5f + r[ 3 ] * 2.0f );
+			pEntity->SetSize( SGD::Size{ 8, 8 } );
+			pEntity->SetPosition( SGD::Point{ r[ 0 ] * SCALING_FIELD, r[ 1 ] * SCALING_FIELD } );
+			pEntity->SetVelocity( SGD::Vector{ 200.0f, 0 }.ComputeRotated( r[ 2 ] * 2.0f * SGD::PI ) );
+
+			pEntities->AddEntity( pEntity, 0 );
+			pEntity->Release();
+			scene.push_back( pEntity );
+		}
+
+		// Time the updates only
+		long long ticks = 0;
+		for( unsigned int frame = 0; frame < options.frames; frame++ )
+		{
+			long long start = Profiler::GetTicks();
+			pEntities->UpdateAll( step );
+			ticks += Profiler::GetTicks() - start;
+
+			pEvents->Update();
+			SGD::FrameArena::GetInstance()->NextFrame();
+		}
+
+		// Final transforms, in creation order
+		unsigned int hash = counter.hash;
+		for( unsigned int i = 0; i < scene.size(); i++ )
+		{
+			hash = HashBits( hash, scene[ i ]->GetPosition().x );
+			hash = HashBits( hash, scene[ i ]->GetPosition().y );
+			hash = HashBits( hash, scene[ i ]->GetVelocity().x );
+			hash = HashBits( hash, scene[ i ]->GetVelocity().y );
+		}
+
+		pEntities->RemoveAll();
+		delete pEntities;
+		counter.UnregisterFromEvent( s_ScalingBounce );
+		JobSystem::GetInstance()->Terminate();
+
+
+		// Report
+		double ms = (double)ticks * 1000.0 / (double)Profiler::GetInstance()->GetFrequency() / options.frames;
+		if( t == 0 )
+		{
+			baseline		= ms;
+			baselineHash	= hash;
+		}
+
+		bool same = hash == baselineHash;
+		if( same == false )
+			result = 1;
+
+		printf( "%7u %12.3f %8.2fx %11llu    %08x%s\n", threadCounts[ t ], ms, baseline / ms,
+				counter.received, hash, same ? "" : " MISMATCH" );
+	}
+
+	printf( "result         %s\n", ( result == 0 ) ? "same on every thread count" : "DIFFERS between thread counts" );
+
+	pMessages->Terminate();
+	pEvents->Terminate();
+	JobSystem::DeleteInstance();
+	SGD::MessageManager::DeleteInstance();
+	SGD::EventManager::DeleteInstance();
+	SGD::FrameArena::DeleteInstance();
+	Profiler::DeleteInstance();
+	return result;
+}
+
+
+//*********************************************************************//
+// main
+//	- the game runs exactly as it would in the window, except the
+//	  frames are driven by the fixed timestep instead of the clock
+int main( int argc, char* argv[] )
+{
+	BenchOptions options;
+	if( ParseOptions( argc, argv, options ) == false )
+	{
+		PrintUsage( argv[ 0 ] );
+		return 1;
+	}
+
+	if( options.producers != 0 )
+		return RunContention( options );
+
+	if( options.scaling != 0 )
+		return RunScaling( options );
+
+
+	// Mount the archive first (the game keeps it)
+	if( options.archive != nullptr )
+	{
+		std::string name = options.archive;
+		if( SGD::MountArchive( std::wstring( name.begin(), name.end() ).c_str() ) == false )
+		{
+			fprintf( stderr, "could not mount the asset archive '%s'\n", options.archive );
+			return 1;
+		}
+	}
+
+
+	// Initialize on the null backends
+	Game* pGame = Game::GetInstance();
+	if( pGame->Initialize() == false )
+	{
+		fprintf( stderr, "Game::Initialize failed\n" );
+		return 1;
+	}
+
+	if( options.threads != 0 )
+	{
+		JobSystem::GetInstance()->Terminate();
+		JobSystem::GetInstance()->Initialize( options.threads );
+	}
+
+	SGD::SGD_IMPLEMENTATION::InputManager* pInput = SGD::SGD_IMPLEMENTATION::InputManager::GetInstance();
+	if( options.script != nullptr )
+	{
+		if( pInput->LoadScript( options.script ) == false )
+		{
+			fprintf( stderr, "could not load the input script '%s'\n", options.script );
+			pGame->Terminate();
+			Game::DeleteInstance();
+			return 1;
+		}
+	}
+	else
+		pInput->GenerateScript( options.seed, options.frames );
+
+
+	// Replace the clock seed & skip the intro
+	srand( options.seed );
+	pGame->ChangeState( GameplayState::GetInstance() );
+	SpawnProjectiles( options.projectiles, options.seed );
+
+
+	// Run the frames
+	unsigned long long allocations	= s_ullAllocations;
+	unsigned long long frees		= s_ullFrees;
+	unsigned long long bytes		= s_ullBytes;
+	unsigned long long sprites		= 0;
+	unsigned long long drawCalls	= 0;
+	unsigned long long switches		= 0;
+	unsigned long long pairTests	= 0;
+	unsigned long long collisions	= 0;
+	unsigned int collisionFrames	= 0;
+	int collisionMode				= options.collision;
+#if defined( SGD_SOFTWARE_GRAPHICS )
+	unsigned long long pixelsDrawn	= SGD::SGD_IMPLEMENTATION::GraphicsManager::GetInstance()->GetPixelsDrawn();
+#endif
+
+	long long start = Profiler::GetTicks();
+
+	unsigned int frames = 0;
+	while( frames < options.frames )
+	{
+		++frames;
+
+		// Override the enemy / projectile broad phase (again after a restart)
+		EntityManager* pEntities = GameplayEntities();
+		if( pEntities != nullptr && options.collision >= 0 )
+			pEntities->SetCollisionMode( 1, 2, (EntityManager::CollisionMode)options.collision );
+
+		if( pGame->RunFrame( Game::GetFixedTimestep() ) != 0 )
+			break;	// the game asked to quit
+
+		// Collision tests of the step (during gameplay)
+		pEntities = GameplayEntities();
+		if( pEntities != nullptr )
+		{
+			pairTests		+= pEntities->GetPairTests();
+			collisions		+= pEntities->GetCollisions();
+			collisionMode	= pEntities->GetCollisionMode( 1, 2 );
+			++collisionFrames;
+		}
+
+		// Stats of the frame presented by this one
+		SGD::RenderStats stats = SGD::GraphicsManager::GetInstance()->GetRenderStats();
+		sprites		+= stats.sprites;
+		drawCalls	+= stats.drawCalls;
+		switches	+= stats.textureSwitches;
+	}
+
+	long long end = Profiler::GetTicks();
+
+	allocations	= s_ullAllocations - allocations;
+	frees		= s_ullFrees - frees;
+	bytes		= s_ullBytes - bytes;
+
+
+	// Report
+	Profiler* pProfiler = Profiler::GetInstance();
+	double seconds = (double)( end - start ) / (double)pProfiler->GetFrequency();
+
+	printf( "frames         %u (seed %u, %u worker threads)\n", frames, options.seed, JobSystem::GetInstance()->GetNumThreads() );
+	printf( "time           %.3f s\n", seconds );
+	printf( "frames/s       %.1f\n", frames / seconds );
+	printf( "ms/frame       %.3f\n", seconds * 1000.0 / frames );
+	printf( "\n" );
+
+	printf( "zone (last %u frames)                 avg ms    p95 ms\n", frames < 256 ? frames : 256 );
+	for( unsigned int z = 0; z < pProfiler->GetNumZones(); z++ )
+	{
+		// Depth-first: each zone under its parent
+		unsigned int depth = pProfiler->GetZoneDepth( z );
+		printf( "%*s%-*s %9.4f %9.4f\n", depth * 2, "", 36 - depth * 2, pProfiler->GetZoneName( z ),
+				pProfiler->GetAverage( z ), pProfiler->GetPercentile( z, 95.0f ) );
+	}
+	printf( "\n" );
+
+	printf( "allocations    %llu (%.1f/frame, %llu bytes)\n", allocations, (double)allocations / frames, bytes );
+	printf( "frees          %llu\n", frees );
+	printf( "sprites        %llu (%.1f/frame)\n", sprites, (double)sprites / frames );
+	printf( "draw calls     %llu (%.1f/frame)\n", drawCalls, (double)drawCalls / frames );
+	printf( "tex switches   %llu (%.1f/frame)\n", switches, (double)switches / frames );
+	if( collisionFrames > 0 )
+		printf( "pair tests     %llu (%.1f/frame, %s), %llu hits\n", pairTests, (double)pairTests / collisionFrames,
+				s_szCollisionModes[ collisionMode ], collisions );
+	printf( "frame arena    %u misses (heap fallbacks)\n", SGD::FrameArena::GetInstance()->GetMisses() );
+	if( SGD::SGD_IMPLEMENTATION::GetMountedArchive() != nullptr )
+		printf( "archive        %u files mapped\n", SGD::SGD_IMPLEMENTATION::GetMountedArchive()->GetNumEntries() );
+	printf( "projectiles    pool capacity %u, high water %u, misses %u\n",
+			Projectile::GetPool().GetCapacity(), Projectile::GetPool().GetHighWater(), Projectile::GetPool().GetMisses() );
+
+#if defined( SGD_SOFTWARE_GRAPHICS )
+	// Rasterizer throughput & the last frame
+	SGD::SGD_IMPLEMENTATION::GraphicsManager* pGraphics = SGD::SGD_IMPLEMENTATION::GraphicsManager::GetInstance();
+	double pixels = (double)( pGraphics->GetPixelsDrawn() - pixelsDrawn );
+
+	printf( "pixels         %.0f (%.1f Mpixels/s of run time)\n", pixels, pixels / seconds / 1e6 );
+	printf( "frame          %ux%u, checksum %08x\n", pGraphics->GetFrameWidth(), pGraphics->GetFrameHeight(), pGraphics->GetChecksum() );
+
+	if( options.screenshot != nullptr && pGraphics->SaveFrame( options.screenshot ) == false )
+		fprintf( stderr, "could not save the screenshot '%s'\n", options.screenshot );
+#else
+	if( options.screenshot != nullptr )
+		fprintf( stderr, "--screenshot needs the software renderer (software_bench)\n" );
+#endif
+
+
+	// Cleanup
+	pGame->Terminate();
+	Game::DeleteInstance();
+	return 0;
+}
@@ -0,0 +1,701 @@
+//*********************************************************************//
+//	File:		NullBackends.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Null Graphics, Audio & Input managers for running
+//				the game without a window, GPU or audio device
+//*********************************************************************//
+
+#include "NullBackends.h"
+#include "PngDecoder.h"
+
+#include "../SGD Wrappers/SGD_Utilities.h"
+#include "../SGD Wrappers/SGD_AssetArchive.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+
+namespace SGD
+{
+	//*****************************************************************//
+	// Interface singletons
+	//	- forward to the null implementations
+#if !defined( SGD_SOFTWARE_GRAPHICS )
+	/*static*/ GraphicsManager* GraphicsManager::GetInstance( void )
+	{
+		return SGD_IMPLEMENTATION::GraphicsManager::GetInstance();
+	}
+
+	/*static*/ void GraphicsManager::DeleteInstance( void )
+	{
+		SGD_IMPLEMENTATION::GraphicsManager::DeleteInstance();
+	}
+#endif
+
+	/*static*/ AudioManager* AudioManager::GetInstance( void )
+	{
+		return SGD_IMPLEMENTATION::AudioManager::GetInstance();
+	}
+
+	/*static*/ void AudioManager::DeleteInstance( void )
+	{
+		SGD_IMPLEMENTATION::AudioManager::DeleteInstance();
+	}
+
+	/*static*/ InputManager* InputManager::GetInstance( void )
+	{
+		return SGD_IMPLEMENTATION::InputManager::GetInstance();
+	}
+
+	/*static*/ void InputManager::DeleteInstance( void )
+	{
+		SGD_IMPLEMENTATION::InputManager::DeleteInstance();
+	}
+
+
+	//*****************************************************************//
+	// Utilities
+	//	- no Output window or message boxes, so use stderr
+	void Alert( const char* message )
+	{
+		fprintf( stderr, "%s\n", message );
+	}
+
+	void Alert( const wchar_t* message )
+	{
+		fprintf( stderr, "%ls\n", message );
+	}
+
+	void Assert( bool expression, const char* message )
+	{
+		if( expression == false )
+		{
+			Alert( message );
+			abort();
+		}
+	}
+
+	void Assert( bool expression, const wchar_t* message )
+	{
+		if( expression == false )
+		{
+			Alert( message );
+			abort();
+		}
+	}
+
+	void Print( const char* message )
+	{
+		fprintf( stderr, "%s", message );
+	}
+
+	void Print( const wchar_t* message )
+	{
+		fprintf( stderr, "%ls", message );
+	}
+
+
+	namespace SGD_IMPLEMENTATION
+	{
+#if !defined( SGD_SOFTWARE_GRAPHICS )
+		//*************************************************************//
+		// GraphicsManager
+		/*static*/ GraphicsManager* GraphicsManager::s_pInstance = nullptr;
+
+		/*static*/ GraphicsManager* GraphicsManager::GetInstance( void )
+		{
+			if( s_pInstance == nullptr )
+				s_pInstance = new GraphicsManager;
+
+			return s_pInstance;
+		}
+
+		/*static*/ void GraphicsManager::DeleteInstance( void )
+		{
+			delete s_pInstance;
+			s_pInstance = nullptr;
+		}
+
+		bool GraphicsManager::Update( void )
+		{
+			SGD_ASSERT( m_bBatching == false, "GraphicsManager::Update - EndBatch was not called" );
+			if( m_bBatching == true )
+				EndBatch();
+
+			m_Batch.EndFrame();
+			return true;
+		}
+
+		bool GraphicsManager::Terminate( void )
+		{
+			m_HandleManager.Clear();
+			m_Index.Clear();
+			m_Batch.Clear();
+			m_bBatching = false;
+
+			m_Atlas.Clear();
+			m_vPages.clear();
+			m_bAtlas = false;
+			return true;
+		}
+
+		HTexture GraphicsManager::LoadTexture( const wchar_t* filename, Color colorKey )
+		{
+			SGD_ASSERT( filename != nullptr, "GraphicsManager::LoadTexture - invalid filename" );
+			if( filename == nullptr )
+				return HTexture();
+
+			// Already loaded?
+			HTexture handle = m_Index.Find( filename );
+			if( handle != INVALID_HANDLE )
+			{
+				m_HandleManager.GetData( handle )->refCount++;
+				return handle;
+			}
+
+			TextureInfo data;
+			data.filename	= filename;
+			data.refCount	= 1;
+
+			if( m_bAtlas == true )
+				PlaceInAtlas( data );
+
+			handle = m_HandleManager.StoreData( data );
+			m_Index.Insert( filename, handle );
+			return handle;
+		}
+
+		HTexture GraphicsManager::LoadTexture( const char* filename, Color colorKey )
+		{
+			SGD_ASSERT( filename != nullptr, "GraphicsManager::LoadTexture - invalid filename" );
+			if( filename == nullptr )
+				return HTexture();
+
+			std::string name = filename;
+			return LoadTexture( std::wstring( name.begin(), name.end() ).c_str(), colorKey );
+		}
+
+		bool GraphicsManager::DrawTexture( HTexture handle, Point position, float rotation, Vector rotationOffset, Color color, Size scale )
+		{
+			if( m_HandleManager.GetData( handle ) == nullptr )
+				return false;
+
+			Sprite sprite;
+			sprite.handle			= handle;
+			sprite.position			= position;
+			sprite.rotation			= rotation;
+			sprite.rotationOffset	= rotationOffset;
+			sprite.color			= color;
+			sprite.scale			= scale;
+
+			return DrawSprites( &sprite, 1 );
+		}
+
+		bool GraphicsManager::DrawTextureSection( HTexture handle, Point position, Rectangle section, float rotation, Vector rotationOffset, Color color, Size scale )
+		{
+			if( m_HandleManager.GetData( handle ) == nullptr )
+				return false;
+
+			Sprite sprite;
+			sprite.handle			= handle;
+			sprite.position			= position;
+			sprite.section			= section;
+			sprite.rotation			= rotation;
+			sprite.rotationOffset	= rotationOffset;
+			sprite.color			= color;
+			sprite.scale			= scale;
+
+			return DrawSprites( &sprite, 1 );
+		}
+
+		bool GraphicsManager::UnloadTexture( HTexture& handle )
+		{
+			// Quietly ignore bad handles
+			if( handle == INVALID_HANDLE )
+				return false;
+
+			TextureInfo* data = m_HandleManager.GetData( handle );
+			if( data == nullptr )
+				return false;
+
+			// Is this the last reference?
+			if( --data->refCount == 0 )
+			{
+				TextureInfo last;
+				m_HandleManager.RemoveData( handle, &last );
+				m_Index.Remove( last.filename.c_str() );
+
+				// Give back the atlas area (& the page once it is empty)
+				if( last.page != INVALID_HANDLE && m_Atlas.Remove( last.region ) == true )
+				{
+					m_HandleManager.RemoveData( last.page, nullptr );
+					m_vPages[ last.region.page ] = HTexture();
+				}
+			}
+
+			handle = HTexture();
+			return true;
+		}
+
+		bool GraphicsManager::BeginBatch( void )
+		{
+			SGD_ASSERT( m_bBatching == false, "GraphicsManager::BeginBatch - already batching" );
+			if( m_bBatching == true )
+				return false;
+
+			m_bBatching = true;
+			return true;
+		}
+
+		bool GraphicsManager::EndBatch( void )
+		{
+			SGD_ASSERT( m_bBatching == true, "GraphicsManager::EndBatch - not batching" );
+			if( m_bBatching == false )
+				return false;
+
+			m_bBatching = false;
+			return SubmitBatch();
+		}
+
+		bool GraphicsManager::DrawSprites( const Sprite* sprites, unsigned int count )
+		{
+			SGD_ASSERT( sprites != nullptr || count == 0, "GraphicsManager::DrawSprites - sprites cannot be null" );
+			if( sprites == nullptr )
+				return false;
+
+			MapToAtlas( m_Batch.Add( sprites, count ), count );
+
+			if( m_bBatching == false )
+				return SubmitBatch();
+
+			return true;
+		}
+
+		bool GraphicsManager::SubmitBatch( void )
+		{
+			if( m_Batch.IsEmpty() == true )
+				return true;
+
+			// Still transform them, so the timing matches the Direct3D implementation
+			SpriteBatch::Transform identity = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+			m_Batch.Prepare( identity );
+
+			bool success = true;
+			for( unsigned int r = 0; r < m_Batch.GetNumRuns(); r++ )
+			{
+				const SpriteBatch::Run& run = m_Batch.GetRun( r );
+				const Sprite& first = m_Batch.GetSprite( run.first );
+
+				if( m_HandleManager.GetData( first.handle ) == nullptr )
+				{
+					success = false;
+					continue;
+				}
+
+				m_Batch.CountDraw( first.handle, run.count );
+			}
+
+			m_Batch.Clear();
+			return success;
+		}
+
+		bool GraphicsManager::SubmitUntextured( void )
+		{
+			// Keep the order with the queued sprites
+			if( m_bBatching == true )
+				SubmitBatch();
+
+			m_Batch.CountDraw( HTexture(), 0 );
+			return true;
+		}
+
+		bool GraphicsManager::SetAtlasMode( bool atlas, unsigned int pageSize )
+		{
+			if( atlas == false )
+			{
+				m_bAtlas = false;
+				return true;
+			}
+
+			SGD_ASSERT( pageSize > 0, "GraphicsManager::SetAtlasMode - invalid page size" );
+			if( pageSize == 0 )
+				return false;
+
+			if( pageSize != m_Atlas.GetPageSize() )
+			{
+				SGD_ASSERT( m_Atlas.IsEmpty() == true, "GraphicsManager::SetAtlasMode - cannot change the page size while pages are in use" );
+				if( m_Atlas.IsEmpty() == false )
+					return false;
+
+				m_Atlas.Initialize( pageSize );
+				m_vPages.clear();
+			}
+
+			m_bAtlas = true;
+			return true;
+		}
+
+		bool GraphicsManager::PlaceInAtlas( TextureInfo& data )
+		{
+			// Read the size from the PNG header
+			// (in the mounted archive, or the file: the paths are ASCII)
+			const unsigned char*			archived	= nullptr;
+			size_t							size		= 0;
+			std::vector< unsigned char >	buffer;
+			ArchivedFile					archive;
+
+			unsigned char header[ 24 ];
+			size_t read = 0;
+
+			if( archive.Read( data.filename.c_str(), archived, size, buffer ) == true )
+			{
+				read = std::min( size, sizeof( header ) );
+				memcpy( header, archived, read );
+			}
+			else
+			{
+				std::string name( data.filename.begin(), data.filename.end() );
+
+				FILE* pFile = fopen( name.c_str(), "rb" );
+				if( pFile != nullptr )
+				{
+					read = fread( header, 1, sizeof( header ), pFile );
+					fclose( pFile );
+				}
+			}
+
+			unsigned int width, height;
+			TextureAtlas::Region region;
+			if( ReadPngSize( header, read, width, height ) == false
+				|| m_Atlas.Insert( width, height, region ) == false )
+				return false;
+
+			// Open the page?
+			if( region.page >= m_vPages.size() )
+				m_vPages.resize( region.page + 1 );
+
+			if( m_vPages[ region.page ] == INVALID_HANDLE )
+			{
+				TextureInfo page;
+				page.refCount = 1;
+				m_vPages[ region.page ] = m_HandleManager.StoreData( page );
+			}
+
+			data.page	= m_vPages[ region.page ];
+			data.region	= region;
+			return true;
+		}
+
+		void GraphicsManager::MapToAtlas( Sprite* sprites, unsigned int count )
+		{
+			for( unsigned int i = 0; i < count; i++ )
+			{
+				const TextureInfo* data = m_HandleManager.GetData( sprites[ i ].handle );
+				if( data == nullptr || data->page == INVALID_HANDLE )
+					continue;
+
+				sprites[ i ].section	= TextureAtlas::MapSection( data->region, sprites[ i ].section );
+				sprites[ i ].handle		= data->page;
+			}
+		}
+#endif
+
+
+		//*************************************************************//
+		// AudioManager
+		/*static*/ AudioManager* AudioManager::s_pInstance = nullptr;
+
+		/*static*/ AudioManager* AudioManager::GetInstance( void )
+		{
+			if( s_pInstance == nullptr )
+				s_pInstance = new AudioManager;
+
+			return s_pInstance;
+		}
+
+		/*static*/ void AudioManager::DeleteInstance( void )
+		{
+			delete s_pInstance;
+			s_pInstance = nullptr;
+		}
+
+		bool AudioManager::Terminate( void )
+		{
+			m_HandleManager.Clear();
+			m_Index.Clear();
+			return true;
+		}
+
+		HAudio AudioManager::LoadAudio( const wchar_t* filename )
+		{
+			SGD_ASSERT( filename != nullptr, "AudioManager::LoadAudio - invalid filename" );
+			if( filename == nullptr )
+				return HAudio();
+
+			// Already loaded?
+			HAudio handle = m_Index.Find( filename );
+			if( handle != INVALID_HANDLE )
+			{
+				m_HandleManager.GetData( handle )->refCount++;
+				return handle;
+			}
+
+			AudioInfo data;
+			data.filename	= filename;
+			data.refCount	= 1;
+
+			handle = m_HandleManager.StoreData( data );
+			m_Index.Insert( filename, handle );
+			return handle;
+		}
+
+		HAudio AudioManager::LoadAudio( const char* filename )
+		{
+			SGD_ASSERT( filename != nullptr, "AudioManager::LoadAudio - invalid filename" );
+			if( filename == nullptr )
+				return HAudio();
+
+			std::string name = filename;
+			return LoadAudio( std::wstring( name.begin(), name.end() ).c_str() );
+		}
+
+		HVoice AudioManager::PlayAudio( HAudio handle, bool looping )
+		{
+			++m_unPlayCalls;
+			return HVoice();	// never plays
+		}
+
+		bool AudioManager::UnloadAudio( HAudio& handle )
+		{
+			// Quietly ignore bad handles
+			if( handle == INVALID_HANDLE )
+				return false;
+
+			AudioInfo* data = m_HandleManager.GetData( handle );
+			if( data == nullptr )
+				return false;
+
+			// Is this the last reference?
+			if( --data->refCount == 0 )
+			{
+				m_Index.Remove( data->filename.c_str() );
+				m_HandleManager.RemoveData( handle, nullptr );
+			}
+
+			handle = HAudio();
+			return true;
+		}
+
+		bool AudioManager::StopVoice( HVoice& handle )
+		{
+			handle = HVoice();
+			return false;
+		}
+
+
+		//*************************************************************//
+		// InputManager
+		/*static*/ InputManager* InputManager::s_pInstance = nullptr;
+
+		/*static*/ InputManager* InputManager::GetInstance( void )
+		{
+			if( s_pInstance == nullptr )
+				s_pInstance = new InputManager;
+
+			return s_pInstance;
+		}
+
+		/*static*/ void InputManager::DeleteInstance( void )
+		{
+			delete s_pInstance;
+			s_pInstance = nullptr;
+		}
+
+		bool InputManager::Initialize( void )
+		{
+			std::fill( m_aCurrent, m_aCurrent + NUM_KEYS, false );
+			std::fill( m_aPrevious, m_aPrevious + NUM_KEYS, false );
+			m_unNextEvent	= 0;
+			m_unStep		= 0;
+			return true;
+		}
+
+		//	- apply the script's events for this step
+		bool InputManager::Update( void )
+		{
+			std::copy( m_aCurrent, m_aCurrent + NUM_KEYS, m_aPrevious );
+
+			while( m_unNextEvent < m_vScript.size() && m_vScript[ m_unNextEvent ].step <= m_unStep )
+			{
+				const KeyEvent& e = m_vScript[ m_unNextEvent++ ];
+				m_aCurrent[ e.key ] = e.down;
+			}
+
+			++m_unStep;
+			return true;
+		}
+
+		bool InputManager::IsKeyPressed( Key key ) const
+		{
+			unsigned int k = (unsigned int)key % NUM_KEYS;
+			return m_aCurrent[ k ] == true && m_aPrevious[ k ] == false;
+		}
+
+		bool InputManager::IsKeyDown( Key key ) const
+		{
+			return m_aCurrent[ (unsigned int)key % NUM_KEYS ];
+		}
+
+		bool InputManager::IsKeyUp( Key key ) const
+		{
+			return m_aCurrent[ (unsigned int)key % NUM_KEYS ] == false;
+		}
+
+		bool InputManager::IsKeyReleased( Key key ) const
+		{
+			unsigned int k = (unsigned int)key % NUM_KEYS;
+			return m_aCurrent[ k ] == false && m_aPrevious[ k ] == true;
+		}
+
+		Key InputManager::GetAnyKeyPressed( void ) const
+		{
+			for( unsigned int k = 1; k < NUM_KEYS; k++ )
+				if( m_aCurrent[ k ] == true && m_aPrevious[ k ] == false )
+					return (Key)k;
+
+			return Key::None;
+		}
+
+		Key InputManager::GetAnyKeyDown( void ) const
+		{
+			for( unsigned int k = 1; k < NUM_KEYS; k++ )
+				if( m_aCurrent[ k ] == true )
+					return (Key)k;
+
+			return Key::None;
+		}
+
+
+		//*************************************************************//
+		// Script key names
+		struct KeyName
+		{
+			const char*		name;
+			Key				key;
+		};
+
+		static const KeyName s_aKeyNames[] =
+		{
+			{ "Space",	Key::Space	},
+			{ "Escape",	Key::Escape	},
+			{ "Enter",	Key::Enter	},
+			{ "Alt",	Key::Alt	},
+			{ "Up",		Key::Up		},
+			{ "Down",	Key::Down	},
+			{ "Left",	Key::Left	},
+			{ "Right",	Key::Right	},
+			{ "F3",		Key::F3		},
+			{ "F4",		Key::F4		},
+		};
+
+		// ParseKey
+		//	- name, single letter / digit, or key code
+		static bool ParseKey( const std::string& text, Key& key )
+		{
+			for( unsigned int i = 0; i < sizeof( s_aKeyNames ) / sizeof( s_aKeyNames[ 0 ] ); i++ )
+				if( text == s_aKeyNames[ i ].name )
+				{
+					key = s_aKeyNames[ i ].key;
+					return true;
+				}
+
+			if( text.size() == 1 && isalnum( (unsigned char)text[ 0 ] ) != 0 )
+			{
+				key = (Key)toupper( (unsigned char)text[ 0 ] );	// virtual-key codes match ASCII
+				return true;
+			}
+
+			char* end = nullptr;
+			unsigned long code = strtoul( text.c_str(), &end, 0 );
+			if( text.empty() == true || *end != '\0' || code == 0 || code > 0xFF )
+				return false;
+
+			key = (Key)code;
+			return true;
+		}
+
+		bool InputManager::LoadScript( const char* filename )
+		{
+			std::ifstream fin( filename );
+			if( fin.is_open() == false )
+				return false;
+
+			std::string line;
+			unsigned int lineNumber = 0;
+			while( std::getline( fin, line ) )
+			{
+				++lineNumber;
+
+				// Strip comments
+				std::string::size_type comment = line.find( '#' );
+				if( comment != std::string::npos )
+					line.erase( comment );
+
+				std::istringstream words( line );
+				unsigned int step;
+				std::string name, action;
+				if( !( words >> step ) )
+					continue;	// blank line
+
+				Key key;
+				if( !( words >> name >> action ) || ParseKey( name, key ) == false
+					|| ( action != "down" && action != "up" ) )
+				{
+					fprintf( stderr, "%s(%u): expected \"<step> <key> down|up\"\n", filename, lineNumber );
+					return false;
+				}
+
+				AddKeyEvent( step, key, action == "down" );
+			}
+
+			return true;
+		}
+
+		void InputManager::GenerateScript( unsigned int seed, unsigned int steps )
+		{
+			// Own generator, so the game's rand() sequence is untouched
+			unsigned int state = seed * 2654435761u + 1;
+
+			AddKeyEvent( 0, Key::Space, true );
+
+			static const Key s_aMoves[] = { Key::W, Key::A, Key::S, Key::D };
+			for( unsigned int step = 0; step < steps; )
+			{
+				state = state * 1664525u + 1013904223u;
+				Key move = s_aMoves[ ( state >> 16 ) % 4 ];
+				unsigned int hold = 15 + ( state >> 8 ) % 90;
+
+				AddKeyEvent( step, move, true );
+				AddKeyEvent( step + hold, move, false );
+				step += hold + 1;
+			}
+		}
+
+		void InputManager::AddKeyEvent( unsigned int step, Key key, bool down )
+		{
+			KeyEvent e = { step, (unsigned int)key % NUM_KEYS, down };
+
+			// Keep the script sorted (stable for the same step)
+			std::vector< KeyEvent >::iterator at = std::upper_bound( m_vScript.begin(), m_vScript.end(), e,
+				[]( const KeyEvent& a, const KeyEvent& b ) { return a.step < b.step; } );
+			m_vScript.insert( at, e );
+		}
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
@@ -0,0 +1,277 @@
+//*********************************************************************//
+//	File:		NullBackends.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Null Graphics, Audio & Input managers for running
+//				the game without a window, GPU or audio device
+//				(SGD_SOFTWARE_GRAPHICS replaces the null graphics
+//				with the software renderer)
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_GraphicsManager.h"
+#include "../SGD Wrappers/SGD_AudioManager.h"
+#include "../SGD Wrappers/SGD_InputManager.h"
+#include "../SGD Wrappers/SGD_HandleManager.h"
+#include "../SGD Wrappers/SGD_AssetIndex.h"
+#include "../SGD Wrappers/SGD_SpriteBatch.h"
+#include "../SGD Wrappers/SGD_TextureAtlas.h"
+
+#include <string>		// std::wstring type
+#include <vector>		// std::vector type
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+#if !defined( SGD_SOFTWARE_GRAPHICS )
+		//*************************************************************//
+		// GraphicsManager (null)
+		//	- textures are only names behind handles (shared &
+		//	  reference counted, like the Direct3D implementation)
+		//	- in atlas mode, PNG headers are read so the textures can
+		//	  be packed into (empty) pages
+		//	- every draw call is counted (batches by run, like the
+		//	  Direct3D implementation), nothing is drawn
+		//	- LoadTextureAsync loads at once (there is nothing to decode),
+		//	  so the counts do not depend on thread timing
+		//	- SINGLETON (replaces the Direct3D implementation)
+		class GraphicsManager : public SGD::GraphicsManager
+		{
+		public:
+			static	GraphicsManager*	GetInstance		( void );
+			static	void				DeleteInstance	( void );
+
+
+			virtual	bool		Initialize			( bool vsync = true )	override					{	return true;	}
+			virtual	bool		Initialize			( const wchar_t* title, Size size = {1024,768}, bool vsync = true )	override	{	return true;	}
+			virtual	bool		Update				( void )				override;
+			virtual	bool		Terminate			( void )				override;
+
+			virtual bool		SetClearColor		( Color color = {0,0,0} )				override	{	return true;	}
+			virtual bool		SetPixelatedMode	( bool pixelated = true )				override	{	return true;	}
+			virtual bool		ShowCursor			( bool show = true )					override	{	return true;	}
+			virtual bool		ShowConsoleWindow	( bool show = true )					override	{	return true;	}
+			virtual bool		Resize				( Size size, bool windowed = true )		override	{	return true;	}
+			virtual bool		IsForegroundWindow	( void )								override	{	return true;	}
+
+			virtual bool		DrawString			( const wchar_t* text, Point position,  Color color = {} )										override	{	return SubmitUntextured();	}
+			virtual bool		DrawString			( const char* text, Point position,  Color color = {} )											override	{	return SubmitUntextured();	}
+			virtual bool		DrawLine			( Point position1, Point position2, Color color = {}, unsigned int lineWidth = 3 )				override	{	return SubmitUntextured();	}
+			virtual bool		DrawRectangle		( Rectangle rect, Color fillColor, Color lineColor = {0,0,0,0}, unsigned int lineWidth = 3 )	override	{	return SubmitUntextured();	}
+
+			virtual	HTexture	LoadTexture			( const wchar_t* filename, Color colorKey = {0,0,0,0} )		override;
+			virtual	HTexture	LoadTexture			( const char* filename, Color colorKey = {0,0,0,0} )		override;
+			virtual	bool		DrawTexture			( HTexture handle, Point position, float rotation = 0.0f, Vector rotationOffset = {}, Color color = {}, Size scale = {1.0f, 1.0f} )						override;
+			virtual	bool		DrawTextureSection	( HTexture handle, Point position, Rectangle section, float rotation = 0.0f, Vector rotationOffset = {}, Color color = {}, Size scale = {1.0f, 1.0f} )	override;
+			virtual	bool		UnloadTexture		( HTexture& handle )										override;
+
+			virtual	bool		BeginBatch			( void )										override;
+			virtual	bool		EndBatch			( void )										override;
+			virtual	bool		DrawSprites			( const Sprite* sprites, unsigned int count )	override;
+
+			virtual	RenderStats	GetRenderStats		( void ) const									override	{	return m_Batch.GetStats();	}
+
+			virtual	bool		SetAtlasMode		( bool atlas = true, unsigned int pageSize = 2048 )	override;
+
+			virtual	HTexture	LoadTextureAsync	( const wchar_t* filename, Color colorKey = {0,0,0,0} )		override	{	return LoadTexture( filename, colorKey );		}
+			virtual	HTexture	LoadTextureAsync	( const char* filename, Color colorKey = {0,0,0,0} )		override	{	return LoadTexture( filename, colorKey );		}
+			virtual	bool		IsTextureLoaded		( HTexture handle )											override	{	return m_HandleManager.IsHandleValid( handle );	}
+			virtual	unsigned int	WaitForTextures	( const HTexture* handles, unsigned int count, unsigned int milliseconds = 0xFFFFFFFF )	override	{	return count;	}
+
+		private:
+			GraphicsManager		( void )						= default;
+			virtual	~GraphicsManager( void )					= default;
+
+			GraphicsManager		( const GraphicsManager& )		= delete;
+			GraphicsManager&	operator= ( const GraphicsManager& )	= delete;
+
+			static	GraphicsManager*	s_pInstance;
+
+			// Texture data
+			struct TextureInfo
+			{
+				std::wstring				filename;	// empty for atlas pages
+				unsigned int				refCount;
+				HTexture					page;		// atlas page (invalid when on its own)
+				TextureAtlas::Region		region;		// area in the atlas page
+			};
+
+			bool	SubmitBatch			( void );
+			bool	SubmitUntextured	( void );		// DrawString, DrawLine & DrawRectangle
+
+			bool	PlaceInAtlas		( TextureInfo& data );
+			void	MapToAtlas			( Sprite* sprites, unsigned int count );
+
+			HandleManager< TextureInfo >	m_HandleManager;
+			AssetIndex< HTexture >			m_Index;				// texture handles by file name
+			SpriteBatch						m_Batch;				// queued sprites & frame stats
+			bool							m_bBatching		= false;
+
+			TextureAtlas					m_Atlas;				// areas of the atlas pages
+			std::vector< HTexture >			m_vPages;				// atlas pages (invalid when empty)
+			bool							m_bAtlas		= false;
+		};
+#endif
+
+
+		//*************************************************************//
+		// AudioManager (null)
+		//	- audio files are only names behind handles (shared &
+		//	  reference counted, like the XAudio2 implementation)
+		//	- nothing ever plays
+		//	- SINGLETON (replaces the XAudio2 implementation)
+		class AudioManager : public SGD::AudioManager
+		{
+		public:
+			static	AudioManager*	GetInstance		( void );
+			static	void			DeleteInstance	( void );
+
+
+			virtual	bool		Initialize			( void )	override					{	return true;	}
+			virtual	bool		Update				( void )	override					{	return true;	}
+			virtual	bool		Terminate			( void )	override;
+
+			virtual int			GetMasterVolume		( AudioGroup group )						override	{	return 100;		}
+			virtual bool		SetMasterVolume		( AudioGroup group, int value = 100 )		override	{	return true;	}
+
+			virtual	HAudio		LoadAudio			( const wchar_t* filename )					override;
+			virtual	HAudio		LoadAudio			( const char* filename )					override;
+			virtual	HVoice		PlayAudio			( HAudio handle, bool looping = false )		override;
+			virtual bool		IsAudioPlaying		( HAudio handle )							override	{	return false;	}
+			virtual	bool		StopAudio			( HAudio handle )							override	{	return true;	}
+			virtual	bool		UnloadAudio			( HAudio& handle )							override;
+
+			virtual bool		IsVoiceValid		( HVoice handle )							override	{	return false;	}
+			virtual bool		IsVoicePlaying		( HVoice handle )							override	{	return false;	}
+			virtual bool		PauseVoice			( HVoice handle, bool pause = true )		override	{	return false;	}
+			virtual bool		StopVoice			( HVoice& handle )							override;
+
+			virtual int			GetVoiceVolume		( HVoice handle )							override	{	return 0;		}
+			virtual bool		SetVoiceVolume		( HVoice handle, int value = 100 )			override	{	return false;	}
+			virtual int			GetAudioVolume		( HAudio handle )							override	{	return 100;		}
+			virtual bool		SetAudioVolume		( HAudio handle, int value = 100 )			override	{	return true;	}
+
+
+			// PlayAudio calls since the start
+			unsigned long long	GetPlayCalls		( void ) const		{	return m_unPlayCalls;	}
+
+		private:
+			AudioManager		( void )						= default;
+			virtual	~AudioManager( void )						= default;
+
+			AudioManager		( const AudioManager& )			= delete;
+			AudioManager&		operator= ( const AudioManager& )	= delete;
+
+			static	AudioManager*	s_pInstance;
+
+			// Audio data
+			struct AudioInfo
+			{
+				std::wstring				filename;
+				unsigned int				refCount;
+			};
+
+			HandleManager< AudioInfo >		m_HandleManager;
+			AssetIndex< HAudio >			m_Index;				// audio handles by file name
+			unsigned long long				m_unPlayCalls	= 0;
+		};
+
+
+		//*************************************************************//
+		// InputManager (null)
+		//	- replays a script of key presses & releases, one
+		//	  Update per simulation step
+		//	- no cursor, mouse wheel or controllers
+		//	- SINGLETON (replaces the DirectInput implementation)
+		class InputManager : public SGD::InputManager
+		{
+		public:
+			static	InputManager*	GetInstance		( void );
+			static	void			DeleteInstance	( void );
+
+
+			virtual	bool		Initialize			( void )			override;
+			virtual	bool		Update				( void )			override;
+			virtual	bool		Terminate			( void )			override	{	return true;	}
+
+			virtual bool		IsKeyPressed		( Key key )			const	override;
+			virtual bool		IsKeyDown			( Key key )			const	override;
+			virtual bool		IsKeyUp				( Key key )			const	override;
+			virtual bool		IsKeyReleased		( Key key )			const	override;
+
+			virtual bool		IsAnyKeyPressed		( void )			const	override	{	return GetAnyKeyPressed() != Key::None;	}
+			virtual Key			GetAnyKeyPressed	( void )			const	override;
+			virtual wchar_t		GetAnyCharPressed	( void )			const	override	{	return L'\0';	}
+			virtual bool		IsAnyKeyDown		( void )			const	override	{	return GetAnyKeyDown() != Key::None;	}
+			virtual Key			GetAnyKeyDown		( void )			const	override;
+			virtual wchar_t		GetAnyCharDown		( void )			const	override	{	return L'\0';	}
+
+			virtual const wchar_t*	GetKeyName		( Key key )			const	override	{	return L"";		}
+
+			virtual Point		GetCursorPosition		( void )			const	override	{	return Point{};	}
+			virtual bool		SetCursorPosition		( Point position )			override	{	return true;	}
+			virtual Vector		GetCursorMovement		( void )			const	override	{	return Vector{};	}
+			virtual Vector		GetMouseWheelMovement	( void )			const	override	{	return Vector{};	}
+
+			virtual unsigned int	GetControllerFlags	( void )											const	override	{	return 0;		}
+			virtual bool		IsControllerConnected	( unsigned int controller )							const	override	{	return false;	}
+			virtual const wchar_t*	GetControllerName	( unsigned int controller )							const	override	{	return L"";		}
+
+			virtual Vector		GetLeftJoystick			( unsigned int controller )							const	override	{	return Vector{};	}
+			virtual Vector		GetRightJoystick		( unsigned int controller )							const	override	{	return Vector{};	}
+			virtual float		GetTrigger				( unsigned int controller )							const	override	{	return 0.0f;	}
+
+			virtual DPad		GetDPad					( unsigned int controller )							const	override	{	return DPad::Neutral;	}
+			virtual bool		IsDPadPressed			( unsigned int controller, DPad direction )			const	override	{	return false;	}
+			virtual bool		IsDPadDown				( unsigned int controller, DPad direction )			const	override	{	return false;	}
+			virtual bool		IsDPadUp				( unsigned int controller, DPad direction )			const	override	{	return true;	}
+			virtual bool		IsDPadReleased			( unsigned int controller, DPad direction )			const	override	{	return false;	}
+
+			virtual bool		IsButtonPressed			( unsigned int controller, unsigned int button )	const	override	{	return false;	}
+			virtual bool		IsButtonDown			( unsigned int controller, unsigned int button )	const	override	{	return false;	}
+			virtual bool		IsButtonUp				( unsigned int controller, unsigned int button )	const	override	{	return true;	}
+			virtual bool		IsButtonReleased		( unsigned int controller, unsigned int button )	const	override	{	return false;	}
+
+
+			//*********************************************************//
+			// Script:
+			//	- each line is "<step> <key> down|up" ('#' starts a comment)
+			//	- keys are names (W, Space, Escape, Up ...) or key codes
+			//	- GenerateScript makes a repeatable one from the seed:
+			//	  fire constantly & wander between the movement keys
+			bool	LoadScript		( const char* filename );
+			void	GenerateScript	( unsigned int seed, unsigned int steps );
+			void	AddKeyEvent		( unsigned int step, Key key, bool down );
+
+		private:
+			InputManager		( void )						= default;
+			virtual	~InputManager( void )						= default;
+
+			InputManager		( const InputManager& )			= delete;
+			InputManager&		operator= ( const InputManager& )	= delete;
+
+			static	InputManager*	s_pInstance;
+
+			enum { NUM_KEYS = 256 };
+
+			struct KeyEvent
+			{
+				unsigned int	step;
+				unsigned int	key;
+				bool			down;
+			};
+
+			std::vector< KeyEvent >	m_vScript;					// sorted by step
+			unsigned int			m_unNextEvent	= 0;
+			unsigned int			m_unStep		= 0;		// Updates so far
+
+			bool					m_aCurrent[ NUM_KEYS ];
+			bool					m_aPrevious[ NUM_KEYS ];
+		};
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
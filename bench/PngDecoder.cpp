@@ -0,0 +1,533 @@
+//*********************************************************************//
+//	File:		PngDecoder.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Decodes PNG images for the software renderer
+//				(no D3DX or zlib on the bench hosts)
+//*********************************************************************//
+
+#include "PngDecoder.h"
+
+#include <cstdlib>		// abs
+#include <cstring>		// memcmp
+
+
+namespace
+{
+	//*****************************************************************//
+	// Inflater
+	//	- zlib stream decompressor (RFC 1950 / 1951)
+	//	- canonical Huffman codes are decoded a bit at a time
+	//	  (only used at load time)
+	class Inflater
+	{
+	public:
+		Inflater( const unsigned char* data, size_t size )
+			: m_pData( data ), m_uSize( size )	{	}
+
+		bool	Inflate		( std::vector< unsigned char >& out );
+
+	private:
+		enum { MAX_BITS = 15, MAX_LENGTHS = 288, MAX_DISTANCES = 30 };
+
+		struct Huffman
+		{
+			short	count[ MAX_BITS + 1 ];		// codes per length
+			short	symbol[ MAX_LENGTHS ];		// symbols in code order
+		};
+
+		unsigned int	GetBits		( int need );
+		int				Decode		( const Huffman& huffman );
+		bool			Build		( Huffman& huffman, const short* lengths, int count );
+
+		bool			Stored		( std::vector< unsigned char >& out );
+		bool			Fixed		( std::vector< unsigned char >& out );
+		bool			Dynamic		( std::vector< unsigned char >& out );
+		bool			Codes		( std::vector< unsigned char >& out, const Huffman& lengths, const Huffman& distances );
+
+		const unsigned char*	m_pData;
+		size_t					m_uSize;
+		size_t					m_uPos			= 0;
+		unsigned long			m_ulBitBuffer	= 0;
+		int						m_nBitCount		= 0;
+		bool					m_bError		= false;		// ran past the end
+	};
+
+
+	//*****************************************************************//
+	// Length & distance tables
+	const short LENGTH_BASE[ 29 ]	= {	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+										35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const short LENGTH_EXTRA[ 29 ]	= {	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+										3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const short DIST_BASE[ 30 ]		= {	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+										257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+										8193, 12289, 16385, 24577 };
+	const short DIST_EXTRA[ 30 ]	= {	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+										7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+
+	//*****************************************************************//
+	// GetBits
+	//	- least-significant bit first
+	unsigned int Inflater::GetBits( int need )
+	{
+		unsigned long value = m_ulBitBuffer;
+		while( m_nBitCount < need )
+		{
+			if( m_uPos >= m_uSize )
+			{
+				m_bError = true;
+				return 0;
+			}
+
+			value |= (unsigned long)m_pData[ m_uPos++ ] << m_nBitCount;
+			m_nBitCount += 8;
+		}
+
+		m_ulBitBuffer = value >> need;
+		m_nBitCount -= need;
+		return (unsigned int)( value & ( ( 1UL << need ) - 1 ) );
+	}
+
+	//*****************************************************************//
+	// Decode
+	//	- returns the next symbol, or -1 for an invalid code
+	int Inflater::Decode( const Huffman& huffman )
+	{
+		int code	= 0;	// bits read so far
+		int first	= 0;	// first code of the current length
+		int index	= 0;	// index of the first code of the current length
+
+		for( int length = 1; length <= MAX_BITS; length++ )
+		{
+			code |= (int)GetBits( 1 );
+			if( m_bError == true )
+				return -1;
+
+			int count = huffman.count[ length ];
+			if( code - count < first )
+				return huffman.symbol[ index + ( code - first ) ];
+
+			index += count;
+			first += count;
+			first <<= 1;
+			code <<= 1;
+		}
+
+		return -1;
+	}
+
+	//*****************************************************************//
+	// Build
+	//	- canonical code from the code lengths
+	//	- returns false if the lengths are over-subscribed
+	bool Inflater::Build( Huffman& huffman, const short* lengths, int count )
+	{
+		for( int length = 0; length <= MAX_BITS; length++ )
+			huffman.count[ length ] = 0;
+		for( int symbol = 0; symbol < count; symbol++ )
+			huffman.count[ lengths[ symbol ] ]++;
+
+		int left = 1;
+		for( int length = 1; length <= MAX_BITS; length++ )
+		{
+			left <<= 1;
+			left -= huffman.count[ length ];
+			if( left < 0 )
+				return false;
+		}
+
+		short offsets[ MAX_BITS + 1 ];
+		offsets[ 1 ] = 0;
+		for( int length = 1; length < MAX_BITS; length++ )
+			offsets[ length + 1 ] = offsets[ length ] + huffman.count[ length ];
+
+		for( int symbol = 0; symbol < count; symbol++ )
+			if( lengths[ symbol ] != 0 )
+				huffman.symbol[ offsets[ lengths[ symbol ] ]++ ] = (short)symbol;
+
+		return true;
+	}
+
+	//*****************************************************************//
+	// Stored
+	//	- uncompressed block (byte aligned)
+	bool Inflater::Stored( std::vector< unsigned char >& out )
+	{
+		m_ulBitBuffer	= 0;
+		m_nBitCount		= 0;
+
+		if( m_uPos + 4 > m_uSize )
+			return false;
+
+		unsigned int length		= m_pData[ m_uPos ] | ( m_pData[ m_uPos + 1 ] << 8 );
+		unsigned int inverse	= m_pData[ m_uPos + 2 ] | ( m_pData[ m_uPos + 3 ] << 8 );
+		m_uPos += 4;
+
+		if( length != ( ~inverse & 0xFFFF ) || m_uPos + length > m_uSize )
+			return false;
+
+		out.insert( out.end(), m_pData + m_uPos, m_pData + m_uPos + length );
+		m_uPos += length;
+		return true;
+	}
+
+	//*****************************************************************//
+	// Fixed
+	//	- block compressed with the predefined codes
+	bool Inflater::Fixed( std::vector< unsigned char >& out )
+	{
+		short lengths[ MAX_LENGTHS ];
+		int symbol = 0;
+		for( ; symbol < 144; symbol++ )			lengths[ symbol ] = 8;
+		for( ; symbol < 256; symbol++ )			lengths[ symbol ] = 9;
+		for( ; symbol < 280; symbol++ )			lengths[ symbol ] = 7;
+		for( ; symbol < MAX_LENGTHS; symbol++ )	lengths[ symbol ] = 8;
+
+		Huffman lengthCode;
+		Build( lengthCode, lengths, MAX_LENGTHS );
+
+		for( symbol = 0; symbol < MAX_DISTANCES; symbol++ )
+			lengths[ symbol ] = 5;
+
+		Huffman distanceCode;
+		Build( distanceCode, lengths, MAX_DISTANCES );
+
+		return Codes( out, lengthCode, distanceCode );
+	}
+
+	//*****************************************************************//
+	// Dynamic
+	//	- block compressed with codes described in its header
+	bool Inflater::Dynamic( std::vector< unsigned char >& out )
+	{
+		static const unsigned char ORDER[ 19 ] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		int numLengths		= (int)GetBits( 5 ) + 257;
+		int numDistances	= (int)GetBits( 5 ) + 1;
+		int numCodes		= (int)GetBits( 4 ) + 4;
+		if( m_bError == true || numLengths > MAX_LENGTHS || numDistances > MAX_DISTANCES )
+			return false;
+
+		// Code length code
+		short lengths[ MAX_LENGTHS + MAX_DISTANCES ];
+		int index = 0;
+		for( ; index < numCodes; index++ )
+			lengths[ ORDER[ index ] ] = (short)GetBits( 3 );
+		for( ; index < 19; index++ )
+			lengths[ ORDER[ index ] ] = 0;
+
+		Huffman lengthCode;
+		if( m_bError == true || Build( lengthCode, lengths, 19 ) == false )
+			return false;
+
+		// Literal/length & distance code lengths
+		index = 0;
+		while( index < numLengths + numDistances )
+		{
+			int symbol = Decode( lengthCode );
+			if( symbol < 0 )
+				return false;
+
+			if( symbol < 16 )
+			{
+				lengths[ index++ ] = (short)symbol;
+				continue;
+			}
+
+			short repeated	= 0;
+			int count		= 0;
+			if( symbol == 16 )
+			{
+				if( index == 0 )
+					return false;
+				repeated	= lengths[ index - 1 ];
+				count		= 3 + (int)GetBits( 2 );
+			}
+			else if( symbol == 17 )
+				count = 3 + (int)GetBits( 3 );
+			else
+				count = 11 + (int)GetBits( 7 );
+
+			if( m_bError == true || index + count > numLengths + numDistances )
+				return false;
+
+			while( count-- > 0 )
+				lengths[ index++ ] = repeated;
+		}
+
+		// The end-of-block code is required
+		if( lengths[ 256 ] == 0 )
+			return false;
+
+		Huffman distanceCode;
+		if( Build( lengthCode, lengths, numLengths ) == false
+			|| Build( distanceCode, lengths + numLengths, numDistances ) == false )
+			return false;
+
+		return Codes( out, lengthCode, distanceCode );
+	}
+
+	//*****************************************************************//
+	// Codes
+	//	- literals & back-references until the end of the block
+	bool Inflater::Codes( std::vector< unsigned char >& out, const Huffman& lengths, const Huffman& distances )
+	{
+		for( ;; )
+		{
+			int symbol = Decode( lengths );
+			if( symbol < 0 )
+				return false;
+
+			if( symbol < 256 )
+			{
+				out.push_back( (unsigned char)symbol );
+				continue;
+			}
+
+			if( symbol == 256 )
+				return true;	// end of block
+
+			symbol -= 257;
+			if( symbol >= 29 )
+				return false;
+
+			unsigned int length = LENGTH_BASE[ symbol ] + GetBits( LENGTH_EXTRA[ symbol ] );
+
+			symbol = Decode( distances );
+			if( symbol < 0 || symbol >= MAX_DISTANCES )
+				return false;
+
+			size_t distance = DIST_BASE[ symbol ] + GetBits( DIST_EXTRA[ symbol ] );
+			if( m_bError == true || distance > out.size() )
+				return false;
+
+			// Copy byte by byte (the source may overlap the output)
+			size_t from = out.size() - distance;
+			for( unsigned int i = 0; i < length; i++ )
+			{
+				unsigned char byte = out[ from + i ];
+				out.push_back( byte );
+			}
+		}
+	}
+
+	//*****************************************************************//
+	// Inflate
+	//	- skips the zlib header & ignores the checksum
+	bool Inflater::Inflate( std::vector< unsigned char >& out )
+	{
+		if( m_uSize < 2 )
+			return false;
+
+		unsigned int method	= m_pData[ 0 ];
+		unsigned int flags	= m_pData[ 1 ];
+		if( ( method & 0x0F ) != 8 || ( method * 256 + flags ) % 31 != 0 || ( flags & 0x20 ) != 0 )
+			return false;	// not deflate, corrupt or preset dictionary
+
+		m_uPos = 2;
+
+		bool last = false;
+		while( last == false )
+		{
+			last = GetBits( 1 ) != 0;
+			unsigned int type = GetBits( 2 );
+			if( m_bError == true )
+				return false;
+
+			bool success = false;
+			if( type == 0 )
+				success = Stored( out );
+			else if( type == 1 )
+				success = Fixed( out );
+			else if( type == 2 )
+				success = Dynamic( out );
+
+			if( success == false || m_bError == true )
+				return false;
+		}
+
+		return true;
+	}
+
+
+	//*****************************************************************//
+	// Big-endian 32-bit read
+	unsigned int ReadU32( const unsigned char* p )
+	{
+		return ( (unsigned int)p[ 0 ] << 24 ) | ( (unsigned int)p[ 1 ] << 16 ) | ( (unsigned int)p[ 2 ] << 8 ) | p[ 3 ];
+	}
+
+	//*****************************************************************//
+	// Paeth predictor
+	unsigned char Paeth( int a, int b, int c )
+	{
+		int p  = a + b - c;
+		int pa = abs( p - a );
+		int pb = abs( p - b );
+		int pc = abs( p - c );
+
+		if( pa <= pb && pa <= pc )
+			return (unsigned char)a;
+		if( pb <= pc )
+			return (unsigned char)b;
+		return (unsigned char)c;
+	}
+
+	const unsigned char SIGNATURE[ 8 ] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+}	// namespace
+
+
+//*********************************************************************//
+// DecodePng
+//	- gather the IDAT chunks, inflate them, reverse the
+//	  scanline filters & expand the samples to ARGB
+bool DecodePng( const unsigned char* data, size_t size,
+				std::vector< unsigned int >& pixels, unsigned int& width, unsigned int& height )
+{
+	if( size < 8 || memcmp( data, SIGNATURE, 8 ) != 0 )
+		return false;
+
+
+	// Read the chunks
+	unsigned int	colorType	= 0;
+	unsigned int	palette[ 256 ];
+	unsigned int	numColors	= 0;
+	bool			header		= false;
+
+	std::vector< unsigned char > compressed;
+
+	width	= 0;
+	height	= 0;
+
+	size_t pos = 8;
+	while( pos + 12 <= size )
+	{
+		unsigned int length = ReadU32( data + pos );
+		const unsigned char* type	= data + pos + 4;
+		const unsigned char* chunk	= data + pos + 8;
+		if( length > size - pos - 12 )
+			return false;
+
+		if( memcmp( type, "IHDR", 4 ) == 0 && length >= 13 )
+		{
+			width		= ReadU32( chunk );
+			height		= ReadU32( chunk + 4 );
+			colorType	= chunk[ 9 ];
+
+			// 8 bits per sample, deflate, adaptive filters, not interlaced
+			if( chunk[ 8 ] != 8 || chunk[ 10 ] != 0 || chunk[ 11 ] != 0 || chunk[ 12 ] != 0 )
+				return false;
+			if( colorType == 1 || colorType == 5 || colorType > 6 )
+				return false;
+			if( width == 0 || height == 0 || width > 16384 || height > 16384 )
+				return false;
+
+			header = true;
+		}
+		else if( memcmp( type, "PLTE", 4 ) == 0 )
+		{
+			numColors = length / 3;
+			if( numColors > 256 )
+				return false;
+
+			for( unsigned int i = 0; i < numColors; i++ )
+				palette[ i ] = 0xFF000000u | ( chunk[ i * 3 ] << 16 ) | ( chunk[ i * 3 + 1 ] << 8 ) | chunk[ i * 3 + 2 ];
+		}
+		else if( memcmp( type, "tRNS", 4 ) == 0 && colorType == 3 )
+		{
+			// Palette alpha
+			for( unsigned int i = 0; i < length && i < numColors; i++ )
+				palette[ i ] = ( palette[ i ] & 0x00FFFFFFu ) | ( (unsigned int)chunk[ i ] << 24 );
+		}
+		else if( memcmp( type, "IDAT", 4 ) == 0 )
+			compressed.insert( compressed.end(), chunk, chunk + length );
+		else if( memcmp( type, "IEND", 4 ) == 0 )
+			break;
+
+		pos += 12 + length;
+	}
+
+	if( header == false || compressed.empty() == true || ( colorType == 3 && numColors == 0 ) )
+		return false;
+
+
+	// Inflate the scanlines (a filter byte each)
+	static const unsigned int CHANNELS[ 7 ] = { 1, 0, 3, 1, 2, 0, 4 };
+	unsigned int channels	= CHANNELS[ colorType ];
+	size_t stride			= (size_t)width * channels;
+
+	std::vector< unsigned char > raw;
+	raw.reserve( ( stride + 1 ) * height );
+
+	Inflater inflater( compressed.data(), compressed.size() );
+	if( inflater.Inflate( raw ) == false || raw.size() < ( stride + 1 ) * height )
+		return false;
+
+
+	// Reverse the filters in place
+	for( unsigned int y = 0; y < height; y++ )
+	{
+		unsigned char* line			= &raw[ y * ( stride + 1 ) ];
+		unsigned char filter		= line[ 0 ];
+		unsigned char* row			= line + 1;
+		const unsigned char* above	= ( y > 0 ) ? row - ( stride + 1 ) : nullptr;
+
+		for( size_t x = 0; x < stride; x++ )
+		{
+			int a = ( x >= channels ) ? row[ x - channels ] : 0;
+			int b = ( above != nullptr ) ? above[ x ] : 0;
+			int c = ( above != nullptr && x >= channels ) ? above[ x - channels ] : 0;
+
+			switch( filter )
+			{
+			case 0:										break;
+			case 1:		row[ x ] += (unsigned char)a;					break;
+			case 2:		row[ x ] += (unsigned char)b;					break;
+			case 3:		row[ x ] += (unsigned char)( ( a + b ) / 2 );	break;
+			case 4:		row[ x ] += Paeth( a, b, c );					break;
+			default:	return false;
+			}
+		}
+	}
+
+
+	// Expand to ARGB
+	pixels.resize( (size_t)width * height );
+	for( unsigned int y = 0; y < height; y++ )
+	{
+		const unsigned char* row = &raw[ y * ( stride + 1 ) + 1 ];
+		unsigned int* out = &pixels[ (size_t)y * width ];
+
+		for( unsigned int x = 0; x < width; x++ )
+		{
+			const unsigned char* s = row + x * channels;
+			switch( colorType )
+			{
+			case 0:	out[ x ] = 0xFF000000u | ( s[ 0 ] << 16 ) | ( s[ 0 ] << 8 ) | s[ 0 ];								break;
+			case 2:	out[ x ] = 0xFF000000u | ( s[ 0 ] << 16 ) | ( s[ 1 ] << 8 ) | s[ 2 ];								break;
+			case 3:	out[ x ] = ( s[ 0 ] < numColors ) ? palette[ s[ 0 ] ] : 0;											break;
+			case 4:	out[ x ] = ( (unsigned int)s[ 1 ] << 24 ) | ( s[ 0 ] << 16 ) | ( s[ 0 ] << 8 ) | s[ 0 ];				break;
+			case 6:	out[ x ] = ( (unsigned int)s[ 3 ] << 24 ) | ( s[ 0 ] << 16 ) | ( s[ 1 ] << 8 ) | s[ 2 ];				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+//*********************************************************************//
+// ReadPngSize
+//	- the IHDR chunk must come first, so the first 24 bytes are enough
+bool ReadPngSize( const unsigned char* data, size_t size, unsigned int& width, unsigned int& height )
+{
+	if( size < 24 || memcmp( data, SIGNATURE, 8 ) != 0 || memcmp( data + 12, "IHDR", 4 ) != 0 )
+		return false;
+
+	width	= ReadU32( data + 16 );
+	height	= ReadU32( data + 20 );
+	return width > 0 && height > 0;
+}
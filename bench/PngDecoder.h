@@ -0,0 +1,30 @@
+//*********************************************************************//
+//	File:		PngDecoder.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Decodes PNG images for the software renderer
+//				(no D3DX or zlib on the bench hosts) & reads
+//				their sizes for the null one
+//*********************************************************************//
+
+#pragma once
+
+#include <cstddef>		// size_t type
+#include <vector>		// std::vector type
+
+
+//*********************************************************************//
+// DecodePng
+//	- 8-bit greyscale, greyscale + alpha, RGB, RGBA & palette images
+//	  (not interlaced)
+//	- pixels are 0xAARRGGBB (D3DCOLOR), top row first
+//	- returns false if the data is not a supported PNG
+bool DecodePng( const unsigned char* data, size_t size,
+				std::vector< unsigned int >& pixels, unsigned int& width, unsigned int& height );
+
+
+//*********************************************************************//
+// ReadPngSize
+//	- reads the image size from the start of a PNG file
+//	  (without decoding it)
+bool ReadPngSize( const unsigned char* data, size_t size, unsigned int& width, unsigned int& height );
@@ -0,0 +1,1130 @@
+//*********************************************************************//
+//	File:		SoftwareGraphics.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	CPU rasterizer GraphicsManager for rendering the game
+//				without Direct3D (profiling & screenshots on any host)
+//*********************************************************************//
+
+#include "SoftwareGraphics.h"
+#include "PngDecoder.h"
+
+#include "../SGD Wrappers/SGD_Utilities.h"
+#include "../SGD Wrappers/SGD_AssetArchive.h"
+
+#include <algorithm>	// std::min, std::max, std::fill
+#include <chrono>		// std::chrono::steady_clock
+#include <cfloat>		// FLT_MAX
+#include <cmath>		// floorf, ceilf, sqrtf
+#include <cstdio>		// FILE
+
+// Uses SSE2 intrinsics (when enabled)
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined( __SSE2__ )
+	#define SGD_SOFTWARE_SSE2
+	#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	typedef SGD::SGD_IMPLEMENTATION::SpriteBatch::Transform Transform;
+
+
+	//*****************************************************************//
+	// Pixel math
+	//	- per 8-bit channel, the same in the scalar & SSE2 paths
+	//	- Div255 is x / 255 rounded (exact for x up to 255 * 255)
+	//	- modulate:	texel * colour
+	//	- alpha:	src * a + dst * (255 - a)
+	//	- additive:	src * a + dst (saturated)
+	inline unsigned int Div255( unsigned int x )
+	{
+		x += 128;
+		return ( x + ( x >> 8 ) ) >> 8;
+	}
+
+	inline unsigned int Modulate( unsigned int texel, unsigned int color )
+	{
+		unsigned int result = 0;
+		for( int shift = 0; shift < 32; shift += 8 )
+			result |= Div255( ( ( texel >> shift ) & 0xFF ) * ( ( color >> shift ) & 0xFF ) ) << shift;
+		return result;
+	}
+
+	inline unsigned int BlendAlpha( unsigned int src, unsigned int dst )
+	{
+		unsigned int a = src >> 24;
+		unsigned int result = 0;
+		for( int shift = 0; shift < 32; shift += 8 )
+			result |= Div255( ( ( src >> shift ) & 0xFF ) * a + ( ( dst >> shift ) & 0xFF ) * ( 255 - a ) ) << shift;
+		return result;
+	}
+
+	inline unsigned int BlendAdditive( unsigned int src, unsigned int dst )
+	{
+		unsigned int a = src >> 24;
+		unsigned int result = 0;
+		for( int shift = 0; shift < 32; shift += 8 )
+		{
+			unsigned int sum = ( ( dst >> shift ) & 0xFF ) + Div255( ( ( src >> shift ) & 0xFF ) * a );
+			result |= std::min( sum, 255u ) << shift;
+		}
+		return result;
+	}
+
+
+#if defined( SGD_SOFTWARE_SSE2 )
+	//*****************************************************************//
+	// Pixel math (4 pixels, as 16-bit channels)
+	inline __m128i Div255x8( __m128i x )
+	{
+		x = _mm_add_epi16( x, _mm_set1_epi16( 128 ) );
+		return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 ) ), 8 );
+	}
+
+	inline __m128i SplatAlpha( __m128i channels )
+	{
+		return _mm_shufflehi_epi16( _mm_shufflelo_epi16( channels, 0xFF ), 0xFF );
+	}
+
+	inline __m128i Modulate4( __m128i texels, __m128i color16 )
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i lo = Div255x8( _mm_mullo_epi16( _mm_unpacklo_epi8( texels, zero ), color16 ) );
+		__m128i hi = Div255x8( _mm_mullo_epi16( _mm_unpackhi_epi8( texels, zero ), color16 ) );
+		return _mm_packus_epi16( lo, hi );
+	}
+
+	inline __m128i BlendAlpha4( __m128i src, __m128i dst )
+	{
+		const __m128i zero	= _mm_setzero_si128();
+		const __m128i full	= _mm_set1_epi16( 255 );
+
+		__m128i srcLo = _mm_unpacklo_epi8( src, zero );
+		__m128i srcHi = _mm_unpackhi_epi8( src, zero );
+		__m128i dstLo = _mm_unpacklo_epi8( dst, zero );
+		__m128i dstHi = _mm_unpackhi_epi8( dst, zero );
+		__m128i aLo   = SplatAlpha( srcLo );
+		__m128i aHi   = SplatAlpha( srcHi );
+
+		__m128i lo = Div255x8( _mm_add_epi16( _mm_mullo_epi16( srcLo, aLo ), _mm_mullo_epi16( dstLo, _mm_sub_epi16( full, aLo ) ) ) );
+		__m128i hi = Div255x8( _mm_add_epi16( _mm_mullo_epi16( srcHi, aHi ), _mm_mullo_epi16( dstHi, _mm_sub_epi16( full, aHi ) ) ) );
+		return _mm_packus_epi16( lo, hi );
+	}
+
+	inline __m128i BlendAdditive4( __m128i src, __m128i dst )
+	{
+		const __m128i zero = _mm_setzero_si128();
+
+		__m128i srcLo = _mm_unpacklo_epi8( src, zero );
+		__m128i srcHi = _mm_unpackhi_epi8( src, zero );
+
+		__m128i lo = Div255x8( _mm_mullo_epi16( srcLo, SplatAlpha( srcLo ) ) );
+		__m128i hi = Div255x8( _mm_mullo_epi16( srcHi, SplatAlpha( srcHi ) ) );
+		return _mm_adds_epu8( dst, _mm_packus_epi16( lo, hi ) );
+	}
+
+	inline __m128i Expand( unsigned int color )
+	{
+		return _mm_unpacklo_epi8( _mm_set1_epi32( (int)color ), _mm_setzero_si128() );
+	}
+#endif
+
+
+	//*****************************************************************//
+	// TextureSpan
+	//	- point samples a texture section along a row,
+	//	  modulates & blends it into the frame
+	struct TextureSpan
+	{
+		const unsigned int*	texels;			// section origin
+		unsigned int		pitch;			// texture width
+		float				maxU;			// section width - 1
+		float				maxV;			// section height - 1
+		unsigned int		color;
+		bool				modulate;		// color is not white
+		bool				additive;
+
+		void operator()( unsigned int* dst, unsigned int count, float u0, float v0, float du, float dv ) const
+		{
+			unsigned int i = 0;
+
+#if defined( SGD_SOFTWARE_SSE2 )
+			const __m128 lane		= _mm_set_ps( 3.0f, 2.0f, 1.0f, 0.0f );
+			const __m128 zero		= _mm_setzero_ps();
+			const __m128 startU		= _mm_set1_ps( u0 );
+			const __m128 startV		= _mm_set1_ps( v0 );
+			const __m128 stepU		= _mm_set1_ps( du );
+			const __m128 stepV		= _mm_set1_ps( dv );
+			const __m128 limitU		= _mm_set1_ps( maxU );
+			const __m128 limitV		= _mm_set1_ps( maxV );
+			const __m128 stride		= _mm_set1_ps( (float)pitch );
+			const __m128i color16	= Expand( color );
+
+			for( ; i + 4 <= count; i += 4 )
+			{
+				// Texel indices of the 4 pixels
+				__m128 k = _mm_add_ps( _mm_set1_ps( (float)i ), lane );
+				__m128 u = _mm_min_ps( _mm_max_ps( _mm_add_ps( startU, _mm_mul_ps( k, stepU ) ), zero ), limitU );
+				__m128 v = _mm_min_ps( _mm_max_ps( _mm_add_ps( startV, _mm_mul_ps( k, stepV ) ), zero ), limitV );
+
+				__m128 index = _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( _mm_cvttps_epi32( v ) ), stride ),
+										   _mm_cvtepi32_ps( _mm_cvttps_epi32( u ) ) );
+
+				int indices[ 4 ];
+				_mm_storeu_si128( (__m128i*)indices, _mm_cvttps_epi32( index ) );
+
+				__m128i src = _mm_set_epi32( (int)texels[ indices[ 3 ] ], (int)texels[ indices[ 2 ] ],
+											 (int)texels[ indices[ 1 ] ], (int)texels[ indices[ 0 ] ] );
+
+				// Skip fully transparent texels (colour-keyed edges)
+				if( _mm_movemask_epi8( _mm_cmpeq_epi32( _mm_srli_epi32( src, 24 ), _mm_setzero_si128() ) ) == 0xFFFF )
+					continue;
+
+				if( modulate == true )
+					src = Modulate4( src, color16 );
+
+				__m128i* p = (__m128i*)( dst + i );
+				__m128i d = _mm_loadu_si128( p );
+				_mm_storeu_si128( p, additive ? BlendAdditive4( src, d ) : BlendAlpha4( src, d ) );
+			}
+#endif
+
+			for( ; i < count; i++ )
+			{
+				float u = std::min( std::max( u0 + (float)i * du, 0.0f ), maxU );
+				float v = std::min( std::max( v0 + (float)i * dv, 0.0f ), maxV );
+
+				unsigned int src = texels[ (unsigned int)v * pitch + (unsigned int)u ];
+				if( ( src >> 24 ) == 0 )
+					continue;
+
+				if( modulate == true )
+					src = Modulate( src, color );
+
+				dst[ i ] = additive ? BlendAdditive( src, dst[ i ] ) : BlendAlpha( src, dst[ i ] );
+			}
+		}
+	};
+
+
+	//*****************************************************************//
+	// SolidSpan
+	//	- blends one colour along a row
+	struct SolidSpan
+	{
+		unsigned int		color;
+
+		void operator()( unsigned int* dst, unsigned int count, float, float, float, float ) const
+		{
+			// Opaque: nothing to blend
+			if( ( color >> 24 ) == 255 )
+			{
+				std::fill( dst, dst + count, color );
+				return;
+			}
+
+			unsigned int i = 0;
+
+#if defined( SGD_SOFTWARE_SSE2 )
+			const __m128i src = _mm_set1_epi32( (int)color );
+			for( ; i + 4 <= count; i += 4 )
+			{
+				__m128i* p = (__m128i*)( dst + i );
+				_mm_storeu_si128( p, BlendAlpha4( src, _mm_loadu_si128( p ) ) );
+			}
+#endif
+
+			for( ; i < count; i++ )
+				dst[ i ] = BlendAlpha( color, dst[ i ] );
+		}
+	};
+
+
+	//*****************************************************************//
+	// ClipSpan
+	//	- narrow [lo, hi) to where 0 <= a * x + b < limit
+	//	- returns false if nothing is left
+	inline bool ClipSpan( float a, float b, float limit, float& lo, float& hi )
+	{
+		if( a > 0.0f )
+		{
+			lo = std::max( lo, -b / a );
+			hi = std::min( hi, ( limit - b ) / a );
+		}
+		else if( a < 0.0f )
+		{
+			lo = std::max( lo, ( limit - b ) / a );
+			hi = std::min( hi, -b / a );
+		}
+		else if( b < 0.0f || b >= limit )
+			return false;
+
+		return lo < hi;
+	}
+
+
+	//*****************************************************************//
+	// RasterizeQuad
+	//	- the quad is (0, 0) -> (width, height) in local space,
+	//	  placed in the frame by the transform
+	//	- every row is one span: the pixel centres whose local
+	//	  position falls inside the quad (solved, not tested)
+	//	- returns the number of pixels covered
+	template< typename SpanProc >
+	unsigned int RasterizeQuad( const Transform& t, float width, float height,
+								unsigned int* frame, unsigned int frameWidth, unsigned int frameHeight,
+								const SpanProc& proc )
+	{
+		float det = t.m11 * t.m22 - t.m12 * t.m21;
+		if( fabsf( det ) < 1e-8f || width <= 0.0f || height <= 0.0f )
+			return 0;
+
+		// Inverse (local = frame position * inverse)
+		float dudx =  t.m22 / det;
+		float dvdx = -t.m12 / det;
+		float dudy = -t.m21 / det;
+		float dvdy =  t.m11 / det;
+
+
+		// Rows covered by the corners
+		float y1 = width  * t.m12;
+		float y2 = height * t.m22;
+		float top		= t.dy + std::min( std::min( 0.0f, y1 ), std::min( y2, y1 + y2 ) );
+		float bottom	= t.dy + std::max( std::max( 0.0f, y1 ), std::max( y2, y1 + y2 ) );
+
+		int firstRow	= std::max( (int)floorf( std::max( top, -1.0f ) ), 0 );
+		int lastRow		= std::min( (int)ceilf( std::min( bottom, (float)frameHeight ) ), (int)frameHeight );
+
+		unsigned int covered = 0;
+		for( int y = firstRow; y < lastRow; y++ )
+		{
+			float dy = (float)y + 0.5f - t.dy;
+
+			float lo = -FLT_MAX;
+			float hi =  FLT_MAX;
+			if( ClipSpan( dudx, dy * dudy, width, lo, hi ) == false
+				|| ClipSpan( dvdx, dy * dvdy, height, lo, hi ) == false )
+				continue;
+
+			// Pixel centres (x + 0.5 - dx) within [lo, hi)
+			float left	= std::min( std::max( lo + t.dx - 0.5f, 0.0f ), (float)frameWidth );
+			float right	= std::min( std::max( hi + t.dx - 0.5f, 0.0f ), (float)frameWidth );
+
+			int x0 = (int)ceilf( left );
+			int x1 = (int)ceilf( right );
+			if( x0 >= x1 )
+				continue;
+
+			float dx = (float)x0 + 0.5f - t.dx;
+			proc( frame + (size_t)y * frameWidth + x0, (unsigned int)( x1 - x0 ),
+				  dx * dudx + dy * dudy, dx * dvdx + dy * dvdy, dudx, dvdx );
+
+			covered += (unsigned int)( x1 - x0 );
+		}
+
+		return covered;
+	}
+
+}	// namespace
+
+
+namespace SGD
+{
+	//*****************************************************************//
+	// Interface singleton accessors
+	/*static*/ GraphicsManager* GraphicsManager::GetInstance( void )
+	{
+		return SGD_IMPLEMENTATION::GraphicsManager::GetInstance();
+	}
+
+	/*static*/ void GraphicsManager::DeleteInstance( void )
+	{
+		SGD_IMPLEMENTATION::GraphicsManager::DeleteInstance();
+	}
+
+
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// SINGLETON
+		/*static*/ GraphicsManager* GraphicsManager::s_pInstance = nullptr;
+
+		/*static*/ GraphicsManager* GraphicsManager::GetInstance( void )
+		{
+			if( s_pInstance == nullptr )
+				s_pInstance = new GraphicsManager;
+
+			return s_pInstance;
+		}
+
+		/*static*/ void GraphicsManager::DeleteInstance( void )
+		{
+			delete s_pInstance;
+			s_pInstance = nullptr;
+		}
+
+
+		//*************************************************************//
+		// INITIALIZE / UPDATE / TERMINATE
+		bool GraphicsManager::Initialize( bool vsync )
+		{
+			return Initialize( L"", Size{ 1024, 768 }, vsync );
+		}
+
+		bool GraphicsManager::Initialize( const wchar_t* title, Size size, bool vsync )
+		{
+			m_Loader.Initialize( &GraphicsManager::DecodeFile, nullptr );
+			return AllocateFrames( size );
+		}
+
+		bool GraphicsManager::Update( void )
+		{
+			SGD_ASSERT( m_bBatching == false, "GraphicsManager::Update - EndBatch was not called" );
+			if( m_bBatching == true )
+				EndBatch();
+
+			m_Batch.EndFrame();
+
+			// Swap in the textures the loader thread has decoded
+			FinishLoads();
+
+			// Present & clear the next frame
+			m_vFront.swap( m_vBack );
+			std::fill( m_vBack.begin(), m_vBack.end(), (unsigned int)m_ClearColor );
+			return true;
+		}
+
+		bool GraphicsManager::Terminate( void )
+		{
+			m_Loader.Stop();
+
+			TextureLoader< TextureInfo >::Job job;
+			while( m_Loader.PopFinished( job ) == true )
+				continue;
+
+			m_HandleManager.Clear();
+			m_Index.Clear();
+			m_Batch.Clear();
+			m_bBatching = false;
+
+			m_Atlas.Clear();
+			m_vPages.clear();
+			m_bAtlas = false;
+
+			m_vBack.clear();
+			m_vFront.clear();
+			m_unWidth	= 0;
+			m_unHeight	= 0;
+			return true;
+		}
+
+		bool GraphicsManager::Resize( Size size, bool windowed )
+		{
+			return AllocateFrames( size );
+		}
+
+		bool GraphicsManager::AllocateFrames( Size size )
+		{
+			SGD_ASSERT( size.width >= 1 && size.height >= 1, "GraphicsManager::Initialize - invalid size" );
+			if( size.width < 1 || size.height < 1 )
+				return false;
+
+			m_unWidth	= (unsigned int)size.width;
+			m_unHeight	= (unsigned int)size.height;
+
+			m_vBack.assign( (size_t)m_unWidth * m_unHeight, (unsigned int)m_ClearColor );
+			m_vFront.assign( (size_t)m_unWidth * m_unHeight, (unsigned int)m_ClearColor );
+			return true;
+		}
+
+
+		//*************************************************************//
+		// DRAW LINE
+		//	- a quad from position1 to position2 (inclusive),
+		//	  'lineWidth' wide & centred on the line
+		bool GraphicsManager::DrawLine( Point position1, Point position2, Color color, unsigned int lineWidth )
+		{
+			float dX = position2.x - position1.x;
+			float dY = position2.y - position1.y;
+
+			// Is the line too small?
+			if( ( dX == 0 && dY == 0 ) || lineWidth == 0 )
+				return false;
+
+			SubmitUntextured();
+
+
+			float length	= sqrtf( dX * dX + dY * dY );
+			float cosine	= dX / length;
+			float sine		= dY / length;
+			float halfWidth	= lineWidth * 0.5f;
+
+			Transform transform = {	 cosine,	sine,
+									-sine,		cosine,
+									position1.x + halfWidth * sine, position1.y - halfWidth * cosine };
+
+			FillQuad( transform, length + 1.0f, (float)lineWidth, color );
+			return true;
+		}
+
+
+		//*************************************************************//
+		// DRAW RECTANGLE
+		//	- same pixel layout as the Direct3D implementation:
+		//	  the frame straddles the edges, the fill is inside it
+		bool GraphicsManager::DrawRectangle( Rectangle rect, Color fillColor, Color lineColor, unsigned int lineWidth )
+		{
+			SGD_ASSERT( rect.IsEmpty() == false, "GraphicsManager::DrawRectangle - rectangle is empty" );
+			if( rect.IsEmpty() == true )
+				return false;
+
+			SubmitUntextured();
+
+
+			// Clamp the rectangle to pixel coordinates
+			int width	= (int)(rect.right  - rect.left + 0.5f);
+			int height	= (int)(rect.bottom - rect.top  + 0.5f);
+			int left	= (int)(rect.left + (rect.left > 0 ? 0.5f : -0.5f) );
+			int top		= (int)(rect.top  + (rect.top  > 0 ? 0.5f : -0.5f) );
+			int right	= left + width;
+			int bottom	= top  + height;
+
+			Transform transform = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+
+			if( lineColor.alpha > 0 && lineWidth > 0 )
+			{
+				int smallLineHalf = (int)(lineWidth / 2);
+				int largeLineHalf = (int)(lineWidth - smallLineHalf);
+
+				// Top & bottom
+				transform.dx = (float)(left - largeLineHalf);
+				transform.dy = (float)(top  - largeLineHalf);
+				FillQuad( transform, (float)(width + largeLineHalf - smallLineHalf), (float)lineWidth, lineColor );
+
+				transform.dx = (float)(left   + smallLineHalf);
+				transform.dy = (float)(bottom - smallLineHalf);
+				FillQuad( transform, (float)(width + largeLineHalf - smallLineHalf), (float)lineWidth, lineColor );
+
+				// Left & right
+				transform.dx = (float)(left - largeLineHalf);
+				transform.dy = (float)(top  + smallLineHalf);
+				FillQuad( transform, (float)lineWidth, (float)(height + largeLineHalf - smallLineHalf), lineColor );
+
+				transform.dx = (float)(right - smallLineHalf);
+				transform.dy = (float)(top   - largeLineHalf);
+				FillQuad( transform, (float)lineWidth, (float)(height + largeLineHalf - smallLineHalf), lineColor );
+
+				// Fill within the frame
+				if( fillColor.alpha > 0 )
+				{
+					transform.dx = (float)(left + smallLineHalf);
+					transform.dy = (float)(top  + smallLineHalf);
+					FillQuad( transform, (float)(width - smallLineHalf * 2), (float)(height - smallLineHalf * 2), fillColor );
+				}
+			}
+			else if( fillColor.alpha > 0 )
+			{
+				transform.dx = (float)left;
+				transform.dy = (float)top;
+				FillQuad( transform, (float)width, (float)height, fillColor );
+			}
+
+			return true;
+		}
+
+
+		//*************************************************************//
+		// LOAD TEXTURE
+		//	- shares the texture when the file is already loaded
+		HTexture GraphicsManager::LoadTexture( const wchar_t* filename, Color colorKey )
+		{
+			SGD_ASSERT( filename != nullptr && filename[0] != L'\0', "GraphicsManager::LoadTexture - invalid filename" );
+			if( filename == nullptr || filename[0] == L'\0' )
+				return HTexture();
+
+
+			// Attempt to find the texture in the index
+			// (waiting for it when it is still loading)
+			HTexture handle = m_Index.Find( filename );
+			if( handle != INVALID_HANDLE )
+			{
+				m_HandleManager.GetData( handle )->refCount++;
+
+				if( m_HandleManager.GetData( handle )->loading == true )
+					WaitForTextures( &handle, 1, 0xFFFFFFFF );
+
+				return handle;
+			}
+
+
+			TextureInfo data;
+			if( DecodeFile( nullptr, filename, colorKey, data ) == false )
+			{
+				std::wstring message = L"!!! GraphicsManager::LoadTexture - failed to load texture file \"" + std::wstring( filename ) + L"\" !!!\n";
+				Alert( message.c_str() );
+				return HTexture();
+			}
+
+			data.filename	= filename;
+			data.refCount	= 1;
+
+			// Pack it into an atlas page?
+			if( m_bAtlas == true )
+				CopyToAtlas( data );
+
+			handle = m_HandleManager.StoreData( data );
+			m_Index.Insert( filename, handle );
+			return handle;
+		}
+
+		HTexture GraphicsManager::LoadTexture( const char* filename, Color colorKey )
+		{
+			SGD_ASSERT( filename != nullptr, "GraphicsManager::LoadTexture - invalid filename" );
+			if( filename == nullptr )
+				return HTexture();
+
+			std::string name = filename;
+			return LoadTexture( std::wstring( name.begin(), name.end() ).c_str(), colorKey );
+		}
+
+
+		//*************************************************************//
+		// LOAD TEXTURE ASYNC
+		//	- stores a 0 x 0 placeholder & queues the file
+		//	  (FinishLoads swaps the image in)
+		HTexture GraphicsManager::LoadTextureAsync( const wchar_t* filename, Color colorKey )
+		{
+			SGD_ASSERT( filename != nullptr && filename[0] != L'\0', "GraphicsManager::LoadTextureAsync - invalid filename" );
+			if( filename == nullptr || filename[0] == L'\0' )
+				return HTexture();
+
+			// Loaded or loading already?
+			HTexture handle = m_Index.Find( filename );
+			if( handle != INVALID_HANDLE )
+			{
+				m_HandleManager.GetData( handle )->refCount++;
+				return handle;
+			}
+
+			TextureInfo data;
+			data.filename	= filename;
+			data.refCount	= 1;
+			data.width		= 0;
+			data.height		= 0;
+			data.loading	= true;
+
+			handle = m_HandleManager.StoreData( data );
+			m_Index.Insert( filename, handle );
+
+			m_Loader.Queue( handle, filename, colorKey );
+			return handle;
+		}
+
+		HTexture GraphicsManager::LoadTextureAsync( const char* filename, Color colorKey )
+		{
+			SGD_ASSERT( filename != nullptr, "GraphicsManager::LoadTextureAsync - invalid filename" );
+			if( filename == nullptr )
+				return HTexture();
+
+			std::string name = filename;
+			return LoadTextureAsync( std::wstring( name.begin(), name.end() ).c_str(), colorKey );
+		}
+
+		bool GraphicsManager::IsTextureLoaded( HTexture handle )
+		{
+			if( m_HandleManager.IsHandleValid( handle ) == false )
+				return false;
+
+			// Loaded once it has an image
+			return m_HandleManager.GetData( handle )->width > 0;
+		}
+
+		unsigned int GraphicsManager::WaitForTextures( const HTexture* handles, unsigned int count, unsigned int milliseconds )
+		{
+			SGD_ASSERT( handles != nullptr || count == 0, "GraphicsManager::WaitForTextures - handles cannot be null" );
+			if( handles == nullptr )
+				return 0;
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			for( ; ; )
+			{
+				FinishLoads();
+
+				// Invalid & unloaded handles count as done
+				unsigned int done = 0;
+				for( unsigned int i = 0; i < count; i++ )
+					if( m_HandleManager.IsHandleValid( handles[ i ] ) == false
+						|| m_HandleManager.GetData( handles[ i ] )->loading == false )
+						done++;
+
+				if( done == count || milliseconds == 0 )
+					return done;
+
+				unsigned int wait = 0xFFFFFFFF;
+				if( milliseconds != 0xFFFFFFFF )
+				{
+					long long elapsed = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - start ).count();
+					if( elapsed >= milliseconds )
+						return done;
+
+					wait = milliseconds - (unsigned int)elapsed;
+				}
+
+				if( m_Loader.WaitForFinished( wait ) == false && m_Loader.GetNumPending() == 0 )
+					return done;
+			}
+		}
+
+
+		//*************************************************************//
+		// DECODE FILE
+		//	- read, decode & colour-key a PNG (LoadTexture, or the loader
+		//	  thread for LoadTextureAsync: it only touches 'image')
+		/*static*/ bool GraphicsManager::DecodeFile( void* context, const wchar_t* filename, Color colorKey, TextureInfo& image )
+		{
+			// Decode it straight from the mounted archive?
+			const unsigned char*			bytes	= nullptr;
+			size_t							size	= 0;
+			std::vector< unsigned char >	file;
+			ArchivedFile					archive;
+
+			if( archive.Read( filename, bytes, size, file ) == false )
+			{
+				// Read the file (the paths are ASCII)
+				std::wstring wide = filename;
+				std::string name( wide.begin(), wide.end() );
+
+				FILE* pFile = fopen( name.c_str(), "rb" );
+				if( pFile != nullptr )
+				{
+					unsigned char buffer[ 4096 ];
+					size_t read;
+					while( ( read = fread( buffer, 1, sizeof( buffer ), pFile ) ) > 0 )
+						file.insert( file.end(), buffer, buffer + read );
+
+					fclose( pFile );
+				}
+
+				bytes	= file.data();
+				size	= file.size();
+			}
+
+			if( size == 0
+				|| DecodePng( bytes, size, image.pixels, image.width, image.height ) == false )
+				return false;
+
+
+			// Replace the colour key with transparent black (like D3DX)
+			unsigned int key = (unsigned int)colorKey;
+			if( key != 0 )
+				std::replace( image.pixels.begin(), image.pixels.end(), key, 0u );
+
+			return true;
+		}
+
+
+		//*************************************************************//
+		// FINISH LOADS
+		//	- swap the decoded images in for the placeholders
+		//	  (packing them into a page in atlas mode)
+		void GraphicsManager::FinishLoads( void )
+		{
+			TextureLoader< TextureInfo >::Job job;
+			while( m_Loader.PopFinished( job ) == true )
+			{
+				// Unloaded while it was loading?
+				if( m_HandleManager.IsHandleValid( job.handle ) == false )
+					continue;
+
+				if( job.success == false )
+				{
+					m_HandleManager.GetData( job.handle )->loading = false;
+
+					std::wstring message = L"!!! GraphicsManager::LoadTextureAsync - failed to load texture file \"" + job.filename + L"\" !!!\n";
+					Alert( message.c_str() );
+					continue;
+				}
+
+				// (CopyToAtlas can store a page, so the texture is looked up afterwards)
+				if( m_bAtlas == true )
+					CopyToAtlas( job.image );
+
+				TextureInfo* data = m_HandleManager.GetData( job.handle );
+				data->width		= job.image.width;
+				data->height	= job.image.height;
+				data->pixels.swap( job.image.pixels );
+				data->page		= job.image.page;
+				data->region	= job.image.region;
+				data->loading	= false;
+			}
+		}
+
+
+		//*************************************************************//
+		// DRAW TEXTURE / DRAW TEXTURE SECTION
+		//	- go through the sprite batch (submitted immediately
+		//	  outside BeginBatch & EndBatch)
+		bool GraphicsManager::DrawTexture( HTexture handle, Point position, float rotation, Vector rotationOffset, Color color, Size scale )
+		{
+			SGD_ASSERT( handle != SGD::INVALID_HANDLE, "GraphicsManager::DrawTexture - invalid handle" );
+			if( m_HandleManager.GetData( handle ) == nullptr )
+				return false;
+
+			Sprite sprite;
+			sprite.handle			= handle;
+			sprite.position			= position;
+			sprite.rotation			= rotation;
+			sprite.rotationOffset	= rotationOffset;
+			sprite.color			= color;
+			sprite.scale			= scale;
+
+			return DrawSprites( &sprite, 1 );
+		}
+
+		bool GraphicsManager::DrawTextureSection( HTexture handle, Point position, Rectangle section, float rotation, Vector rotationOffset, Color color, Size scale )
+		{
+			SGD_ASSERT( handle != SGD::INVALID_HANDLE, "GraphicsManager::DrawTextureSection - invalid handle" );
+			if( m_HandleManager.GetData( handle ) == nullptr )
+				return false;
+
+			SGD_ASSERT( section.IsEmpty() == false, "GraphicsManager::DrawTextureSection - section rectangle is empty" );
+			if( section.IsEmpty() == true )
+				return false;
+
+			Sprite sprite;
+			sprite.handle			= handle;
+			sprite.position			= position;
+			sprite.section			= section;
+			sprite.rotation			= rotation;
+			sprite.rotationOffset	= rotationOffset;
+			sprite.color			= color;
+			sprite.scale			= scale;
+
+			return DrawSprites( &sprite, 1 );
+		}
+
+
+		//*************************************************************//
+		// UNLOAD TEXTURE
+		bool GraphicsManager::UnloadTexture( HTexture& handle )
+		{
+			// Quietly ignore bad handles
+			if( handle == INVALID_HANDLE )
+				return false;
+
+			TextureInfo* data = m_HandleManager.GetData( handle );
+			if( data == nullptr )
+				return false;
+
+			// Is this the last reference?
+			if( --data->refCount == 0 )
+			{
+				HTexture				page	= data->page;
+				TextureAtlas::Region	region	= data->region;
+
+				m_Index.Remove( data->filename.c_str() );
+				m_HandleManager.RemoveData( handle, nullptr );
+
+				// Give back the atlas area
+				if( page != INVALID_HANDLE )
+					RemoveFromAtlas( page, region );
+			}
+
+			handle = HTexture();
+			return true;
+		}
+
+
+		//*************************************************************//
+		// BATCHING
+		bool GraphicsManager::BeginBatch( void )
+		{
+			SGD_ASSERT( m_bBatching == false, "GraphicsManager::BeginBatch - already batching" );
+			if( m_bBatching == true )
+				return false;
+
+			m_bBatching = true;
+			return true;
+		}
+
+		bool GraphicsManager::EndBatch( void )
+		{
+			SGD_ASSERT( m_bBatching == true, "GraphicsManager::EndBatch - not batching" );
+			if( m_bBatching == false )
+				return false;
+
+			m_bBatching = false;
+			return SubmitBatch();
+		}
+
+		bool GraphicsManager::DrawSprites( const Sprite* sprites, unsigned int count )
+		{
+			SGD_ASSERT( sprites != nullptr || count == 0, "GraphicsManager::DrawSprites - sprites cannot be null" );
+			if( sprites == nullptr )
+				return false;
+
+			MapToAtlas( m_Batch.Add( sprites, count ), count );
+
+			if( m_bBatching == false )
+				return SubmitBatch();
+
+			return true;
+		}
+
+
+		//*************************************************************//
+		// ATLAS
+		//	- packed textures move into a page at load time & their
+		//	  queued sprites are pointed at it (one run per page)
+		bool GraphicsManager::SetAtlasMode( bool atlas, unsigned int pageSize )
+		{
+			if( atlas == false )
+			{
+				m_bAtlas = false;
+				return true;
+			}
+
+			SGD_ASSERT( pageSize > 0, "GraphicsManager::SetAtlasMode - invalid page size" );
+			if( pageSize == 0 )
+				return false;
+
+			if( pageSize != m_Atlas.GetPageSize() )
+			{
+				SGD_ASSERT( m_Atlas.IsEmpty() == true, "GraphicsManager::SetAtlasMode - cannot change the page size while pages are in use" );
+				if( m_Atlas.IsEmpty() == false )
+					return false;
+
+				m_Atlas.Initialize( pageSize );
+				m_vPages.clear();
+			}
+
+			m_bAtlas = true;
+			return true;
+		}
+
+		bool GraphicsManager::CopyToAtlas( TextureInfo& data )
+		{
+			TextureAtlas::Region region;
+			if( m_Atlas.Insert( data.width, data.height, region ) == false )
+				return false;
+
+			// Create the page?
+			if( region.page >= m_vPages.size() )
+				m_vPages.resize( region.page + 1 );
+
+			if( m_vPages[ region.page ] == INVALID_HANDLE )
+			{
+				TextureInfo page;
+				page.refCount	= 1;
+				page.width		= m_Atlas.GetPageSize();
+				page.height		= m_Atlas.GetPageSize();
+				page.pixels.assign( (size_t)page.width * page.height, 0u );
+
+				m_vPages[ region.page ] = m_HandleManager.StoreData( page );
+			}
+
+			// Copy the image into its area
+			TextureInfo* page = m_HandleManager.GetData( m_vPages[ region.page ] );
+			for( unsigned int y = 0; y < region.height; y++ )
+				std::copy( &data.pixels[ (size_t)y * data.width ], &data.pixels[ (size_t)y * data.width ] + data.width,
+						   &page->pixels[ (size_t)( region.y + y ) * page->width + region.x ] );
+
+			std::vector< unsigned int >().swap( data.pixels );
+			data.page	= m_vPages[ region.page ];
+			data.region	= region;
+			return true;
+		}
+
+		void GraphicsManager::MapToAtlas( Sprite* sprites, unsigned int count )
+		{
+			for( unsigned int i = 0; i < count; i++ )
+			{
+				const TextureInfo* data = m_HandleManager.GetData( sprites[ i ].handle );
+				if( data == nullptr || data->page == INVALID_HANDLE )
+					continue;
+
+				sprites[ i ].section	= TextureAtlas::MapSection( data->region, sprites[ i ].section );
+				sprites[ i ].handle		= data->page;
+			}
+		}
+
+		void GraphicsManager::RemoveFromAtlas( HTexture page, const TextureAtlas::Region& region )
+		{
+			TextureInfo* data = m_HandleManager.GetData( page );
+			if( data == nullptr )
+				return;
+
+			// Release the empty page, or clear the area so it cannot
+			// show up next to a later image
+			if( m_Atlas.Remove( region ) == true )
+			{
+				m_HandleManager.RemoveData( page, nullptr );
+				m_vPages[ region.page ] = HTexture();
+			}
+			else
+			{
+				for( unsigned int y = 0; y < region.height; y++ )
+				{
+					unsigned int* row = &data->pixels[ (size_t)( region.y + y ) * data->width + region.x ];
+					std::fill( row, row + region.width, 0u );
+				}
+			}
+		}
+
+
+		//*************************************************************//
+		// SUBMIT BATCH
+		//	- rasterize the queued sprites run by run
+		bool GraphicsManager::SubmitBatch( void )
+		{
+			if( m_Batch.IsEmpty() == true )
+				return true;
+
+			Transform identity = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+			m_Batch.Prepare( identity );
+
+			bool success = true;
+			for( unsigned int r = 0; r < m_Batch.GetNumRuns(); r++ )
+			{
+				const SpriteBatch::Run& run = m_Batch.GetRun( r );
+				const Sprite& first = m_Batch.GetSprite( run.first );
+
+				// Get the texture once per run
+				const TextureInfo* data = m_HandleManager.GetData( first.handle );
+				if( data == nullptr )
+				{
+					success = false;
+					continue;
+				}
+
+				for( unsigned int i = run.first; i < run.first + run.count; i++ )
+					DrawSprite( *data, m_Batch.GetSprite( i ), m_Batch.GetTransform( i ) );
+
+				m_Batch.CountDraw( first.handle, run.count );
+			}
+
+			m_Batch.Clear();
+			return success;
+		}
+
+		bool GraphicsManager::SubmitUntextured( void )
+		{
+			// Keep the order with the queued sprites
+			if( m_bBatching == true )
+				SubmitBatch();
+
+			m_Batch.CountDraw( HTexture(), 0 );
+			return true;
+		}
+
+
+		//*************************************************************//
+		// DRAW SPRITE
+		//	- the section is clipped to the texture
+		void GraphicsManager::DrawSprite( const TextureInfo& texture, const Sprite& sprite, const SpriteBatch::Transform& transform )
+		{
+			// Placeholder (still loading or failed): a translucent grey
+			// box the size of the section
+			if( texture.width == 0 )
+			{
+				if( sprite.section.IsEmpty() == false )
+				{
+					unsigned int color = Modulate( 0x80808080u, (unsigned int)sprite.color );
+					FillQuad( transform, sprite.section.ComputeWidth(), sprite.section.ComputeHeight(),
+							  Color{ (unsigned char)( color >> 24 ), (unsigned char)( color >> 16 ), (unsigned char)( color >> 8 ), (unsigned char)color } );
+				}
+				return;
+			}
+
+			int left	= 0;
+			int top		= 0;
+			int right	= (int)texture.width;
+			int bottom	= (int)texture.height;
+
+			if( sprite.section.IsEmpty() == false )
+			{
+				left	= std::max( left,	(int)sprite.section.left );
+				top		= std::max( top,	(int)sprite.section.top );
+				right	= std::min( right,	(int)sprite.section.right );
+				bottom	= std::min( bottom,	(int)sprite.section.bottom );
+			}
+
+			if( left >= right || top >= bottom || sprite.color.alpha == 0 )
+				return;
+
+
+			TextureSpan span;
+			span.texels		= &texture.pixels[ (size_t)top * texture.width + left ];
+			span.pitch		= texture.width;
+			span.maxU		= (float)( right - left - 1 );
+			span.maxV		= (float)( bottom - top - 1 );
+			span.color		= (unsigned int)sprite.color;
+			span.modulate	= span.color != 0xFFFFFFFFu;
+			span.additive	= sprite.blend == BlendMode::Additive;
+
+			m_ullPixels += RasterizeQuad( transform, (float)( right - left ), (float)( bottom - top ),
+										  m_vBack.data(), m_unWidth, m_unHeight, span );
+		}
+
+
+		//*************************************************************//
+		// FILL QUAD
+		void GraphicsManager::FillQuad( const SpriteBatch::Transform& transform, float width, float height, Color color )
+		{
+			if( color.alpha == 0 )
+				return;
+
+			SolidSpan span;
+			span.color = (unsigned int)color;
+
+			m_ullPixels += RasterizeQuad( transform, width, height,
+										  m_vBack.data(), m_unWidth, m_unHeight, span );
+		}
+
+
+		//*************************************************************//
+		// FRAME
+		unsigned int GraphicsManager::GetChecksum( void ) const
+		{
+			// FNV-1a
+			unsigned int hash = 2166136261u;
+			for( size_t i = 0; i < m_vFront.size(); i++ )
+			{
+				hash ^= m_vFront[ i ];
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+
+		bool GraphicsManager::SaveFrame( const char* filename ) const
+		{
+			FILE* pFile = fopen( filename, "wb" );
+			if( pFile == nullptr )
+				return false;
+
+			fprintf( pFile, "P6\n%u %u\n255\n", m_unWidth, m_unHeight );
+
+			std::vector< unsigned char > row( m_unWidth * 3 );
+			for( unsigned int y = 0; y < m_unHeight; y++ )
+			{
+				const unsigned int* pixels = &m_vFront[ (size_t)y * m_unWidth ];
+				for( unsigned int x = 0; x < m_unWidth; x++ )
+				{
+					row[ x * 3 + 0 ] = (unsigned char)( pixels[ x ] >> 16 );
+					row[ x * 3 + 1 ] = (unsigned char)( pixels[ x ] >> 8 );
+					row[ x * 3 + 2 ] = (unsigned char)( pixels[ x ] );
+				}
+
+				fwrite( row.data(), 1, row.size(), pFile );
+			}
+
+			fclose( pFile );
+			return true;
+		}
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
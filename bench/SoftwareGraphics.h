@@ -0,0 +1,162 @@
+//*********************************************************************//
+//	File:		SoftwareGraphics.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	CPU rasterizer GraphicsManager for rendering the game
+//				without Direct3D (profiling & screenshots on any host)
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_GraphicsManager.h"
+#include "../SGD Wrappers/SGD_HandleManager.h"
+#include "../SGD Wrappers/SGD_AssetIndex.h"
+#include "../SGD Wrappers/SGD_SpriteBatch.h"
+#include "../SGD Wrappers/SGD_TextureAtlas.h"
+#include "../SGD Wrappers/SGD_TextureLoader.h"
+
+#include <string>		// std::wstring type
+#include <vector>		// std::vector type
+
+
+namespace SGD
+{
+	namespace SGD_IMPLEMENTATION
+	{
+		//*************************************************************//
+		// GraphicsManager (software)
+		//	- draws into 32-bit ARGB frames in memory, the size of the
+		//	  window the game asks for
+		//	- textures are PNG files (DecodePng), colour-keyed like D3DX
+		//	  but not rounded up to a power of 2
+		//	- in atlas mode they are copied into shared pages, like the
+		//	  Direct3D implementation
+		//	- LoadTextureAsync decodes on the loader thread & Update
+		//	  swaps the image in (placeholders are translucent grey boxes)
+		//	- sprites are point sampled & modulated by their colour, with
+		//	  the Direct3D alpha & additive blend equations
+		//	- spans are blended 4 pixels at a time with SSE2 (scalar
+		//	  fallback otherwise, with identical results)
+		//	- DrawString is counted but draws nothing (no system font)
+		//	- SINGLETON (replaces the Direct3D implementation; built
+		//	  instead of the null one when SGD_SOFTWARE_GRAPHICS is defined)
+		class GraphicsManager : public SGD::GraphicsManager
+		{
+		public:
+			static	GraphicsManager*	GetInstance		( void );
+			static	void				DeleteInstance	( void );
+
+
+			virtual	bool		Initialize			( bool vsync = true )	override;
+			virtual	bool		Initialize			( const wchar_t* title, Size size = {1024,768}, bool vsync = true )	override;
+			virtual	bool		Update				( void )				override;
+			virtual	bool		Terminate			( void )				override;
+
+			virtual bool		SetClearColor		( Color color = {0,0,0} )				override	{	m_ClearColor = color;	return true;	}
+			virtual bool		SetPixelatedMode	( bool pixelated = true )				override	{	return true;	}
+			virtual bool		ShowCursor			( bool show = true )					override	{	return true;	}
+			virtual bool		ShowConsoleWindow	( bool show = true )					override	{	return true;	}
+			virtual bool		Resize				( Size size, bool windowed = true )		override;
+			virtual bool		IsForegroundWindow	( void )								override	{	return true;	}
+
+			virtual bool		DrawString			( const wchar_t* text, Point position,  Color color = {} )										override	{	return SubmitUntextured();	}
+			virtual bool		DrawString			( const char* text, Point position,  Color color = {} )											override	{	return SubmitUntextured();	}
+			virtual bool		DrawLine			( Point position1, Point position2, Color color = {}, unsigned int lineWidth = 3 )				override;
+			virtual bool		DrawRectangle		( Rectangle rect, Color fillColor, Color lineColor = {0,0,0,0}, unsigned int lineWidth = 3 )	override;
+
+			virtual	HTexture	LoadTexture			( const wchar_t* filename, Color colorKey = {0,0,0,0} )		override;
+			virtual	HTexture	LoadTexture			( const char* filename, Color colorKey = {0,0,0,0} )		override;
+			virtual	bool		DrawTexture			( HTexture handle, Point position, float rotation = 0.0f, Vector rotationOffset = {}, Color color = {}, Size scale = {1.0f, 1.0f} )						override;
+			virtual	bool		DrawTextureSection	( HTexture handle, Point position, Rectangle section, float rotation = 0.0f, Vector rotationOffset = {}, Color color = {}, Size scale = {1.0f, 1.0f} )	override;
+			virtual	bool		UnloadTexture		( HTexture& handle )										override;
+
+			virtual	bool		BeginBatch			( void )										override;
+			virtual	bool		EndBatch			( void )										override;
+			virtual	bool		DrawSprites			( const Sprite* sprites, unsigned int count )	override;
+
+			virtual	RenderStats	GetRenderStats		( void ) const									override	{	return m_Batch.GetStats();	}
+
+			virtual	bool		SetAtlasMode		( bool atlas = true, unsigned int pageSize = 2048 )	override;
+
+			virtual	HTexture	LoadTextureAsync	( const wchar_t* filename, Color colorKey = {0,0,0,0} )		override;
+			virtual	HTexture	LoadTextureAsync	( const char* filename, Color colorKey = {0,0,0,0} )		override;
+			virtual	bool		IsTextureLoaded		( HTexture handle )											override;
+			virtual	unsigned int	WaitForTextures	( const HTexture* handles, unsigned int count, unsigned int milliseconds = 0xFFFFFFFF )	override;
+
+
+			//*********************************************************//
+			// Frame:
+			//	- the frame presented by the last Update
+			//	  (0xAARRGGBB, top row first)
+			//	- GetChecksum hashes it, for comparing runs
+			const unsigned int*	GetFrame			( void ) const	{	return m_vFront.data();		}
+			unsigned int		GetFrameWidth		( void ) const	{	return m_unWidth;			}
+			unsigned int		GetFrameHeight		( void ) const	{	return m_unHeight;			}
+			unsigned int		GetChecksum			( void ) const;
+			bool				SaveFrame			( const char* filename ) const;		// binary .ppm
+
+			// Pixels blended since the start
+			unsigned long long	GetPixelsDrawn		( void ) const	{	return m_ullPixels;			}
+
+		private:
+			GraphicsManager		( void )						= default;
+			virtual	~GraphicsManager( void )					= default;
+
+			GraphicsManager		( const GraphicsManager& )		= delete;
+			GraphicsManager&	operator= ( const GraphicsManager& )	= delete;
+
+			static	GraphicsManager*	s_pInstance;
+
+
+			// Texture data
+			struct TextureInfo
+			{
+				std::wstring				filename;
+				unsigned int				refCount;
+				unsigned int				width;
+				unsigned int				height;
+				std::vector< unsigned int >	pixels;		// 0xAARRGGBB (empty when in an atlas page)
+				HTexture					page;		// atlas page (invalid when on its own)
+				TextureAtlas::Region		region;		// area in the atlas page
+				bool						loading	= false;	// queued on the loader thread (0 x 0 until then)
+			};
+
+
+			bool	AllocateFrames		( Size size );
+			bool	SubmitBatch			( void );
+			bool	SubmitUntextured	( void );		// DrawString, DrawLine & DrawRectangle
+
+			static	bool	DecodeFile	( void* context, const wchar_t* filename, Color colorKey, TextureInfo& image );
+			void	FinishLoads			( void );
+
+			bool	CopyToAtlas			( TextureInfo& data );
+			void	MapToAtlas			( Sprite* sprites, unsigned int count );
+			void	RemoveFromAtlas		( HTexture page, const TextureAtlas::Region& region );
+
+			void	DrawSprite			( const TextureInfo& texture, const Sprite& sprite, const SpriteBatch::Transform& transform );
+			void	FillQuad			( const SpriteBatch::Transform& transform, float width, float height, Color color );
+
+
+			HandleManager< TextureInfo >	m_HandleManager;
+			AssetIndex< HTexture >			m_Index;				// texture handles by file name
+			SpriteBatch						m_Batch;				// queued sprites & frame stats
+			bool							m_bBatching		= false;
+
+			TextureAtlas					m_Atlas;				// areas of the atlas pages
+			std::vector< HTexture >			m_vPages;				// atlas page textures (invalid when empty)
+			bool							m_bAtlas		= false;
+
+			TextureLoader< TextureInfo >	m_Loader;				// decodes LoadTextureAsync files
+
+			std::vector< unsigned int >		m_vBack;				// frame being drawn
+			std::vector< unsigned int >		m_vFront;				// frame presented by the last Update
+			unsigned int					m_unWidth		= 0;
+			unsigned int					m_unHeight		= 0;
+			Color							m_ClearColor	= Color{ 0, 0, 0 };
+
+			unsigned long long				m_ullPixels		= 0;
+		};
+
+	}	// namespace SGD_IMPLEMENTATION
+
+}	// namespace SGD
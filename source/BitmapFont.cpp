@@ -44,9 +44,10 @@ void BitmapFont::Terminate( void )
 
 //*********************************************************************//
 // Draw
-//	- render the array of characters, one-at-a-time,
-//	  using the Cell Algorithm to calculate the source rect
-//	  of the glyph within the image
+//	- render the array of characters using the Cell Algorithm
+//	  to calculate the source rect of the glyph within the image
+//	- the glyphs are submitted together (DrawSprites), up to
+//	  MAX_GLYPHS at a time
 void BitmapFont::Draw( const char* output, SGD::Point position, float scale, SGD::Color color ) const
 {
 	// Validate the image
@@ -67,6 +68,10 @@ void BitmapFont::Draw( const char* output, SGD::Point position, float scale, SGD
 	// Store the starting x
 	float startX = position.x;
 
+	// Glyphs waiting to be drawn
+	SGD::Sprite glyphs[ MAX_GLYPHS ];
+	unsigned int numGlyphs = 0;
+
 
 	// Loop through the string, until hitting null terminator
 	for( unsigned int i = 0; output[ i ] != '\0'; i++ )
@@ -125,26 +130,37 @@ void BitmapFont::Draw( const char* output, SGD::Point position, float scale, SGD
 		cell.bottom = cell.top  + m_nCharHeight;
 
 
-		// Draw the character section
-		SGD::GraphicsManager::GetInstance()->DrawTextureSection(
-			m_hImage,
-			position,
-			cell,
-			0.0f, {},
-			color,
-			{ scale, scale } );
+		// Add the character section
+		SGD::Sprite& glyph = glyphs[ numGlyphs++ ];
+		glyph.handle	= m_hImage;
+		glyph.position	= position;
+		glyph.section	= cell;
+		glyph.color		= color;
+		glyph.scale		= { scale, scale };
+
+		// Draw the full set
+		if( numGlyphs == MAX_GLYPHS )
+		{
+			SGD::GraphicsManager::GetInstance()->DrawSprites( glyphs, numGlyphs );
+			numGlyphs = 0;
+		}
 
 		
 		// Move to the next position on screen
 		position.x += m_nCharWidth * scale;
 	}
+
+	// Draw the remaining characters
+	if( numGlyphs > 0 )
+		SGD::GraphicsManager::GetInstance()->DrawSprites( glyphs, numGlyphs );
 }
 
 //*********************************************************************//
 // Draw
-//	- render the array of characters, one-at-a-time,
-//	  using the Cell Algorithm to calculate the source rect
-//	  of the glyph within the image
+//	- render the array of characters using the Cell Algorithm
+//	  to calculate the source rect of the glyph within the image
+//	- the glyphs are submitted together (DrawSprites), up to
+//	  MAX_GLYPHS at a time
 void BitmapFont::Draw( const wchar_t* output, SGD::Point position, float scale, SGD::Color color ) const
 {
 	// Validate the image
@@ -165,6 +181,10 @@ void BitmapFont::Draw( const wchar_t* output, SGD::Point position, float scale,
 	// Store the starting x
 	float startX = position.x;
 
+	// Glyphs waiting to be drawn
+	SGD::Sprite glyphs[ MAX_GLYPHS ];
+	unsigned int numGlyphs = 0;
+
 
 	// Loop through the string, until hitting null terminator
 	for( unsigned int i = 0; output[ i ] != '\0'; i++ )
@@ -224,17 +244,27 @@ void BitmapFont::Draw( const wchar_t* output, SGD::Point position, float scale,
 		cell.bottom = cell.top  + m_nCharHeight;
 
 
-		// Draw the character section
-		SGD::GraphicsManager::GetInstance()->DrawTextureSection(
-			m_hImage,
-			position,
-			cell,
-			0.0f, {},
-			color,
-			{ scale, scale } );
+		// Add the character section
+		SGD::Sprite& glyph = glyphs[ numGlyphs++ ];
+		glyph.handle	= m_hImage;
+		glyph.position	= position;
+		glyph.section	= cell;
+		glyph.color		= color;
+		glyph.scale		= { scale, scale };
+
+		// Draw the full set
+		if( numGlyphs == MAX_GLYPHS )
+		{
+			SGD::GraphicsManager::GetInstance()->DrawSprites( glyphs, numGlyphs );
+			numGlyphs = 0;
+		}
 
 		
 		// Move to the next position on screen
 		position.x += m_nCharWidth * scale;
 	}
+
+	// Draw the remaining characters
+	if( numGlyphs > 0 )
+		SGD::GraphicsManager::GetInstance()->DrawSprites( glyphs, numGlyphs );
 }
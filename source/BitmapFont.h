@@ -43,6 +43,10 @@ public:
 	void Draw( const wchar_t* output, SGD::Point position, float scale = 1.0f, SGD::Color color = { } ) const;
 
 private:
+	//*****************************************************************//
+	// Glyphs per DrawSprites submission
+	enum { MAX_GLYPHS = 64 };
+
 	//*****************************************************************//
 	// image
 	SGD::HTexture	m_hImage			= SGD::INVALID_HANDLE;
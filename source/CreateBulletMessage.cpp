@@ -6,18 +6,10 @@
 //*********************************************************************//
 
 #include "CreateBulletMessage.h"
-#include "MessageID.h"
-#include "Player.h"
+#include "Entity.h"
 
-CreateBulletMessage::CreateBulletMessage(Entity* player) : Message(MessageID::MSG_CREATE_BULLET)
+CreateBulletMessage::CreateBulletMessage(Entity* player)
 {
-	m_tBulletOwner = player;
-	player->AddRef();
-}
-
-
-CreateBulletMessage::~CreateBulletMessage()
-{
-	m_tBulletOwner->Release();
+	m_hBulletOwner = player->GetHandle();
 }
 
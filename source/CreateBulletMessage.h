@@ -5,22 +5,27 @@
 //	Purpose:	Creates a bullet message.
 //*********************************************************************//
 #pragma once
-#include "../SGD Wrappers/SGD_Message.h"
-#include "Player.h"
+#include "HEntity.h"
+#include "MessageID.h"
+class Entity;
 
 
-class CreateBulletMessage :
-	public SGD::Message
+//*********************************************************************//
+// CreateBulletMessage class
+//	- queued by value on the MessageBus (keep it trivially copyable)
+class CreateBulletMessage
 {
 public:
+	static const MessageID ID = MessageID::MSG_CREATE_BULLET;	// MessageBus type
+
 	CreateBulletMessage(Entity* player);
-	~CreateBulletMessage();
 
 	// access
-	Entity* GetBulletOwner() const { return m_tBulletOwner; }
+	//	- the owner may be gone by the time the message is processed
+	HEntity GetBulletOwner() const { return m_hBulletOwner; }
 
 private:
 
-	Entity* m_tBulletOwner = nullptr;
+	HEntity m_hBulletOwner;
 };
 
@@ -4,34 +4,38 @@
 //	Course:		SGD 1505
 //	Purpose:	DestroyEntityMessage class stores the Entity to remove
 //				from the Entity Manager
-//				This message will be queued into the Message Manager
+//				This message will be queued on the MessageBus
 //				and processed by the Game.
 //*********************************************************************//
 
 #pragma once
 
-#include "../SGD Wrappers/SGD_Message.h"
+#include "HEntity.h"
+#include "MessageID.h"
 class Entity;
 
 
 //*********************************************************************//
 // DestroyEntityMessage class
-//	- stores the entity to be removed from the Entity Manager
-class DestroyEntityMessage : public SGD::Message
+//	- stores the handle of the entity to be removed from the Entity Manager
+//	- does not keep the entity alive
+//	- queued by value on the MessageBus (keep it trivially copyable)
+class DestroyEntityMessage
 {
 public:
+	static const MessageID ID = MessageID::MSG_DESTROY_ENTITY;	// MessageBus type
+
 	//*****************************************************************//
 	// Constructor MUST be given the entity to destroy!
 	DestroyEntityMessage( Entity* ptr );
-	virtual ~DestroyEntityMessage();
 	
 	//*****************************************************************//
 	// Accessor:
-	Entity*		GetEntity( void ) const	{	return m_pEntity;	}
+	HEntity		GetEntity( void ) const	{	return m_hEntity;	}
 
 private:
 	//*****************************************************************//
 	// Entity to remove from the Entity Manager
-	Entity*		m_pEntity	= nullptr;
+	HEntity		m_hEntity;
 };
 
@@ -8,7 +8,8 @@
 #include "Game.h"
 #include "GameplayState.h"
 #include "Player.h"
-#include "DestroyEntityMessage.h"
+#include "EntityManager.h"
+#include "GameEvents.h"
 
 #include "../SGD Wrappers/SGD_GraphicsManager.h"
 #include "../SGD Wrappers/SGD_AudioManager.h"
@@ -18,8 +19,8 @@
 
 Enemy::Enemy()
 {
-	RegisterForEvent("ENEMY_HIT");
-	RegisterForEvent("ENEMY_DESTROYED");
+	RegisterForEvent(GameEvent::ENEMY_HIT);
+	RegisterForEvent(GameEvent::ENEMY_DESTROYED);
 }
 
 
@@ -30,7 +31,7 @@ Enemy::~Enemy()
 void Enemy::Render(void)
 {
 	SGD::GraphicsManager::GetInstance()->DrawTextureSection(GetImage(), 
-		SGD::Point{GetPosition()},
+		SGD::Point{GetRenderPosition()},
 		SGD::Rectangle{ 0, 0, 64, 80 }, 0.0f, {}, {}, SGD::Size{ -2.0f, 2.0f });
 }
 
@@ -43,17 +44,16 @@ void Enemy::Update(float elapsedTime)
 			SetPosition(SGD::Point{ GetPosition().x - GetVelocity().x * elapsedTime * 60, GetPosition().y });
 			if (GetPosition().x <= 0 + GetSize().width * 1.5f)
 			{
-				m_ptPosition.x = GetSize().width * 1.5f; 
-				SGD::Event* Event = new SGD::Event("GAME_OVER", nullptr, this);
+				SetPosition(SGD::Point{ GetSize().width * 1.5f, GetPosition().y }); 
+				SGD::Event* Event = new SGD::Event(GameEvent::GAME_OVER, nullptr, this);
 				SGD::EventManager::GetInstance()->QueueEvent(Event);
 			}
 
 			if (GetNumHitsTaken() >= 3)
 			{
- 				SGD::Event* Event = new SGD::Event("ENEMY_DESTROYED", nullptr, this);
+ 				SGD::Event* Event = new SGD::Event(GameEvent::ENEMY_DESTROYED, nullptr, this);
 				SGD::EventManager::GetInstance()->QueueEvent(Event);
-				DestroyEntityMessage* msg = new DestroyEntityMessage(this);
-				msg->QueueMessage();
+				GameplayState::GetInstance()->GetEntityManager()->DestroyEntity(this);
 				Game::GetInstance()->SetNumEnemies(Game::GetInstance()->GetNumEnemies() - 1);
 				if (Game::GetInstance()->GetNumEnemies() <= 0)
 					Game::GetInstance()->SetVictory(true);
@@ -68,16 +68,18 @@ void Enemy::Update(float elapsedTime)
 
 void Enemy::HandleEvent(const SGD::Event* pEvent)
 {
-	if (pEvent->GetEventID() == "ENEMY_HIT")
+	if (pEvent->GetEventID() == GameEvent::ENEMY_HIT)
 	{
+		// One (coalesced) event for all of this frame's hits,
+		// the first of them takes the double damage
+		unsigned int hits = pEvent->GetCount();
 		if (GameplayState::GetInstance()->DoubleDmg())
 		{
-			SetNumHitsTaken(GetNumHitsTaken() + 2);
+			hits += 1;
 			GameplayState::GetInstance()->SetDoubleDmg(false);
 		}
-			
-		else
-			SetNumHitsTaken(GetNumHitsTaken() + 1);
+
+		SetNumHitsTaken(GetNumHitsTaken() + hits);
 		SGD::AudioManager::GetInstance()->PlayAudio(GetEnemyHitSfx());
 	}
 	
@@ -87,11 +89,11 @@ void Enemy::HandleEvent(const SGD::Event* pEvent)
 void Enemy::KeepEnemyInBounds()
 {
 	if (GetPosition().x <= 0)
-		m_ptPosition.x = 0;
+		SetPosition(SGD::Point{ 0, GetPosition().y });
 	if (GetPosition().x > Game::GetInstance()->GetScreenSize().width - GetSize().width * 2.0f)
-		m_ptPosition.x = Game::GetInstance()->GetScreenSize().width - GetSize().width * 2.0f;
+		SetPosition(SGD::Point{ Game::GetInstance()->GetScreenSize().width - GetSize().width * 2.0f, GetPosition().y });
 	if (GetPosition().y <= 0)
-		m_ptPosition.y = 0;
+		SetPosition(SGD::Point{ GetPosition().x, 0 });
 	if (GetPosition().y > Game::GetInstance()->GetScreenSize().height - GetSize().height * 2.0f)
-		m_ptPosition.y = Game::GetInstance()->GetScreenSize().height - GetSize().height * 2.0f;
+		SetPosition(SGD::Point{ GetPosition().x, Game::GetInstance()->GetScreenSize().height - GetSize().height * 2.0f });
 }
\ No newline at end of file
@@ -18,7 +18,11 @@
 //	  (given that velocity is the rate of change in pixels-per-second)
 /*virtual*/ void Entity::Update( float elapsedTime )	/*override*/
 {
-	m_ptPosition += m_vtVelocity * elapsedTime;
+	// The store moves every attached entity at once
+	if( m_pTransforms != nullptr )
+		m_pTransforms->Step( m_unTransform, elapsedTime );
+	else
+		m_ptPosition += m_vtVelocity * elapsedTime;
 }
 
 //*********************************************************************//
@@ -35,8 +39,8 @@
 	
 	// Draw the image
 	SGD::GraphicsManager::GetInstance()->DrawTexture( 
-		m_hImage, m_ptPosition,
-		m_fRotation, m_szSize / 2 );
+		m_hImage, GetRenderPosition(),
+		m_fRotation, GetSize() / 2 );
 }
 
 
@@ -45,6 +49,9 @@
 //	- calculate the entity's bounding rectangle
 /*virtual*/ SGD::Rectangle Entity::GetRect( void ) const	/*override*/
 {
+	if( m_pTransforms != nullptr )
+		return m_pTransforms->GetRect( m_unTransform );
+
 	return SGD::Rectangle{ m_ptPosition, m_szSize };
 }
 
@@ -81,3 +88,61 @@
 	if( m_unRefCount == 0 )
 		delete this;
 }
+
+
+//*********************************************************************//
+// GetDisplacement
+//	- movement since the start of the Entity Manager's last update
+//	  (zero while detached)
+/*virtual*/ SGD::Vector Entity::GetDisplacement( void ) const	/*final*/
+{
+	if( m_pTransforms == nullptr )
+		return SGD::Vector{ 0, 0 };
+
+	return m_pTransforms->GetPosition( m_unTransform ) - m_pTransforms->GetPreviousPosition( m_unTransform );
+}
+
+
+//*********************************************************************//
+// AttachTransform
+//	- move the transform into the store's arrays
+//	- attaching to the same store again only counts the attachment
+/*virtual*/ void Entity::AttachTransform( TransformStore* pStore )	/*final*/
+{
+	// Validate the parameter
+	SGD_ASSERT( pStore != nullptr,
+		"Entity::AttachTransform - store cannot be null" );
+	SGD_ASSERT( m_pTransforms == nullptr || m_pTransforms == pStore,
+		"Entity::AttachTransform - already attached to another store" );
+	if( pStore == nullptr || ( m_pTransforms != nullptr && m_pTransforms != pStore ) )
+		return;
+
+	if( m_unAttachCount++ > 0 )
+		return;
+
+	m_unTransform = pStore->Allocate( m_ptPosition, m_vtVelocity, m_szSize );
+	m_pTransforms = pStore;
+}
+
+
+//*********************************************************************//
+// DetachTransform
+//	- copy the transform back from the store after the
+//	  last attachment is released
+/*virtual*/ void Entity::DetachTransform( void )	/*final*/
+{
+	SGD_ASSERT( m_unAttachCount > 0,
+		"Entity::DetachTransform - entity is not attached" );
+	if( m_unAttachCount == 0 )
+		return;
+
+	if( --m_unAttachCount > 0 )
+		return;
+
+	m_ptPosition	= m_pTransforms->GetPosition( m_unTransform );
+	m_vtVelocity	= m_pTransforms->GetVelocity( m_unTransform );
+	m_szSize		= m_pTransforms->GetSize( m_unTransform );
+
+	m_pTransforms->Free( m_unTransform );
+	m_pTransforms = nullptr;
+}
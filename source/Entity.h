@@ -11,6 +11,7 @@
 #include "IEntity.h"						// IEntity type
 #include "../SGD Wrappers/SGD_Handle.h"		// HTexture type
 #include "../SGD Wrappers/SGD_Geometry.h"	// Point & Vector type
+#include "TransformStore.h"					// TransformStore type
 
 
 //*********************************************************************//
@@ -44,6 +45,7 @@ public:
 	virtual int		GetType			( void )	const			override	{	return ENT_BASE;	}
 	virtual SGD::Rectangle GetRect	( void )	const			override;
 	virtual void	HandleCollision	( const IEntity* pOther )	override;
+	virtual SGD::Vector GetDisplacement( void ) const		final;
 	
 
 	//*****************************************************************//
@@ -52,22 +54,37 @@ public:
 	virtual void	Release		( void )				final;
 
 
+	//*****************************************************************//
+	// Transform Storage:
+	//	- while attached, position, velocity & size live in the store
+	virtual void	AttachTransform	( TransformStore* pStore )	final;
+	virtual void	DetachTransform	( void )					final;
+
+
+	//*****************************************************************//
+	// Storage:
+	virtual StorageSlot	GetStorageSlot	( void ) const				final	{	return m_Slot;	}
+	virtual void		SetStorageSlot	( const StorageSlot& slot )	final	{	m_Slot = slot;	}
+	HEntity				GetHandle		( void ) const						{	return m_Slot.handle;	}	// INVALID_HANDLE when not stored
+
+
 	//*****************************************************************//
 	// Accessors:
 	SGD::HTexture	GetImage	( void ) const			{	return m_hImage;		}
-	SGD::Point		GetPosition	( void ) const			{	return m_ptPosition;	}
-	SGD::Vector		GetVelocity	( void ) const			{	return m_vtVelocity;	}
+	SGD::Point		GetPosition	( void ) const			{	return ( m_pTransforms != nullptr ) ? m_pTransforms->GetPosition( m_unTransform ) : m_ptPosition;	}
+	SGD::Point		GetRenderPosition( void ) const		{	return ( m_pTransforms != nullptr ) ? m_pTransforms->GetBlendedPosition( m_unTransform ) : m_ptPosition;	}	// blended for drawing
+	SGD::Vector		GetVelocity	( void ) const			{	return ( m_pTransforms != nullptr ) ? m_pTransforms->GetVelocity( m_unTransform ) : m_vtVelocity;	}
 	SGD::Vector GetAcceleration(void) const { return m_vtAcceleration; }
-	SGD::Size		GetSize		( void ) const			{	return m_szSize;		}
+	SGD::Size		GetSize		( void ) const			{	return ( m_pTransforms != nullptr ) ? m_pTransforms->GetSize( m_unTransform ) : m_szSize;			}
 	float			GetRotation	( void ) const			{	return m_fRotation;		}
 	float GetSpeed(void) const { return m_fSpeed; }
 	WeaponType GetWeaponType() const { return m_wtWeapon; }
 
 	// Mutators:
 	void			SetImage	( SGD::HTexture	img  )	{	m_hImage		= img;	}
-	void			SetPosition	( SGD::Point	pos  ) 	{	m_ptPosition	= pos;	}
-	void			SetVelocity	( SGD::Vector	vel	 ) 	{	m_vtVelocity	= vel;	}
-	void			SetSize		( SGD::Size		size ) 	{	m_szSize		= size;	}
+	void			SetPosition	( SGD::Point	pos  ) 	{	if( m_pTransforms != nullptr ) m_pTransforms->SetPosition( m_unTransform, pos );	else m_ptPosition	= pos;	}
+	void			SetVelocity	( SGD::Vector	vel	 ) 	{	if( m_pTransforms != nullptr ) m_pTransforms->SetVelocity( m_unTransform, vel );	else m_vtVelocity	= vel;	}
+	void			SetSize		( SGD::Size		size ) 	{	if( m_pTransforms != nullptr ) m_pTransforms->SetSize( m_unTransform, size );		else m_szSize		= size;	}
 	void			SetRotation	( float			rad	 )	{	m_fRotation		= rad;	}
 	void SetAcceleration(SGD::Vector _acc) { m_vtAcceleration = _acc; }
 	void SetSpeed(float _speed) { m_fSpeed = _speed; }
@@ -77,15 +94,26 @@ protected:
 	//*****************************************************************//
 	// Shared members:
 	SGD::HTexture	m_hImage		= SGD::INVALID_HANDLE;	// image handle
-	SGD::Point		m_ptPosition	= SGD::Point{ 0, 0 };	// 2D position
-	SGD::Vector		m_vtVelocity	= SGD::Vector{ 0, 0 };	// 2D velocity
-	SGD::Size		m_szSize		= SGD::Size{ 0, 0 };	// 2D size
 	float			m_fRotation		= 0.0f;
 	float m_fSpeed = 0.0f;
 
 	SGD::Vector m_vtAcceleration = SGD::Vector{ 0, 0 };
 
 private:
+	//*****************************************************************//
+	// transform while detached (use the accessors!)
+	SGD::Point		m_ptPosition	= SGD::Point{ 0, 0 };	// 2D position
+	SGD::Vector		m_vtVelocity	= SGD::Vector{ 0, 0 };	// 2D velocity
+	SGD::Size		m_szSize		= SGD::Size{ 0, 0 };	// 2D size
+
+	// transform while attached
+	TransformStore*	m_pTransforms	= nullptr;				// owner's store
+	unsigned int	m_unTransform	= 0;					// slot within the store
+	unsigned int	m_unAttachCount	= 0;					// times attached to the store
+
+	// location within the Entity Manager
+	StorageSlot		m_Slot;
+
 	//*****************************************************************//
 	// reference count
 	unsigned int	m_unRefCount	= 1;	// calling new gives the 'prime' reference
@@ -8,30 +8,63 @@
 #include "EntityManager.h"
 
 #include "../SGD Wrappers/SGD_Utilities.h"
+#include "../SGD Wrappers/SGD_HandleManager.h"
+#include "../SGD Wrappers/SGD_GraphicsManager.h"
+#include "../SGD Wrappers/SGD_EventManager.h"
+#include "../SGD Wrappers/SGD_MessageBus.h"
 #include "IEntity.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+
+//*********************************************************************//
+// Chunk being updated by the calling thread (parallel updates only)
+static SGD_THREAD_LOCAL unsigned int s_unUpdateChunk = 0xFFFFFFFF;
 
 
 //*********************************************************************//
 // AddEntity
 //	- store the entity into the specified bucket
 //	- the Entity Manager holds a reference to the entity
+//	- an entity can only be stored once
 void EntityManager::AddEntity( IEntity* pEntity, unsigned int bucket )
 {
 	// Validate the parameter
 	SGD_ASSERT( pEntity != nullptr,
 				"EntityManager::AddEntity - parameter cannot be null" );
+	SGD_ASSERT( pEntity->GetStorageSlot().bucket == IEntity::StorageSlot::INVALID,
+				"EntityManager::AddEntity - entity is already stored" );
+	if( pEntity == nullptr || pEntity->GetStorageSlot().bucket != IEntity::StorageSlot::INVALID )
+		return;
 
 
 	// Expand the table?
 	if( bucket >= m_tEntities.size() )
+	{
 		m_tEntities.resize( bucket +1 );
+		m_vSweeps.resize( bucket +1 );
+	}
 
 
 	// Append the entity into the specified vector
-	m_tEntities[ bucket ].push_back( pEntity );
+	EntityVector& vec = m_tEntities[ bucket ];
+	vec.push_back( pEntity );
+	m_vSweeps[ bucket ].Invalidate();
+
+	// Remember where it is stored
+	IEntity::StorageSlot slot;
+	slot.bucket	= bucket;
+	slot.index	= vec.size() - 1;
+	slot.handle	= AllocateHandle( pEntity );
+	pEntity->SetStorageSlot( slot );
 
 	// Hold a reference to keep the entity in memory
 	pEntity->AddRef();
+
+	// Move the entity's transform into the store
+	pEntity->AttachTransform( &m_Transforms );
 }
 
 
@@ -39,63 +72,111 @@ void EntityManager::AddEntity( IEntity* pEntity, unsigned int bucket )
 // RemoveEntity
 //	- remove the entity from the specified bucket
 //	- release the reference to the entity
+//	- removal is deferred while iterating
 void EntityManager::RemoveEntity( IEntity* pEntity, unsigned int bucket )
 {
-	// Validate the iteration state
-	SGD_ASSERT( m_bIterating == false,
-				"EntityManager::RemoveEntity - cannot remove while iterating" );
-
 	// Validate the parameters
 	SGD_ASSERT( pEntity != nullptr,
 				"EntityManager::RemoveEntity - cannot remove NULL" );
 	SGD_ASSERT( bucket < m_tEntities.size(),
 				"EntityManager::RemoveEntity - invalid bucket" );
+	if( pEntity == nullptr )
+		return;
 
+	// Is the entity stored in that bucket?
+	if( pEntity->GetStorageSlot().bucket != bucket )
+		return;
 
-	// Try to find the entity
-	EntityVector& vec = m_tEntities[ bucket ];
-	for( unsigned int i = 0; i < vec.size(); i++ )
-	{
-		if( vec[ i ] == pEntity )
-		{
-			// Remove the entity
-			vec.erase( vec.begin() + i );
-			pEntity->Release();
-			break;
-		}
-	}
+	RemoveEntity( pEntity );
 }
 
 
 //*********************************************************************//
 // RemoveEntity
 //	- remove & release the entity from any bucket
+//	- removal is deferred while iterating
 void EntityManager::RemoveEntity( IEntity* pEntity )
 {
-	// Validate the iteration state
-	SGD_ASSERT( m_bIterating == false,
-				"EntityManager::RemoveEntity - cannot remove while iterating" );
-
 	// Validate the parameters
 	SGD_ASSERT( pEntity != nullptr,
 				"EntityManager::RemoveEntity - pointer cannot be null" );
+	if( pEntity == nullptr )
+		return;
 
 
-	// Try to find the entity in any buckect
-	for( unsigned int bucket = 0; bucket < m_tEntities.size(); bucket++ )
+	// Cannot change the buckets while iterating
+	if( m_bIterating == true )
 	{
-		EntityVector& vec = m_tEntities[ bucket ];
-		for( unsigned int i = 0; i < vec.size(); i++ )
-		{
-			if( vec[ i ] == pEntity )
-			{
-				// Remove the entity
-				vec.erase( vec.begin() + i );
-				pEntity->Release();
-				return;
-			}
-		}
+		DestroyEntity( pEntity );
+		return;
+	}
+
+	Unstore( pEntity );
+}
+
+
+//*********************************************************************//
+// DestroyEntity
+//	- queue the entity to be removed once the current
+//	  UpdateAll / CheckCollisions has finished
+//	- safe to call while iterating (e.g. from Update or HandleCollision)
+//	- queuing the same entity again is ignored
+void EntityManager::DestroyEntity( IEntity* pEntity )
+{
+	// Validate the parameter
+	SGD_ASSERT( pEntity != nullptr,
+				"EntityManager::DestroyEntity - pointer cannot be null" );
+	if( pEntity == nullptr )
+		return;
+
+	// Called from a parallel update job?
+	//	collect per chunk, queued in chunk order afterwards
+	if( m_bParallelUpdate == true && s_unUpdateChunk < m_vChunkDestroyed.size() )
+	{
+		m_vChunkDestroyed[ s_unUpdateChunk ].push_back( pEntity );
+		return;
+	}
+
+	// Ignore entities that are not stored, or already queued
+	IEntity::StorageSlot slot = pEntity->GetStorageSlot();
+	if( slot.bucket >= m_tEntities.size()
+		|| slot.destroyPending == true )
+		return;
+
+	slot.destroyPending = true;
+	pEntity->SetStorageSlot( slot );
+
+	// Hold a reference until the queue is flushed
+	m_vDestroyed.push_back( pEntity );
+	pEntity->AddRef();
+}
+
+
+//*********************************************************************//
+// FlushDestroyed
+//	- remove every entity queued by DestroyEntity
+void EntityManager::FlushDestroyed( void )
+{
+	// Validate the iteration state
+	SGD_ASSERT( m_bIterating == false,
+				"EntityManager::FlushDestroyed - cannot remove while iterating" );
+	if( m_bIterating == true )
+		return;
+
+
+	for( unsigned int i = 0; i < m_vDestroyed.size(); i++ )
+	{
+		IEntity* pEntity = m_vDestroyed[ i ];
+
+		// Still waiting for removal?
+		//	(it may have been removed directly in the meantime)
+		if( pEntity->GetStorageSlot().destroyPending == true )
+			Unstore( pEntity );
+
+		pEntity->Release();
 	}
+
+	m_vDestroyed.clear();
 }
 
 
@@ -111,6 +192,8 @@ void EntityManager::RemoveAll( unsigned int unBucket )
 	// Validate the parameter
 	SGD_ASSERT( unBucket < m_tEntities.size(),
 				"EntityManager::RemoveAll - invalid bucket" );
+	if( unBucket >= m_tEntities.size() )
+		return;
 
 	
 	// Lock the iterator
@@ -120,11 +203,15 @@ void EntityManager::RemoveAll( unsigned int unBucket )
 		EntityVector& vec = m_tEntities[ unBucket ];
 		for( unsigned int i = 0; i < vec.size(); i++ )
 		{
+			FreeHandle( vec[ i ]->GetStorageSlot().handle );
+			vec[ i ]->SetStorageSlot( IEntity::StorageSlot() );
+			vec[ i ]->DetachTransform();
 			vec[ i ]->Release();
 			vec[ i ] = nullptr;
 		}
 
 		vec.clear();
+		m_vSweeps[ unBucket ].Invalidate();
 	}
 	// Unlock the iterator
 	m_bIterating = false;
@@ -150,6 +237,9 @@ void EntityManager::RemoveAll( void )
 			EntityVector& vec = m_tEntities[ bucket ];
 			for( unsigned int i = 0; i < vec.size( ); i++ )
 			{
+				FreeHandle( vec[ i ]->GetStorageSlot().handle );
+				vec[ i ]->SetStorageSlot( IEntity::StorageSlot() );
+				vec[ i ]->DetachTransform( );
 				vec[ i ]->Release( );
 				vec[ i ] = nullptr;
 			}
@@ -161,46 +251,269 @@ void EntityManager::RemoveAll( void )
 
 	// Collapse the table
 	m_tEntities.clear();
+	m_vSweeps.clear();
+
+	// Nothing left to destroy
+	FlushDestroyed();
+}
+
+
+//*********************************************************************//
+// Unstore
+//	- swap the entity with the last one in its bucket, then pop
+//	- release the reference to the entity
+//	- the iterator MUST NOT be locked
+void EntityManager::Unstore( IEntity* pEntity )
+{
+	IEntity::StorageSlot slot = pEntity->GetStorageSlot();
+
+	// Is the entity stored?
+	if( slot.bucket >= m_tEntities.size() )
+		return;
+
+	EntityVector& vec = m_tEntities[ slot.bucket ];
+	SGD_ASSERT( slot.index < vec.size() && vec[ slot.index ] == pEntity,
+				"EntityManager::Unstore - storage slot is out of sync" );
+	if( slot.index >= vec.size() || vec[ slot.index ] != pEntity )
+		return;
+
+
+	// Move the last entity into the hole
+	if( slot.index != vec.size() - 1 )
+	{
+		IEntity* pLast = vec.back();
+		vec[ slot.index ] = pLast;
+
+		IEntity::StorageSlot lastSlot = pLast->GetStorageSlot();
+		lastSlot.index = slot.index;
+		pLast->SetStorageSlot( lastSlot );
+	}
+	vec.pop_back();
+	m_vSweeps[ slot.bucket ].Invalidate();
+
+
+	// Forget the slot & release the entity
+	FreeHandle( slot.handle );
+	pEntity->SetStorageSlot( IEntity::StorageSlot() );
+	pEntity->DetachTransform();
+	pEntity->Release();
+}
+
+
+//*********************************************************************//
+// GetEntity
+//	- find the entity identified by the handle
+//	- return nullptr if the handle is stale (the entity was removed)
+IEntity* EntityManager::GetEntity( HEntity handle ) const
+{
+	if( handle == SGD::INVALID_HANDLE )
+		return nullptr;
+
+	unsigned int index = SGD::SGD_IMPLEMENTATION::HandleDecoder::HandleToIndex( handle );
+	if( index >= m_vHandles.size() || m_vHandles[ index ].handle != handle )
+		return nullptr;
+
+	return m_vHandles[ index ].pEntity;
+}
+
+
+//*********************************************************************//
+// AllocateHandle
+//	- recycle the oldest freed index with its next reuse number,
+//	  or append a new index
+HEntity EntityManager::AllocateHandle( IEntity* pEntity )
+{
+	using SGD::SGD_IMPLEMENTATION::HandleDecoder;
+
+	HEntity handle;
+	if( m_dFreeHandles.size() >= MIN_FREE_HANDLES )
+	{
+		handle = HandleDecoder::ReuseHandle( m_dFreeHandles.front() );
+		m_dFreeHandles.pop_front();
+	}
+	else
+	{
+		handle = HandleDecoder::CreateHandle( 1, m_vHandles.size() );
+		SGD_ASSERT( handle != SGD::INVALID_HANDLE,
+					"EntityManager::AllocateHandle - out of handles" );
+		if( handle == SGD::INVALID_HANDLE )
+			return handle;
+
+		m_vHandles.push_back( HandleSlot() );
+	}
+
+	HandleSlot& slot = m_vHandles[ HandleDecoder::HandleToIndex( handle ) ];
+	slot.handle		= handle;
+	slot.pEntity	= pEntity;
+	return handle;
+}
+
+
+//*********************************************************************//
+// FreeHandle
+//	- invalidate the handle, queue its index for reuse
+void EntityManager::FreeHandle( HEntity handle )
+{
+	if( handle == SGD::INVALID_HANDLE )
+		return;
+
+	HandleSlot& slot = m_vHandles[ SGD::SGD_IMPLEMENTATION::HandleDecoder::HandleToIndex( handle ) ];
+	slot.handle		= SGD::INVALID_HANDLE;
+	slot.pEntity	= nullptr;
+
+	m_dFreeHandles.push_back( handle );
 }
 
 
 //*********************************************************************//
 // UpdateAll
 //	- update each entity in the table
+//	- then integrate the velocities of the stored transforms
+//	- then remove the destroyed entities
 void EntityManager::UpdateAll( float elapsedTime )
 {
+	PROFILE_SCOPE( "EntityManager::UpdateAll" );
+
 	// Validate the iteration state
 	SGD_ASSERT( m_bIterating == false,
 				"EntityManager::UpdateAll - cannot update while iterating" );
 	
+	// Start counting collision stats for the new frame
+	m_unPairTests	= 0;
+	m_unCollisions	= 0;
+
 	// Lock the iterator
 	m_bIterating = true;
 	{
+		// Measure this update's movement from here
+		m_Transforms.SavePrevious();
+
 		// Update every entity
 		for( unsigned int bucket = 0; bucket < m_tEntities.size( ); bucket++ )
 		{
 			EntityVector& vec = m_tEntities[ bucket ];
+
+			if( bucket < m_vParallel.size() && m_vParallel[ bucket ] == true )
+			{
+				UpdateParallel( vec, elapsedTime );
+				continue;
+			}
+
 			for( unsigned int i = 0; i < vec.size( ); i++ )
 				vec[ i ]->Update( elapsedTime );
 		}
+
+		// Move every entity that requested it in one pass
+		m_Transforms.Integrate();
 	}
 	// Unlock the iterator
 	m_bIterating = false;
+
+	// Remove the entities destroyed during the updates
+	FlushDestroyed();
+}
+
+
+//*********************************************************************//
+// SetParallelUpdate
+//	- choose whether the bucket is updated by the JobSystem
+void EntityManager::SetParallelUpdate( unsigned int bucket, bool parallel )
+{
+	if( bucket >= m_vParallel.size() )
+		m_vParallel.resize( bucket + 1, false );
+
+	m_vParallel[ bucket ] = parallel;
+}
+
+
+//*********************************************************************//
+// UpdateParallel
+//	- update the bucket in chunks across the JobSystem's threads
+//	- events, messages & destroyed entities are collected per chunk,
+//	  then merged in chunk order (same result for any thread count)
+//	- the iterator MUST already be locked
+void EntityManager::UpdateParallel( EntityVector& vec, float elapsedTime )
+{
+	if( vec.empty() == true )
+		return;
+
+	unsigned int numChunks = JobSystem::CountChunks( vec.size(), PARALLEL_CHUNK_SIZE );
+
+	// Collect the side effects per chunk
+	m_vChunkDestroyed.resize( numChunks );
+	SGD::EventManager::GetInstance()->BeginCapture( numChunks );
+	SGD::MessageBus::GetInstance()->BeginCapture( numChunks );
+	m_bParallelUpdate = true;
+
+	ParallelUpdate update;
+	update.pManager		= this;
+	update.pBucket		= &vec;
+	update.elapsedTime	= elapsedTime;
+	JobSystem::GetInstance()->ParallelFor( vec.size(), PARALLEL_CHUNK_SIZE, &EntityManager::UpdateChunk, &update );
+
+	// Merge the side effects in chunk order
+	m_bParallelUpdate = false;
+	SGD::EventManager::GetInstance()->EndCapture();
+	SGD::MessageBus::GetInstance()->EndCapture();
+
+	for( unsigned int c = 0; c < numChunks; c++ )
+	{
+		EntityVector& destroyed = m_vChunkDestroyed[ c ];
+		for( unsigned int i = 0; i < destroyed.size(); i++ )
+			DestroyEntity( destroyed[ i ] );
+
+		destroyed.clear();
+	}
+}
+
+
+//*********************************************************************//
+// UpdateChunk
+//	- JobSystem callback: update the entities [begin, end) of the bucket
+//	- the calling thread captures into the chunk's streams
+/*static*/ void EntityManager::UpdateChunk( void* data, unsigned int begin, unsigned int end, unsigned int chunk )
+{
+	PROFILE_SCOPE( "EntityManager::UpdateChunk" );
+
+	ParallelUpdate* pUpdate = reinterpret_cast< ParallelUpdate* >( data );
+
+	s_unUpdateChunk = chunk;
+	SGD::EventManager::GetInstance()->SetCaptureStream( chunk );
+	SGD::MessageBus::GetInstance()->SetCaptureStream( chunk );
+
+	EntityVector& vec = *pUpdate->pBucket;
+	for( unsigned int i = begin; i < end; i++ )
+		vec[ i ]->Update( pUpdate->elapsedTime );
+
+	s_unUpdateChunk = 0xFFFFFFFF;
+	SGD::EventManager::GetInstance()->SetCaptureStream( SGD::EventManager::NO_CAPTURE_STREAM );
+	SGD::MessageBus::GetInstance()->SetCaptureStream( SGD::MessageBus::NO_CAPTURE_STREAM );
 }
 
 
 //*********************************************************************//
 // RenderAll
 //	- render each entity in the table
-void EntityManager::RenderAll( void )
+//	- entities draw at their positions blended between the
+//	  start & end of the last update (Entity::GetRenderPosition)
+//	- the draws are batched, so entities sharing an image are
+//	  submitted together (overlapping entities with different
+//	  images may swap order)
+void EntityManager::RenderAll( float blend )
 {
+	PROFILE_SCOPE( "EntityManager::RenderAll" );
+
 	// Validate the iteration state
 	SGD_ASSERT( m_bIterating == false,
 				"EntityManager::RenderAll - cannot render while iterating" );
 	
+	m_Transforms.SetBlend( blend );
+	
 	// Lock the iterator
 	m_bIterating = true;
 	{
+		SGD::GraphicsManager::GetInstance()->BeginBatch();
+
 		// Render every entity
 		for( unsigned int bucket = 0; bucket < m_tEntities.size( ); bucket++ )
 		{
@@ -208,6 +521,8 @@ void EntityManager::RenderAll( void )
 			for( unsigned int i = 0; i < vec.size( ); i++ )
 				vec[ i ]->Render( );
 		}
+
+		SGD::GraphicsManager::GetInstance()->EndBatch();
 	}
 	// Unlock the iterator
 	m_bIterating = false;
@@ -217,8 +532,11 @@ void EntityManager::RenderAll( void )
 //*********************************************************************//
 // CheckCollisions
 //	- check collision between the entities within the two buckets
+//	- then remove the destroyed entities
 void EntityManager::CheckCollisions( unsigned int bucket1, unsigned int bucket2 )
 {
+	PROFILE_SCOPE( "EntityManager::CheckCollisions" );
+
 	// Validate the iteration state
 	SGD_ASSERT( m_bIterating == false,
 				"EntityManager::CheckCollisions - cannot collide while iterating" );
@@ -234,87 +552,513 @@ void EntityManager::CheckCollisions( unsigned int bucket1, unsigned int bucket2
 	// Lock the iterator
 	m_bIterating = true;
 	{
-		// Are they different buckets?
-		if( bucket1 != bucket2 )
+		if( IsContinuousCollision( bucket1 ) == true || IsContinuousCollision( bucket2 ) == true )
+			CollideContinuous( bucket1, bucket2 );
+		else switch( GetCollisionMode( bucket1, bucket2 ) )
 		{
-			// Which bucket is smaller?
-			//	should be the outer loop for less checks (n0)*(n1+1) + 1
-			EntityVector* pVec1 = &m_tEntities[ bucket1 ];
-			EntityVector* pVec2 = &m_tEntities[ bucket2 ];
+		case COLLISION_SPATIAL_HASH:
+			CollideSpatialHash( bucket1, bucket2 );
+			break;
+
+		case COLLISION_SWEEP_AND_PRUNE:
+			CollideSweepAndPrune( bucket1, bucket2 );
+			break;
+
+		default:
+			CollideBruteForce( bucket1, bucket2 );
+			break;
+		}
+	}
+	// Unlock the iterator
+	m_bIterating = false;
 
-			if( pVec2->size() < pVec1->size() )
+	// Remove the entities destroyed by the collisions
+	FlushDestroyed();
+}
+
+
+//*********************************************************************//
+// SetContinuousCollision
+//	- choose whether the bucket's entities are swept over the update
+void EntityManager::SetContinuousCollision( unsigned int bucket, bool continuous )
+{
+	if( bucket >= m_vContinuous.size() )
+		m_vContinuous.resize( bucket + 1, false );
+
+	m_vContinuous[ bucket ] = continuous;
+}
+
+
+//*********************************************************************//
+// GetCollisionMode
+//	- the strategy used between the two buckets
+EntityManager::CollisionMode EntityManager::GetCollisionMode( unsigned int bucket1, unsigned int bucket2 ) const
+{
+	// Pairs are stored in ascending order
+	if( bucket2 < bucket1 )
+		std::swap( bucket1, bucket2 );
+
+	PairModeMap::const_iterator iter = m_mPairModes.find( BucketPair( bucket1, bucket2 ) );
+	if( iter != m_mPairModes.end() )
+		return iter->second;
+
+	return m_eCollisionMode;
+}
+
+
+//*********************************************************************//
+// SetCollisionMode
+//	- override the strategy used between the two buckets
+void EntityManager::SetCollisionMode( unsigned int bucket1, unsigned int bucket2, CollisionMode mode )
+{
+	// Pairs are stored in ascending order
+	if( bucket2 < bucket1 )
+		std::swap( bucket1, bucket2 );
+
+	m_mPairModes[ BucketPair( bucket1, bucket2 ) ] = mode;
+}
+
+
+//*********************************************************************//
+// CollideBruteForce
+//	- test every pair of entities within the two buckets
+//	- each entity is tested against the packed rects of the other
+//	  bucket several at a time (SGD::IntersectRectangles)
+//	- the iterator MUST already be locked
+void EntityManager::CollideBruteForce( unsigned int bucket1, unsigned int bucket2 )
+{
+	// Are they different buckets?
+	if( bucket1 != bucket2 )
+	{
+		// Which bucket is smaller?
+		//	should be the outer loop for less checks (n0)*(n1+1) + 1
+		EntityVector* pVec1 = &m_tEntities[ bucket1 ];
+		EntityVector* pVec2 = &m_tEntities[ bucket2 ];
+
+		if( pVec2->size() < pVec1->size() )
+		{
+			EntityVector* pTemp = pVec1;
+			pVec1 = pVec2;
+			pVec2 = pTemp;
+		}
+
+		EntityVector& vec1 = *pVec1;
+		EntityVector& vec2 = *pVec2;
+
+
+		// Pack the larger bucket's rects
+		m_vRects.resize( vec2.size() );
+		m_vHits.resize( vec2.size() );
+		for( unsigned int j = 0; j < vec2.size(); j++ )
+			m_vRects[ j ] = vec2[ j ]->GetRect();
+
+
+		// Iterate through the smaller bucket
+		for( unsigned int i = 0; i < vec1.size(); i++ )
+		{
+			// Is the entity too small to collide?
+			SGD::Rectangle rEntity1 = vec1[ i ]->GetRect( );
+			if( rEntity1.IsEmpty() == true )
+				continue;
+
+			// Test against the entire larger bucket
+			m_unPairTests += vec2.size();
+			unsigned int numHits = SGD::IntersectRectangles( rEntity1, m_vRects.data(), vec2.size(), m_vHits.data() );
+
+			for( unsigned int h = 0; h < numHits; h++ )
 			{
-				EntityVector* pTemp = pVec1;
-				pVec1 = pVec2;
-				pVec2 = pTemp;
+				unsigned int j = m_vHits[ h ];
+
+				// Ignore self-collision
+				if( vec1[ i ] == vec2[ j ] )
+					continue;
+
+				// Both objects handle collision
+				++m_unCollisions;
+				vec1[ i ]->HandleCollision( vec2[ j ] );
+				vec2[ j ]->HandleCollision( vec1[ i ] );
 			}
+		}
+	}
+	else // bucket1 == bucket2
+	{
+		EntityVector& vec = m_tEntities[ bucket1 ];
 
-			EntityVector& vec1 = *pVec1;
-			EntityVector& vec2 = *pVec2;
+		// Pack the bucket's rects
+		m_vRects.resize( vec.size() );
+		m_vHits.resize( vec.size() );
+		for( unsigned int j = 0; j < vec.size(); j++ )
+			m_vRects[ j ] = vec[ j ]->GetRect();
 
 
-			// Iterate through the smaller bucket
-			for( unsigned int i = 0; i < vec1.size(); i++ )
+		// Optimized loop to ensure objects do not collide with
+		// each other twice
+		for( unsigned int i = 0; i < vec.size()-1; i++ )
+		{
+			// Is the entity too small to collide?
+			if( m_vRects[ i ].IsEmpty() == true )
+				continue;
+
+			// Test against the entities AFTER [i]
+			unsigned int first = i+1;
+			m_unPairTests += vec.size() - first;
+			unsigned int numHits = SGD::IntersectRectangles( m_vRects[ i ], m_vRects.data() + first, vec.size() - first, m_vHits.data() );
+
+			for( unsigned int h = 0; h < numHits; h++ )
 			{
-				// Is the entity too small to collide?
-				if( vec1[ i ]->GetRect( ).IsEmpty() == true )
+				unsigned int j = first + m_vHits[ h ];
+
+				// Ignore self-collision
+				if( vec[ i ] == vec[ j ] )
 					continue;
 
-				// Iterate through the larger bucket
-				for( unsigned int j = 0; j < vec2.size(); j++ )
-				{
-					// Ignore self-collision
-					if( vec1[ i ] == vec2[ j ] )
-						continue;
-
-					// Local variables help with debugging
-					SGD::Rectangle rEntity1 = vec1[ i ]->GetRect( );
-					SGD::Rectangle rEntity2 = vec2[ j ]->GetRect( );
-
-					// Check for collision between the entities
-					if( rEntity1.IsIntersecting( rEntity2 ) == true )
-					{
-						// Both objects handle collision
-						vec1[ i ]->HandleCollision( vec2[ j ] );
-						vec2[ j ]->HandleCollision( vec1[ i ] );
-					}
-				}
+				// Both objects handle collision
+				++m_unCollisions;
+				vec[ i ]->HandleCollision( vec[ j ] );
+				vec[ j ]->HandleCollision( vec[ i ] );
 			}
 		}
-		else // bucket1 == bucket2
+	}
+}
+
+
+//*********************************************************************//
+// CollideSpatialHash
+//	- hash the larger bucket's rects into the grid, then only test
+//	  the pairs that share a cell
+//	- pairs are reported in the same order as the brute-force loops
+//	- each rect is read once per check (entities do not move
+//	  while handling collisions)
+//	- the iterator MUST already be locked
+void EntityManager::CollideSpatialHash( unsigned int bucket1, unsigned int bucket2 )
+{
+	// Are they different buckets?
+	if( bucket1 != bucket2 )
+	{
+		// Which bucket is smaller?
+		//	should be the outer loop, the larger one is hashed
+		EntityVector* pVec1 = &m_tEntities[ bucket1 ];
+		EntityVector* pVec2 = &m_tEntities[ bucket2 ];
+
+		if( pVec2->size() < pVec1->size() )
 		{
-			EntityVector& vec = m_tEntities[ bucket1 ];
+			EntityVector* pTemp = pVec1;
+			pVec1 = pVec2;
+			pVec2 = pTemp;
+		}
+
+		EntityVector& vec1 = *pVec1;
+		EntityVector& vec2 = *pVec2;
 
-			// Optimized loop to ensure objects do not collide with
-			// each other twice
-			for( unsigned int i = 0; i < vec.size()-1; i++ )
+
+		// Hash the larger bucket
+		m_vRects.resize( vec2.size() );
+		m_Grid.Clear();
+		for( unsigned int j = 0; j < vec2.size(); j++ )
+		{
+			m_vRects[ j ] = vec2[ j ]->GetRect();
+
+			// Empty rects can never intersect
+			if( m_vRects[ j ].IsEmpty() == false )
+				m_Grid.Insert( j, m_vRects[ j ] );
+		}
+		m_Grid.Build();
+
+
+		// Iterate through the smaller bucket
+		for( unsigned int i = 0; i < vec1.size(); i++ )
+		{
+			// Is the entity too small to collide?
+			SGD::Rectangle rEntity1 = vec1[ i ]->GetRect( );
+			if( rEntity1.IsEmpty() == true )
+				continue;
+
+			// Test against the nearby entities
+			m_Grid.Query( rEntity1, m_vCandidates );
+			unsigned int numHits = TestCandidates( rEntity1 );
+
+			for( unsigned int h = 0; h < numHits; h++ )
 			{
-				// Is the entity too small to collide?
-				if( vec[ i ]->GetRect( ).IsEmpty() == true )
+				unsigned int j = m_vCandidates[ m_vHits[ h ] ];
+
+				// Ignore self-collision
+				if( vec1[ i ] == vec2[ j ] )
 					continue;
 
-				// Iterate through the entities AFTER [i]
-				for( unsigned int j = i+1; j < vec.size(); j++ )
-				{
-					// Ignore self-collision
-					if( vec[ i ] == vec[ j ] )
-						continue;
-
-					// Local variables help with debugging
-					SGD::Rectangle rEntity1 = vec[ i ]->GetRect( );
-					SGD::Rectangle rEntity2 = vec[ j ]->GetRect( );
-
-					// Check for collision between the entities
-					if( rEntity1.IsIntersecting( rEntity2 ) == true )
-					{
-						// Both objects handle collision
-						vec[ i ]->HandleCollision( vec[ j ] );
-						vec[ j ]->HandleCollision( vec[ i ] );
-					}
-				}
+				// Both objects handle collision
+				++m_unCollisions;
+				vec1[ i ]->HandleCollision( vec2[ j ] );
+				vec2[ j ]->HandleCollision( vec1[ i ] );
 			}
 		}
 	}
-	// Unlock the iterator
-	m_bIterating = false;
+	else // bucket1 == bucket2
+	{
+		EntityVector& vec = m_tEntities[ bucket1 ];
+
+		// Hash the entire bucket
+		m_vRects.resize( vec.size() );
+		m_Grid.Clear();
+		for( unsigned int j = 0; j < vec.size(); j++ )
+		{
+			m_vRects[ j ] = vec[ j ]->GetRect();
+
+			if( m_vRects[ j ].IsEmpty() == false )
+				m_Grid.Insert( j, m_vRects[ j ] );
+		}
+		m_Grid.Build();
+
+
+		for( unsigned int i = 0; i < vec.size(); i++ )
+		{
+			// Is the entity too small to collide?
+			if( m_vRects[ i ].IsEmpty() == true )
+				continue;
+
+			// Only the nearby entities AFTER [i]
+			m_Grid.Query( m_vRects[ i ], m_vCandidates );
+			m_vCandidates.erase( m_vCandidates.begin(),
+				std::upper_bound( m_vCandidates.begin(), m_vCandidates.end(), i ) );
+
+			unsigned int numHits = TestCandidates( m_vRects[ i ] );
+
+			for( unsigned int h = 0; h < numHits; h++ )
+			{
+				unsigned int j = m_vCandidates[ m_vHits[ h ] ];
+
+				// Ignore self-collision
+				if( vec[ i ] == vec[ j ] )
+					continue;
+
+				// Both objects handle collision
+				++m_unCollisions;
+				vec[ i ]->HandleCollision( vec[ j ] );
+				vec[ j ]->HandleCollision( vec[ i ] );
+			}
+		}
+	}
+}
+
+
+//*********************************************************************//
+// TestCandidates
+//	- pack the candidates' cached rects and batch test them
+//	- stores the positions (within m_vCandidates) of the hits
+//	  into m_vHits, returns the number of hits
+unsigned int EntityManager::TestCandidates( const SGD::Rectangle& rect )
+{
+	unsigned int count = m_vCandidates.size();
+
+	m_vBatch.resize( count );
+	m_vHits.resize( count );
+	for( unsigned int c = 0; c < count; c++ )
+		m_vBatch[ c ] = m_vRects[ m_vCandidates[ c ] ];
+
+	m_unPairTests += count;
+	return SGD::IntersectRectangles( rect, m_vBatch.data(), count, m_vHits.data() );
+}
+
+
+//*********************************************************************//
+// CollideContinuous
+//	- find the pairs whose swept bounds overlap with the pair's
+//	  broad phase (GetCollisionMode), then sweep each of them
+//	  (SGD::SweepRectangles) to find the time of impact
+//	- pairs are reported in the same order as the brute-force loops
+//	- the iterator MUST already be locked
+void EntityManager::CollideContinuous( unsigned int bucket1, unsigned int bucket2 )
+{
+	// Which bucket is smaller?
+	//	should be the outer loop, the larger one is hashed
+	bool bSame = ( bucket1 == bucket2 );
+	if( bSame == false && m_tEntities[ bucket2 ].size() < m_tEntities[ bucket1 ].size() )
+		std::swap( bucket1, bucket2 );
+
+	EntityVector& vec1 = m_tEntities[ bucket1 ];
+	EntityVector& vec2 = m_tEntities[ bucket2 ];
+
+	bool bSweep1 = IsContinuousCollision( bucket1 );
+	bool bSweep2 = IsContinuousCollision( bucket2 );
+	const SGD::Vector still = { 0, 0 };
+
+	CollisionMode mode = GetCollisionMode( bucket1, bucket2 );
+
+
+	// Cache the larger bucket's rects & movement
+	// (& hash their swept bounds)
+	m_vRects.resize( vec2.size() );
+	m_vDeltas.resize( vec2.size() );
+	if( mode == COLLISION_SPATIAL_HASH )
+		m_Grid.Clear();
+
+	for( unsigned int j = 0; j < vec2.size(); j++ )
+	{
+		m_vRects[ j ]	= vec2[ j ]->GetRect();
+		m_vDeltas[ j ]	= bSweep2 ? vec2[ j ]->GetDisplacement() : still;
+
+		// Empty rects can never intersect
+		if( mode == COLLISION_SPATIAL_HASH && m_vRects[ j ].IsEmpty() == false )
+			m_Grid.Insert( j, m_vRects[ j ].ComputeUnion( m_vRects[ j ] - m_vDeltas[ j ] ) );
+	}
+
+	if( mode == COLLISION_SPATIAL_HASH )
+		m_Grid.Build();
+
+
+	// Sweep and prune: the pairs overlapping along X, in order
+	if( mode == COLLISION_SWEEP_AND_PRUNE )
+	{
+		m_vPairs.clear();
+		m_vSweeps[ bucket1 ].Update( vec1, bSweep1 );
+
+		if( bSame == true )
+			m_unPairTests += m_vSweeps[ bucket1 ].FindPairs( m_vPairs );
+		else
+		{
+			m_vSweeps[ bucket2 ].Update( vec2, bSweep2 );
+			m_unPairTests += m_vSweeps[ bucket1 ].FindPairs( m_vSweeps[ bucket2 ], m_vPairs );
+		}
+
+		std::sort( m_vPairs.begin(), m_vPairs.end() );
+
+		for( unsigned int p = 0; p < m_vPairs.size(); p++ )
+		{
+			unsigned int i = m_vPairs[ p ].first;
+
+			SGD::Rectangle	rEntity1 = bSame ? m_vRects[ i ]	: vec1[ i ]->GetRect();
+			SGD::Vector		vDelta1	 = bSame ? m_vDeltas[ i ]	: ( bSweep1 ? vec1[ i ]->GetDisplacement() : still );
+
+			SweepPair( vec1[ i ], rEntity1 - vDelta1, vDelta1, vec2, m_vPairs[ p ].second );
+		}
+
+		m_fImpactTime = 1.0f;
+		return;
+	}
+
+
+	// Spatial hash & brute force: each entity against its candidates
+	for( unsigned int i = 0; i < vec1.size(); i++ )
+	{
+		// Is the entity too small to collide?
+		SGD::Rectangle	rEntity1 = bSame ? m_vRects[ i ]	: vec1[ i ]->GetRect();
+		SGD::Vector		vDelta1	 = bSame ? m_vDeltas[ i ]	: ( bSweep1 ? vec1[ i ]->GetDisplacement() : still );
+		if( rEntity1.IsEmpty() == true )
+			continue;
+
+		// Where it started the update
+		SGD::Rectangle rStart1 = rEntity1 - vDelta1;
+
+		// Nearby entities, or all of them
+		// (only AFTER [i] within the same bucket)
+		unsigned int first = bSame ? i + 1 : 0;
+		if( mode == COLLISION_SPATIAL_HASH )
+		{
+			m_Grid.Query( rEntity1.ComputeUnion( rStart1 ), m_vCandidates );
+			m_vCandidates.erase( m_vCandidates.begin(),
+				std::lower_bound( m_vCandidates.begin(), m_vCandidates.end(), first ) );
+		}
+		else
+		{
+			m_vCandidates.clear();
+			for( unsigned int j = first; j < vec2.size(); j++ )
+				m_vCandidates.push_back( j );
+		}
+
+		m_unPairTests += m_vCandidates.size();
+		for( unsigned int c = 0; c < m_vCandidates.size(); c++ )
+			SweepPair( vec1[ i ], rStart1, vDelta1, vec2, m_vCandidates[ c ] );
+	}
+
+	m_fImpactTime = 1.0f;
+}
+
+
+//*********************************************************************//
+// SweepPair
+//	- sweep an entity against the cached rect & movement of the
+//	  larger bucket's entity [j], both handle the collision on contact
+void EntityManager::SweepPair( IEntity* pEntity1, const SGD::Rectangle& rStart1, SGD::Vector vDelta1, EntityVector& vec2, unsigned int j )
+{
+	// Ignore self-collision
+	if( pEntity1 == vec2[ j ] )
+		return;
+
+	// Sweep by the movement relative to the other entity
+	float time;
+	if( SGD::SweepRectangles( rStart1, vDelta1 - m_vDeltas[ j ], m_vRects[ j ] - m_vDeltas[ j ], time ) == false )
+		return;
+
+	// Both objects handle collision
+	++m_unCollisions;
+	m_fImpactTime = time;
+	pEntity1->HandleCollision( vec2[ j ] );
+	vec2[ j ]->HandleCollision( pEntity1 );
+}
+
+
+//*********************************************************************//
+// CollideSweepAndPrune
+//	- sweep the buckets' persistent sorted lists along X and only
+//	  test the pairs that overlap
+//	- the colliding pairs are sorted so HandleCollision is called
+//	  in the same order as the brute-force loops
+//	- the iterator MUST already be locked
+void EntityManager::CollideSweepAndPrune( unsigned int bucket1, unsigned int bucket2 )
+{
+	m_vPairs.clear();
+
+	// Are they different buckets?
+	if( bucket1 != bucket2 )
+	{
+		// Which bucket is smaller?
+		//	the brute-force loops use it as the outer loop
+		bool bSwap = ( m_tEntities[ bucket2 ].size() < m_tEntities[ bucket1 ].size() );
+		if( bSwap == true )
+			std::swap( bucket1, bucket2 );
+
+		EntityVector& vec1 = m_tEntities[ bucket1 ];
+		EntityVector& vec2 = m_tEntities[ bucket2 ];
+
+
+		// Restore each bucket's order along X
+		m_vSweeps[ bucket1 ].Update( vec1 );
+		m_vSweeps[ bucket2 ].Update( vec2 );
+
+		m_unPairTests += m_vSweeps[ bucket1 ].FindPairs( m_vSweeps[ bucket2 ], m_vPairs );
+		std::sort( m_vPairs.begin(), m_vPairs.end() );
+
+
+		for( unsigned int p = 0; p < m_vPairs.size(); p++ )
+		{
+			unsigned int i = m_vPairs[ p ].first;
+			unsigned int j = m_vPairs[ p ].second;
+
+			// Both objects handle collision
+			++m_unCollisions;
+			vec1[ i ]->HandleCollision( vec2[ j ] );
+			vec2[ j ]->HandleCollision( vec1[ i ] );
+		}
+	}
+	else // bucket1 == bucket2
+	{
+		EntityVector& vec = m_tEntities[ bucket1 ];
+
+		// Restore the bucket's order along X
+		m_vSweeps[ bucket1 ].Update( vec );
+
+		m_unPairTests += m_vSweeps[ bucket1 ].FindPairs( m_vPairs );
+		std::sort( m_vPairs.begin(), m_vPairs.end() );
+
+
+		for( unsigned int p = 0; p < m_vPairs.size(); p++ )
+		{
+			unsigned int i = m_vPairs[ p ].first;
+			unsigned int j = m_vPairs[ p ].second;
+
+			// Both objects handle collision
+			++m_unCollisions;
+			vec[ i ]->HandleCollision( vec[ j ] );
+			vec[ j ]->HandleCollision( vec[ i ] );
+		}
+	}
 }
@@ -8,6 +8,12 @@
 #pragma once
 
 #include <vector>		// std::vector type
+#include <map>			// std::map type
+#include <deque>		// std::deque type
+#include "HEntity.h"		// HEntity type
+#include "SpatialHash.h"	// SpatialHash type
+#include "SweepAndPrune.h"	// SweepList type
+#include "TransformStore.h"	// TransformStore type
 class IEntity;			// IEntity type
 
 
@@ -24,6 +30,14 @@ public:
 	~EntityManager( void )	= default;
 
 
+	//*****************************************************************//
+	// Collision Modes:
+	//	- BRUTE_FORCE tests every pair
+	//	- SPATIAL_HASH only tests pairs sharing a grid cell
+	//	- SWEEP_AND_PRUNE only tests pairs overlapping along X
+	enum CollisionMode { COLLISION_BRUTE_FORCE, COLLISION_SPATIAL_HASH, COLLISION_SWEEP_AND_PRUNE };
+
+
 	//*****************************************************************//
 	// Entity Storage:
 	void	AddEntity	( IEntity* pEntity, unsigned int bucket );
@@ -32,14 +46,56 @@ public:
 	void	RemoveAll	( unsigned int bucket );
 	void	RemoveAll	( void );
 
+	// Deferred removal (flushed after UpdateAll & CheckCollisions)
+	void	DestroyEntity	( IEntity* pEntity );
+	void	FlushDestroyed	( void );
+
+
+	//*****************************************************************//
+	// Entity Handles:
+	//	- every stored entity gets a handle (see IEntity::StorageSlot)
+	//	- GetEntity returns nullptr once the entity has been removed
+	//	  (still valid while a DestroyEntity is pending)
+	IEntity*	GetEntity		( HEntity handle ) const;
+	bool		IsHandleValid	( HEntity handle ) const	{	return GetEntity( handle ) != nullptr;	}
+
 
 	//*****************************************************************//
 	// Entity Upkeep:
+	//	- parallel buckets are updated in chunks by the JobSystem
+	//	  (their Update may only touch the entity itself, queue
+	//	  events / messages, and destroy entities)
 	void	UpdateAll( float elapsedTime );
-	void	RenderAll( void );
+	void	SetParallelUpdate( unsigned int bucket, bool parallel );
+	void	RenderAll( float blend = 1.0f );	// blend: 0 = previous update, 1 = latest
 	
 	void	CheckCollisions( unsigned int bucket1, unsigned int bucket2 );
 
+
+	//*****************************************************************//
+	// Collision Settings & Stats:
+	CollisionMode	GetCollisionMode( void ) const			{	return m_eCollisionMode;	}	// default for every pair
+	void			SetCollisionMode( CollisionMode mode )	{	m_eCollisionMode = mode;	}
+	CollisionMode	GetCollisionMode( unsigned int bucket1, unsigned int bucket2 ) const;
+	void			SetCollisionMode( unsigned int bucket1, unsigned int bucket2, CollisionMode mode );
+	void			SetCollisionCellSize( float size )		{	m_Grid.SetCellSize( size );	}
+
+	// Continuous collision:
+	//	- entities in continuous buckets are swept from where they were
+	//	  at the start of the last UpdateAll to where they are now,
+	//	  so fast movers cannot step over anything between checks
+	//	- entities in other buckets are tested where they are now
+	//	- the pair's collision mode is the broad phase over the swept
+	//	  bounds, each candidate pair is then swept exactly
+	//	- GetImpactTime is the time of contact of the pair being
+	//	  handled (0 = start of the update, 1 = end, discrete pairs = 1)
+	void			SetContinuousCollision( unsigned int bucket, bool continuous );
+	bool			IsContinuousCollision( unsigned int bucket ) const	{	return bucket < m_vContinuous.size() && m_vContinuous[ bucket ];	}
+	float			GetImpactTime	( void ) const			{	return m_fImpactTime;		}
+
+	unsigned int	GetPairTests	( void ) const			{	return m_unPairTests;		}	// rect tests since the last UpdateAll
+	unsigned int	GetCollisions	( void ) const			{	return m_unCollisions;		}	// colliding pairs since the last UpdateAll
+
 private:
 	//*****************************************************************//
 	// Not a singleton, but still don't want the Trilogy-of-Evil
@@ -51,11 +107,84 @@ private:
 	// Typedefs will simplify the templates
 	typedef std::vector< IEntity* >		EntityVector;
 	typedef std::vector< EntityVector >	EntityTable;
+	typedef std::pair< unsigned int, unsigned int >		BucketPair;
+	typedef std::map< BucketPair, CollisionMode >		PairModeMap;
+
+
+	//*****************************************************************//
+	// Collision Helpers:
+	void	CollideBruteForce	( unsigned int bucket1, unsigned int bucket2 );
+	void	CollideSpatialHash	( unsigned int bucket1, unsigned int bucket2 );
+	void	CollideSweepAndPrune( unsigned int bucket1, unsigned int bucket2 );
+	void	CollideContinuous	( unsigned int bucket1, unsigned int bucket2 );
+	void	SweepPair			( IEntity* pEntity1, const SGD::Rectangle& rStart1, SGD::Vector vDelta1, EntityVector& vec2, unsigned int j );
+
+	unsigned int	TestCandidates	( const SGD::Rectangle& rect );
+
+
+	//*****************************************************************//
+	// Storage Helpers:
+	void	Unstore		( IEntity* pEntity );	// swap & pop removal
+
+	HEntity	AllocateHandle	( IEntity* pEntity );
+	void	FreeHandle		( HEntity handle );
+
+	// Freed indices are recycled oldest first, and only once this many
+	// are waiting, so a stale handle takes long to come back around
+	// (a handle only has 8 reuse bits)
+	enum { MIN_FREE_HANDLES = 1024 };
+
+	struct HandleSlot
+	{
+		HEntity		handle;					// INVALID_HANDLE when free
+		IEntity*	pEntity;
+	};
+
+
+	//*****************************************************************//
+	// Parallel Update Helpers:
+	enum { PARALLEL_CHUNK_SIZE = 256 };		// entities per job
+
+	struct ParallelUpdate
+	{
+		EntityManager*	pManager;
+		EntityVector*	pBucket;
+		float			elapsedTime;
+	};
+
+	void		UpdateParallel	( EntityVector& vec, float elapsedTime );
+	static void	UpdateChunk		( void* data, unsigned int begin, unsigned int end, unsigned int chunk );
 
 
 	//*****************************************************************//
 	// members:
 	EntityTable		m_tEntities;			// vector-of-vector-of-IEntity* (2D table)
 	bool			m_bIterating = false;	// read/write lock
+	TransformStore	m_Transforms;			// positions, velocities & sizes of the stored entities
+	EntityVector	m_vDestroyed;			// entities queued for removal (referenced)
+
+	std::vector< HandleSlot >		m_vHandles;			// entity per handle index
+	std::deque< HEntity >			m_dFreeHandles;		// removed handles, oldest first
+
+	std::vector< bool >				m_vParallel;		// buckets updated in parallel
+	std::vector< EntityVector >		m_vChunkDestroyed;	// destroyed per chunk during a parallel update (not referenced)
+	bool							m_bParallelUpdate	= false;
+
+	CollisionMode	m_eCollisionMode	= COLLISION_SPATIAL_HASH;
+	PairModeMap		m_mPairModes;						// per bucket pair overrides
+	SpatialHash		m_Grid;								// broadphase grid (rebuilt per check)
+	std::vector< SGD::Rectangle >	m_vRects;			// cached rects of the tested bucket
+	std::vector< unsigned int >		m_vCandidates;		// query results
+	std::vector< SGD::Rectangle >	m_vBatch;			// packed rects of the candidates
+	std::vector< unsigned int >		m_vHits;			// batch test results
+	std::vector< SweepList >		m_vSweeps;			// sorted endpoints per bucket
+	SweepList::PairVector			m_vPairs;			// sweep results
+
+	std::vector< bool >				m_vContinuous;		// buckets swept over the update
+	std::vector< SGD::Vector >		m_vDeltas;			// movement of the tested bucket
+	float							m_fImpactTime	= 1.0f;
+
+	unsigned int	m_unPairTests		= 0;
+	unsigned int	m_unCollisions		= 0;
 
 };
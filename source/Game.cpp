@@ -15,18 +15,31 @@
 #include "../SGD Wrappers/SGD_Utilities.h"
 #include "../SGD Wrappers/SGD_EventManager.h"
 #include "../SGD Wrappers/SGD_MessageManager.h"
+#include "../SGD Wrappers/SGD_FrameArena.h"
+#include "../SGD Wrappers/SGD_AssetArchive.h"
 
 #include "BitmapFont.h"
 #include "IGameState.h"
 #include "MainMenuState.h"
 #include "IntroScreenState.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 
 #include <ctime>
 #include <cstdlib>
 #include <cassert>
+#include <cmath>
 
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
+
+//*********************************************************************//
+// Fixed simulation rate
+//	- the states always update by FIXED_TIMESTEP
+//	- at most MAX_SUBSTEPS per frame (1/8th of a second)
+#define FIXED_TIMESTEP	(1.0f / 120.0f)
+#define MAX_SUBSTEPS	15
+
+// Frames written by the trace hotkey
+#define TRACE_FRAMES	120
 
 
 //*********************************************************************//
@@ -72,9 +85,23 @@ bool Game::Initialize( void )
 		|| SGD::AudioManager::GetInstance()->Initialize() == false)
 		return false;	// failure!!!
 
-	m_hMainMenuBackground = SGD::GraphicsManager::GetInstance()->LoadTexture(L"./resource/graphics/ELW_TitleScreen1.png");
-	m_hPlayerImg = SGD::GraphicsManager::GetInstance()->LoadTexture(L"./resource/graphics/ELW_Character1Sprite.png", SGD::Color{ 255, 255, 255, 255 });
-	m_hEnemyImg = SGD::GraphicsManager::GetInstance()->LoadTexture(L"./resource/graphics/ELW_EnemyLvl1.png", SGD::Color{ 255, 255, 255, 255 });
+	// Start the worker threads (one per extra core)
+	JobSystem::GetInstance()->Initialize();
+
+	// Start timing the frames (F3 = overlay, F4 = dump trace)
+	Profiler::GetInstance();
+
+	// Read the assets from the packed archive, if there is one
+	// (otherwise from the resource folder)
+	SGD::MountArchive( L"resource.pak" );
+
+	// Pack the textures into shared pages (fewer texture switches)
+	SGD::GraphicsManager::GetInstance()->SetAtlasMode( true );
+
+	// decode the textures in the background while the audio loads
+	m_hMainMenuBackground = SGD::GraphicsManager::GetInstance()->LoadTextureAsync(L"./resource/graphics/ELW_TitleScreen1.png");
+	m_hPlayerImg = SGD::GraphicsManager::GetInstance()->LoadTextureAsync(L"./resource/graphics/ELW_Character1Sprite.png", SGD::Color{ 255, 255, 255, 255 });
+	m_hEnemyImg = SGD::GraphicsManager::GetInstance()->LoadTextureAsync(L"./resource/graphics/ELW_EnemyLvl1.png", SGD::Color{ 255, 255, 255, 255 });
 
 	// loads sfx + background music
 	m_hProjectileSecSfx = SGD::AudioManager::GetInstance()->LoadAudio(L"./resource/audio/ELW_SecondaryShotSfx.wav");
@@ -83,6 +110,10 @@ bool Game::Initialize( void )
 	m_hGameOverSfx = SGD::AudioManager::GetInstance()->LoadAudio(L"./resource/audio/ELW_GameOverSfx.wav");
 	m_hGameWinSfx = SGD::AudioManager::GetInstance()->LoadAudio(L"./resource/audio/ELW_GameWinSfx.wav");
 	m_hMenuChangeSfx = SGD::AudioManager::GetInstance()->LoadAudio(L"./resource/audio/ELW_MenuChangeSfx.wav");
+
+	// the menu draws them straight away
+	SGD::HTexture textures[] = { m_hMainMenuBackground, m_hPlayerImg, m_hEnemyImg };
+	SGD::GraphicsManager::GetInstance()->WaitForTextures(textures, 3);
 	
 // Hide the console window
 #if !defined( DEBUG ) && !defined( _DEBUG )
@@ -105,53 +136,104 @@ bool Game::Initialize( void )
 	ChangeState(IntroScreenState::GetInstance() );
 	
 
-	// Store the starting time
-	m_ulGameTime = GetTickCount();
+	// Store the starting time (high resolution counter)
+	m_llClockFrequency	= Profiler::GetInstance()->GetFrequency();
+	m_llGameTime		= Profiler::GetTicks();
+	m_fAccumulator		= 0.0f;
+	m_fRenderBlend		= 1.0f;
 	return true;	// success!
 }
 
 //*********************************************************************//
 // Update
-//	- update the SGD wrappers
-//	- update & render the current state
+//	- measure the real time since the last frame
+//	- run the frame with it
 int	Game::Update( void )
 {
-	// Try to update the wrappers
-	if( SGD::GraphicsManager::GetInstance()->Update() == false 
-		|| SGD::InputManager::GetInstance()->Update() == false 
-		|| SGD::AudioManager::GetInstance()->Update() == false)
-		return +1;	// exit when window is closed
-
-
-
-	
 	// Calculate the elapsed time between frames
-	unsigned long now = GetTickCount();
-	float elapsedTime = (now - m_ulGameTime) / 1000.0f;
-	m_ulGameTime = now;
+	long long now = Profiler::GetTicks();
+	float elapsedTime = (float)( now - m_llGameTime ) / (float)m_llClockFrequency;
+	m_llGameTime = now;
 	
 	// Cap the elapsed time to 1/8th of a second
 	if( elapsedTime > 0.125f )
 		elapsedTime = 0.125f;
 
-	if (SGD::InputManager::GetInstance()->IsKeyDown(SGD::Key::Alt)
-		&& SGD::InputManager::GetInstance()->IsKeyPressed(SGD::Key::Enter))
+	return RunFrame( elapsedTime );
+}
+
+//*********************************************************************//
+// RunFrame
+//	- update the SGD wrappers
+//	- update the current state in fixed steps
+//	- render the current state, blended between the last two steps
+//	- passing GetFixedTimestep() runs exactly one step (the headless
+//	  benchmark relies on this to stay deterministic)
+int Game::RunFrame( float elapsedTime )
+{
+	Profiler::GetInstance()->BeginFrame();
+
+	// Try to update the wrappers
+	//	(input is polled once per step below)
 	{
-		m_bIsFullscreenToggled = !m_bIsFullscreenToggled;
-		SGD::GraphicsManager::GetInstance()->Resize(m_szScreenSize, m_bIsFullscreenToggled);
-		return 0;
+		PROFILE_SCOPE( "GraphicsManager::Update" );
+		if( SGD::GraphicsManager::GetInstance()->Update() == false )
+			return +1;	// exit when window is closed
 	}
 
-	
-	
+	if( SGD::AudioManager::GetInstance()->Update() == false )
+		return +1;
+
+
+	// Catch up on the simulation in fixed steps
+	m_fAccumulator += elapsedTime;
+	for( int step = 0; step < MAX_SUBSTEPS && m_fAccumulator >= FIXED_TIMESTEP; step++ )
+	{
+		m_fAccumulator -= FIXED_TIMESTEP;
+
+		// Poll the input for this step
+		//	(each press is seen by exactly one step)
+		if( SGD::InputManager::GetInstance()->Update() == false )
+			return +1;	// exit when window is closed
+
+		if (SGD::InputManager::GetInstance()->IsKeyDown(SGD::Key::Alt)
+			&& SGD::InputManager::GetInstance()->IsKeyPressed(SGD::Key::Enter))
+		{
+			m_bIsFullscreenToggled = !m_bIsFullscreenToggled;
+			SGD::GraphicsManager::GetInstance()->Resize(m_szScreenSize, m_bIsFullscreenToggled);
+			continue;
+		}
+
+		// Profiler hotkeys
+		if( SGD::InputManager::GetInstance()->IsKeyPressed( SGD::Key::F3 ) == true )
+			Profiler::GetInstance()->SetOverlayVisible( !Profiler::GetInstance()->IsOverlayVisible() );
+		if( SGD::InputManager::GetInstance()->IsKeyPressed( SGD::Key::F4 ) == true )
+			Profiler::GetInstance()->DumpTrace( "profile_trace.json", TRACE_FRAMES );
+
+		// Events & Messages queued two steps ago have been processed
+		SGD::FrameArena::GetInstance()->NextFrame();
+
+		// Update the current state
+		PROFILE_SCOPE( "Game::Step" );
+		if( m_pCurrState->Update( FIXED_TIMESTEP ) == false )
+			return +1;	// exit success
+	}
+
+	// Drop the time the step limit could not cover
+	if( m_fAccumulator >= FIXED_TIMESTEP )
+		m_fAccumulator = fmodf( m_fAccumulator, FIXED_TIMESTEP );
 
-		
 
-	// Update & Render the current state
-	if( m_pCurrState->Update( elapsedTime ) == false )
-		return +1;	// exit success
+	// Render the current state between the last two steps
+	m_fRenderBlend = m_fAccumulator / FIXED_TIMESTEP;
+	{
+		PROFILE_SCOPE( "Game::Render" );
+		m_pCurrState->Render( elapsedTime );
+	}
 
-	m_pCurrState->Render( elapsedTime );
+	// Draw the profiler on top
+	Profiler::GetInstance()->Render( m_pFont, SGD::Point{ 8, 40 } );
+	Profiler::GetInstance()->EndFrame();
 
 	return 0;		// keep running
 }
@@ -195,6 +277,27 @@ void Game::Terminate( void )
 	
 	SGD::GraphicsManager::GetInstance()->Terminate();
 	SGD::GraphicsManager::DeleteInstance();
+
+	// The managers no longer read from the archive
+	SGD::UnmountArchive();
+
+	// Stop the worker threads
+	JobSystem::GetInstance()->Terminate();
+	JobSystem::DeleteInstance();
+
+	Profiler::DeleteInstance();
+
+	// Every Event & Message is gone with the managers
+	SGD::FrameArena::DeleteInstance();
+}
+
+
+//*********************************************************************//
+// GetFixedTimestep
+//	- seconds simulated by each state update
+/*static*/ float Game::GetFixedTimestep( void )
+{
+	return FIXED_TIMESTEP;
 }
 
 
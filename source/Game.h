@@ -42,6 +42,9 @@ public:
 	bool	Initialize	( void );
 	int		Update		( void );
 	void	Terminate	( void );
+
+	// Frame with a given elapsed time (Update uses the real clock)
+	int		RunFrame	( float elapsedTime );
 	
 	
 	//*****************************************************************//
@@ -51,10 +54,19 @@ public:
 	// Font Accessor (#include "BitmapFont.h" to use!)
 	BitmapFont*	GetFont			( void ) const	{	return	m_pFont;		}
 
+	// Render Blend
+	//	- how far the current frame is between the last two
+	//	  simulation steps (0 = previous step, 1 = latest step)
+	float		GetRenderBlend	( void ) const	{	return m_fRenderBlend;	}
+
+	// Seconds simulated by each state update
+	static float	GetFixedTimestep( void );
+
 
 	//*****************************************************************//
-	// Game State Mutator:
-	void	ChangeState( IGameState* pNextState );
+	// Game State Accessor & Mutator:
+	IGameState*	GetCurrentState	( void ) const	{	return m_pCurrState;	}
+	void		ChangeState		( IGameState* pNextState );
 
 
 	SGD::HTexture GetMenuBackground() const { return m_hMainMenuBackground; }
@@ -120,7 +132,10 @@ private:
 
 	//*****************************************************************//
 	// Game Time
-	unsigned long	m_ulGameTime	= 0;
+	long long		m_llGameTime		= 0;		// high resolution counter at the last frame
+	long long		m_llClockFrequency	= 1;		// counter ticks per second
+	float			m_fAccumulator		= 0.0f;		// real time not simulated yet
+	float			m_fRenderBlend		= 1.0f;
 
 
 	SGD::HTexture m_hMainMenuBackground = SGD::INVALID_HANDLE;
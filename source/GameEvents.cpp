@@ -0,0 +1,19 @@
+//*********************************************************************//
+//	File:		GameEvents.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	GameEvent IDs identify the events sent between entities
+//*********************************************************************//
+
+#include "GameEvents.h"
+
+
+//*********************************************************************//
+// GameEvent IDs
+namespace GameEvent
+{
+	const SGD::EventID	ENEMY_HIT		= "ENEMY_HIT";
+	const SGD::EventID	ENEMY_DESTROYED	= "ENEMY_DESTROYED";
+	const SGD::EventID	PLAYER_HIT		= "PLAYER_HIT";
+	const SGD::EventID	GAME_OVER		= "GAME_OVER";
+}
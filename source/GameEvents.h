@@ -0,0 +1,23 @@
+//*********************************************************************//
+//	File:		GameEvents.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	GameEvent IDs identify the events sent between entities
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_Event.h"	// EventID type
+
+
+//*********************************************************************//
+// GameEvent IDs
+//	- interned once at startup, so sending, registering & comparing
+//	  them is an integer operation (no string lookups per event)
+namespace GameEvent
+{
+	extern const SGD::EventID	ENEMY_HIT;
+	extern const SGD::EventID	ENEMY_DESTROYED;
+	extern const SGD::EventID	PLAYER_HIT;
+	extern const SGD::EventID	GAME_OVER;
+}
@@ -18,6 +18,8 @@
 #include "CreateBulletMessage.h"
 #include "DestroyEntityMessage.h"
 #include "CreditsState.h"
+#include "Profiler.h"
+#include "GameEvents.h"
 
 #include "../SGD Wrappers/SGD_AudioManager.h"
 #include "../SGD Wrappers/SGD_GraphicsManager.h"
@@ -26,17 +28,17 @@
 #include "../SGD Wrappers/SGD_Utilities.h"
 #include "../SGD Wrappers/SGD_EventManager.h"
 #include "../SGD Wrappers/SGD_Event.h"
-#include "../SGD Wrappers/SGD_MessageManager.h"
-#include "../SGD Wrappers/SGD_Message.h"
+#include "../SGD Wrappers/SGD_MessageBus.h"
 
 
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
 #include <cstdlib>
 #include <cassert>
 #include <vector>
 #include <string.h>
 
+// projectiles reserved up-front (raise if the pool's misses climb)
+#define PROJECTILE_POOL_SIZE 64
+
 GameplayState* GameplayState::s_pInstance = nullptr;
 //*********************************************************************//
 // GetInstance
@@ -64,13 +66,19 @@ void GameplayState::DeleteInstance(void)
 {
 
 	
-	// Initialize the Event & Message Managers
+	// Initialize the Event Manager & Message Bus
 	SGD::EventManager::GetInstance()->Initialize();
-	SGD::MessageManager::GetInstance()->Initialize( &GameplayState::MessageProc );
-	// loads textures
-	m_hLevel1Background = SGD::GraphicsManager::GetInstance()->LoadTexture(L"./resource/graphics/ELW_LevelCut.png");
-	m_hEnemyImgL1 = SGD::GraphicsManager::GetInstance()->LoadTexture(L"./resource/graphics/ELW_EnemyLvl1.png", SGD::Color{ 255, 255, 255 });
-	m_hProjectileSecImage = SGD::GraphicsManager::GetInstance()->LoadTexture(L"./resource/graphics/ELW_ProjectileSec.png", SGD::Color{ 255, 255, 255 });
+	SGD::MessageBus::GetInstance()->Initialize();
+	SGD::MessageBus::GetInstance()->Subscribe( &GameplayState::OnCreateBullet );
+	SGD::MessageBus::GetInstance()->Subscribe( &GameplayState::OnDestroyEntity );
+
+	// Merge each frame's hits & kills (one event per listener, counted)
+	SGD::EventManager::GetInstance()->SetCoalescing( GameEvent::ENEMY_HIT, true );
+	SGD::EventManager::GetInstance()->SetCoalescing( GameEvent::ENEMY_DESTROYED, true );
+	// loads textures (decoded in the background while the level is set up)
+	m_hLevel1Background = SGD::GraphicsManager::GetInstance()->LoadTextureAsync(L"./resource/graphics/ELW_LevelCut.png");
+	m_hEnemyImgL1 = SGD::GraphicsManager::GetInstance()->LoadTextureAsync(L"./resource/graphics/ELW_EnemyLvl1.png", SGD::Color{ 255, 255, 255 });
+	m_hProjectileSecImage = SGD::GraphicsManager::GetInstance()->LoadTextureAsync(L"./resource/graphics/ELW_ProjectileSec.png", SGD::Color{ 255, 255, 255 });
 
 	
 
@@ -80,6 +88,20 @@ void GameplayState::DeleteInstance(void)
 	// Allocate the Entity Manager
 	m_pEntities = new EntityManager;
 
+	// projectiles are swept over each update so a frame hitch cannot
+	// carry them past an enemy
+	m_pEntities->SetContinuousCollision(2, true);
+
+	// enemy formations scroll horizontally, so sweeping along X wins
+	// (the broad phase of the enemy / projectile sweep)
+	m_pEntities->SetCollisionMode(1, 2, EntityManager::COLLISION_SWEEP_AND_PRUNE);
+
+	// projectiles only move themselves, so they can update on the job threads
+	m_pEntities->SetParallelUpdate(2, true);
+
+	// pre-allocate the projectiles so firing never hits the heap
+	Projectile::GetPool().Reserve(PROJECTILE_POOL_SIZE);
+
 	
 	m_pPlayer = CreatePlayer();
 	m_pEntities->AddEntity(m_pPlayer, 0);
@@ -87,6 +109,9 @@ void GameplayState::DeleteInstance(void)
 	// made switch function for future levels
 	HoldEnemyCreation(1);
 
+	// the first frame needs the textures
+	SGD::HTexture textures[] = { m_hLevel1Background, m_hEnemyImgL1, m_hProjectileSecImage };
+	SGD::GraphicsManager::GetInstance()->WaitForTextures(textures, 3);
 
 }
 
@@ -122,8 +147,8 @@ void GameplayState::DeleteInstance(void)
 
 
 	// Terminate & deallocate the SGD wrappers
-	SGD::MessageManager::GetInstance()->Terminate();
-	SGD::MessageManager::DeleteInstance();
+	SGD::MessageBus::GetInstance()->Terminate();
+	SGD::MessageBus::DeleteInstance();
 
 	SGD::EventManager::GetInstance()->Terminate();
 	SGD::EventManager::DeleteInstance();
@@ -187,11 +212,17 @@ void GameplayState::DeleteInstance(void)
 	
 	// Process the Event Manageraws
 	//	- all the events will be sent to the registered IListeners' HandleEvent methods
-	SGD::EventManager::GetInstance()->Update();
+	{
+		PROFILE_SCOPE( "EventManager::Update" );
+		SGD::EventManager::GetInstance()->Update();
+	}
 
-	// Process the Message Manager
-	//	- all the messages will be sent to our MessageProc
-	SGD::MessageManager::GetInstance()->Update();
+	// Process the Message Bus
+	//	- all the messages will be sent to our handlers
+	{
+		PROFILE_SCOPE( "MessageBus::Update" );
+		SGD::MessageBus::GetInstance()->Update();
+	}
 
 	return true;	// keep playing
 }
@@ -210,8 +241,8 @@ void GameplayState::DeleteInstance(void)
 	DrawPlayerScore();
 	DrawEnemiesLeft();
 
-	// Render the entities
-	m_pEntities->RenderAll();
+	// Render the entities (between the last two simulation steps)
+	m_pEntities->RenderAll(Game::GetInstance()->GetRenderBlend());
 	// draws the pause menu
 	if (m_bisGamePaused)
 	{
@@ -232,45 +263,31 @@ void GameplayState::DeleteInstance(void)
 
 
 //*********************************************************************//
-// MessageProc
-//	- process messages queued in the MessageManager
+// OnCreateBullet
+//	- MessageBus handler: fire a projectile from the owner
 //	- STATIC METHOD!!!
 //		- no invoking object!
 //		- MUST USE THE SINGLETON
-/*static*/ void GameplayState::MessageProc( const SGD::Message* pMsg )
+/*static*/ void GameplayState::OnCreateBullet( const CreateBulletMessage& message )
 {
-/* Show warning when a Message ID enumerator is not handled */
-#pragma warning( push )
-#pragma warning( 1 : 4061 )
+	Entity* enemy = dynamic_cast<Entity*>(GameplayState::GetInstance()->m_pEntities->GetEntity(message.GetBulletOwner()));
+	if (enemy == nullptr)
+		return;	// owner was removed before the message arrived
+	Entity* entity = GameplayState::GetInstance()->CreateProjectile(enemy);
+	GameplayState::GetInstance()->m_pEntities->AddEntity(entity, 2);
+	entity->Release();
+}
 
 
-	// What type of message?
-	switch( pMsg->GetMessageID() )
-	{
-	case MessageID::MSG_CREATE_BULLET:
-		{
-			const CreateBulletMessage* message = dynamic_cast<const CreateBulletMessage*>(pMsg);
-			Entity* enemy = message->GetBulletOwner();
-			Entity* entity = GameplayState::GetInstance()->CreateProjectile(enemy);
-			GameplayState::GetInstance()->m_pEntities->AddEntity(entity, 2);
-			entity->Release(); GameplayState::GetInstance()->m_pEntities->AddEntity(entity, 2);
-		}
-		break;
-	case MessageID::MSG_DESTROY_ENTITY:
-		{
-		const DestroyEntityMessage* destroy = dynamic_cast<const DestroyEntityMessage*>(pMsg);
-		Entity* entity = destroy->GetEntity();
+//*********************************************************************//
+// OnDestroyEntity
+//	- MessageBus handler: remove the entity (if it is still there)
+//	- STATIC METHOD!!!
+/*static*/ void GameplayState::OnDestroyEntity( const DestroyEntityMessage& message )
+{
+	IEntity* entity = GameplayState::GetInstance()->m_pEntities->GetEntity(message.GetEntity());
+	if (entity != nullptr)
 		GameplayState::GetInstance()->m_pEntities->RemoveEntity(entity);
-		}
-		break;
-	default:
-		SGD_PRINT( L"GameplayState::MessageProc - unknown message id\n" );
-		break;
-	}
-
-
-/* Restore previous warning levels */
-#pragma warning( pop )
 }
 
 Entity* GameplayState::CreatePlayer(void)
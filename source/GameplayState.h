@@ -22,6 +22,8 @@
 class Entity;
 class EntityManager;
 class Player;
+class CreateBulletMessage;
+class DestroyEntityMessage;
 
 
 //*********************************************************************//
@@ -46,6 +48,8 @@ public:
 	virtual void	Render	( float elapsedTime )	override;	// render game entities / menus
 
 
+	EntityManager* GetEntityManager(void) const { return m_pEntities; }
+
 	Entity* CreatePlayer(void);
 	Entity* CreateLvl1Enemy(int _y);
 	Entity* CreateProjectile(Entity* entity);
@@ -81,8 +85,9 @@ private:
 	
 
 	//*****************************************************************//
-	// Message Callback Procedure
-	static void MessageProc( const SGD::Message* pMsg );
+	// Message Handlers (MessageBus)
+	static void OnCreateBullet( const CreateBulletMessage& message );
+	static void OnDestroyEntity( const DestroyEntityMessage& message );
 
 	
 	SGD::HTexture m_hLevel1Background = SGD::INVALID_HANDLE;
@@ -0,0 +1,39 @@
+//*********************************************************************//
+//	File:		HEntity.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	HEntity class identifies an entity stored in the
+//				Entity Manager without holding a reference to it
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_Handle.h"		// Handle type
+class EntityManager;						// EntityManager type
+
+
+//*********************************************************************//
+// HEntity class
+//	- generational handle: index + reuse bits, packed by SGD's HandleDecoder
+//	- does NOT keep the entity alive: once the entity is removed the
+//	  handle goes stale, and EntityManager::GetEntity returns nullptr
+class HEntity : private SGD::SGD_IMPLEMENTATION::Handle
+{
+public:
+	//*****************************************************************//
+	// Constructor
+	HEntity( const Handle& h = Handle() )	: Handle( h )	{	}
+
+	// Comparison operators for parent type
+	using Handle::operator ==;
+	using Handle::operator !=;
+	using Handle::operator <;
+
+	// Comparison operators
+	bool operator == ( const HEntity& h ) const		{	return Handle(*this) == Handle(h);	}
+	bool operator != ( const HEntity& h ) const		{	return Handle(*this) != Handle(h);	}
+	bool operator <  ( const HEntity& h ) const		{	return Handle(*this) <  Handle(h);	}
+
+	// Only the EntityManager can upcast to a Handle
+	friend class EntityManager;
+};
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "../SGD Wrappers/SGD_Geometry.h"	// Rectangle type
+#include "HEntity.h"						// HEntity type
+class TransformStore;						// TransformStore type
 
 
 //*********************************************************************//
@@ -19,6 +21,20 @@
 class IEntity
 {
 public:
+	//*****************************************************************//
+	// Storage Slot:
+	//	- where the Entity Manager stores the entity
+	struct StorageSlot
+	{
+		enum { INVALID = 0xFFFFFFFF };
+
+		unsigned int	bucket			= INVALID;	// INVALID when not stored
+		unsigned int	index			= INVALID;	// position within the bucket
+		bool			destroyPending	= false;	// queued for deferred removal
+		HEntity			handle;						// INVALID_HANDLE when not stored
+	};
+
+
 	//*****************************************************************//
 	// Interface:
 	//	- pure virtual methods MUST be overridden in the child class
@@ -28,6 +44,7 @@ public:
 	virtual int		GetType			( void )	const			= 0;
 	virtual SGD::Rectangle GetRect	( void )	const			= 0;
 	virtual void	HandleCollision	( const IEntity* pOther )	= 0;
+	virtual SGD::Vector GetDisplacement( void ) const		= 0;	// movement during the last update
 
 
 	//*****************************************************************//
@@ -37,6 +54,22 @@ public:
 	virtual void	AddRef			( void )					= 0;
 	virtual void	Release			( void )					= 0;
 
+
+	//*****************************************************************//
+	// Transform Storage:
+	//	- the Entity Manager keeps the transforms of its entities
+	//	  in one store, so attach on add & detach on remove
+	virtual void	AttachTransform	( TransformStore* pStore )	= 0;
+	virtual void	DetachTransform	( void )					= 0;
+
+
+	//*****************************************************************//
+	// Storage:
+	//	- the Entity Manager records the entity's slot so it can
+	//	  be removed in constant time
+	virtual StorageSlot	GetStorageSlot	( void ) const						= 0;
+	virtual void		SetStorageSlot	( const StorageSlot& slot )			= 0;
+
 protected:
 	//*****************************************************************//
 	// Destructor MUST be virtual
@@ -0,0 +1,297 @@
+//*********************************************************************//
+//	File:		JobSystem.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	JobSystem class runs chunks of work across a pool
+//				of work-stealing worker threads
+//*********************************************************************//
+
+#include "JobSystem.h"
+
+#include "../SGD Wrappers/SGD_Utilities.h"
+#include "Profiler.h"
+
+
+//*********************************************************************//
+// Calling thread's index (0 = main / not a worker)
+static SGD_THREAD_LOCAL unsigned int s_unThreadIndex = 0;
+
+
+//*********************************************************************//
+// SINGLETON
+//	- instantiate the static member
+/*static*/ JobSystem* JobSystem::s_pInstance = nullptr;
+
+// GetInstance
+//	- allocate the singleton if necessary
+//	- return the singleton
+/*static*/ JobSystem* JobSystem::GetInstance( void )
+{
+	if( s_pInstance == nullptr )
+		s_pInstance = new JobSystem;
+
+	return s_pInstance;
+}
+
+// DeleteInstance
+//	- deallocate the singleton
+/*static*/ void JobSystem::DeleteInstance( void )
+{
+	delete s_pInstance;
+	s_pInstance = nullptr;
+}
+
+
+//*********************************************************************//
+// Constructor & Destructor
+JobSystem::JobSystem( void )
+	: m_unQueued( 0 ), m_bRunning( false )
+{
+}
+
+JobSystem::~JobSystem( void )
+{
+	// Stop the workers if Terminate was skipped
+	Terminate();
+}
+
+
+//*********************************************************************//
+// Initialize
+//	- start the worker threads
+bool JobSystem::Initialize( unsigned int numThreads )
+{
+	SGD_ASSERT( m_bRunning == false,
+				"JobSystem::Initialize - already initialized" );
+	if( m_bRunning == true )
+		return false;
+
+
+	// One thread per core by default
+	if( numThreads == 0 )
+		numThreads = std::thread::hardware_concurrency();
+	if( numThreads == 0 )
+		numThreads = 1;
+
+
+	// Every thread (including main) gets a queue
+	for( unsigned int i = 0; i < numThreads; i++ )
+		m_vQueues.push_back( new JobQueue );
+
+	m_bRunning = true;
+	for( unsigned int i = 1; i < numThreads; i++ )
+		m_vWorkers.push_back( std::thread( &JobSystem::WorkerLoop, this, i ) );
+
+	return true;
+}
+
+
+//*********************************************************************//
+// Terminate
+//	- wake & join the worker threads
+void JobSystem::Terminate( void )
+{
+	if( m_bRunning == false )
+		return;
+
+	{
+		std::lock_guard< std::mutex > lock( m_mtxWake );
+		m_bRunning = false;
+	}
+	m_cvWake.notify_all();
+
+	for( unsigned int i = 0; i < m_vWorkers.size(); i++ )
+		m_vWorkers[ i ].join();
+	m_vWorkers.clear();
+
+	for( unsigned int i = 0; i < m_vQueues.size(); i++ )
+		delete m_vQueues[ i ];
+	m_vQueues.clear();
+}
+
+
+//*********************************************************************//
+// GetThreadIndex
+//	- the calling thread's index
+unsigned int JobSystem::GetThreadIndex( void ) const
+{
+	return s_unThreadIndex;
+}
+
+
+//*********************************************************************//
+// CountChunks
+//	- number of chunks for the count & chunk size
+/*static*/ unsigned int JobSystem::CountChunks( unsigned int count, unsigned int chunkSize )
+{
+	if( chunkSize == 0 )
+		chunkSize = 1;
+
+	return ( count + chunkSize - 1 ) / chunkSize;
+}
+
+
+//*********************************************************************//
+// ParallelFor
+//	- split [0, count) into chunks & spread them over the queues
+//	- the calling thread works (and steals) until every chunk is done
+void JobSystem::ParallelFor( unsigned int count, unsigned int chunkSize, JobFunction pFunction, void* data )
+{
+	// Validate the parameters
+	SGD_ASSERT( pFunction != nullptr,
+				"JobSystem::ParallelFor - function cannot be null" );
+	if( pFunction == nullptr || count == 0 )
+		return;
+
+	if( chunkSize == 0 )
+		chunkSize = 1;
+
+	unsigned int numChunks = CountChunks( count, chunkSize );
+
+
+	// No workers (or only one chunk)? Run in order on this thread
+	if( m_vWorkers.empty() == true || numChunks == 1 )
+	{
+		for( unsigned int c = 0; c < numChunks; c++ )
+		{
+			unsigned int begin	= c * chunkSize;
+			unsigned int end	= ( begin + chunkSize < count ) ? begin + chunkSize : count;
+			pFunction( data, begin, end, c );
+		}
+		return;
+	}
+
+
+	// Count the jobs before they can be popped
+	m_unQueued += numChunks;
+
+	// Deal the chunks out round-robin, starting with the calling thread
+	std::atomic< unsigned int > remaining( numChunks );
+	unsigned int self = s_unThreadIndex;
+	unsigned int profileParent = Profiler::GetOpenSample();
+	unsigned int numQueues = m_vQueues.size();
+
+	for( unsigned int q = 0; q < numQueues; q++ )
+	{
+		JobQueue* pQueue = m_vQueues[ ( self + q ) % numQueues ];
+		std::lock_guard< std::mutex > lock( pQueue->mutex );
+
+		for( unsigned int c = q; c < numChunks; c += numQueues )
+		{
+			Job job;
+			job.pFunction		= pFunction;
+			job.pData			= data;
+			job.begin			= c * chunkSize;
+			job.end				= ( job.begin + chunkSize < count ) ? job.begin + chunkSize : count;
+			job.chunk			= c;
+			job.pRemaining		= &remaining;
+			job.profileParent	= profileParent;
+
+			// Own queue pops from the back, so push the chunks in reverse
+			pQueue->jobs.push_front( job );
+		}
+	}
+
+	// Wake the workers (lock so a worker cannot miss the notify)
+	{
+		std::lock_guard< std::mutex > lock( m_mtxWake );
+	}
+	m_cvWake.notify_all();
+
+
+	// Help until every chunk is done
+	while( remaining.load() > 0 )
+	{
+		Job job;
+		if( PopJob( self, job ) == true || StealJob( self, job ) == true )
+			RunJob( job );
+		else
+			std::this_thread::yield();
+	}
+}
+
+
+//*********************************************************************//
+// PopJob
+//	- take the newest job from the thread's own queue
+bool JobSystem::PopJob( unsigned int thread, Job& job )
+{
+	JobQueue* pQueue = m_vQueues[ thread ];
+	std::lock_guard< std::mutex > lock( pQueue->mutex );
+
+	if( pQueue->jobs.empty() == true )
+		return false;
+
+	job = pQueue->jobs.back();
+	pQueue->jobs.pop_back();
+	--m_unQueued;
+	return true;
+}
+
+
+//*********************************************************************//
+// StealJob
+//	- take the oldest job from another thread's queue
+bool JobSystem::StealJob( unsigned int thread, Job& job )
+{
+	unsigned int numQueues = m_vQueues.size();
+
+	for( unsigned int q = 1; q < numQueues; q++ )
+	{
+		JobQueue* pQueue = m_vQueues[ ( thread + q ) % numQueues ];
+		std::lock_guard< std::mutex > lock( pQueue->mutex );
+
+		if( pQueue->jobs.empty() == false )
+		{
+			job = pQueue->jobs.front();
+			pQueue->jobs.pop_front();
+			--m_unQueued;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//*********************************************************************//
+// RunJob
+//	- process the chunk & count it as done
+//	- its profiler zones nest under the zone that started the
+//	  ParallelFor, whichever thread runs it
+void JobSystem::RunJob( const Job& job )
+{
+	unsigned int profileOpen = Profiler::GetOpenSample();
+	Profiler::SetOpenSample( job.profileParent );
+
+	job.pFunction( job.pData, job.begin, job.end, job.chunk );
+
+	Profiler::SetOpenSample( profileOpen );
+	--( *job.pRemaining );
+}
+
+
+//*********************************************************************//
+// WorkerLoop
+//	- run jobs until terminated, sleeping while there are none
+void JobSystem::WorkerLoop( unsigned int thread )
+{
+	s_unThreadIndex = thread;
+
+	while( true )
+	{
+		Job job;
+		if( PopJob( thread, job ) == true || StealJob( thread, job ) == true )
+		{
+			RunJob( job );
+			continue;
+		}
+
+		// Sleep until more jobs are queued
+		std::unique_lock< std::mutex > lock( m_mtxWake );
+		m_cvWake.wait( lock, [this]() { return m_unQueued.load() > 0 || m_bRunning.load() == false; } );
+
+		if( m_bRunning.load() == false )
+			break;
+	}
+}
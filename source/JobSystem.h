@@ -0,0 +1,108 @@
+//*********************************************************************//
+//	File:		JobSystem.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	JobSystem class runs chunks of work across a pool
+//				of work-stealing worker threads
+//*********************************************************************//
+
+#pragma once
+
+#include <vector>				// std::vector type
+#include <deque>				// std::deque type
+#include <thread>				// std::thread type
+#include <mutex>				// std::mutex type
+#include <condition_variable>	// std::condition_variable type
+#include <atomic>				// std::atomic type
+
+
+//*********************************************************************//
+// JobSystem class
+//	- every thread owns a job queue: it pops work from the back of
+//	  its own queue & steals from the front of the others
+//	- the calling (main) thread is thread 0 and helps while waiting
+//	- without workers (or before Initialize) everything runs serially
+//	- SINGLETON
+class JobSystem
+{
+public:
+	//*****************************************************************//
+	// SINGLETON!
+	static JobSystem*	GetInstance		( void );
+	static void			DeleteInstance	( void );
+
+
+	//*****************************************************************//
+	// Setup & Cleanup
+	//	- numThreads includes the main thread (0 = one per core)
+	bool	Initialize	( unsigned int numThreads = 0 );
+	void	Terminate	( void );
+
+	unsigned int	GetNumThreads	( void ) const	{	return m_vQueues.empty() ? 1 : (unsigned int)m_vQueues.size();	}
+	unsigned int	GetThreadIndex	( void ) const;		// calling thread (0 = main / not a worker)
+
+
+	//*****************************************************************//
+	// Job function:
+	//	- processes the items [begin, end) of one chunk
+	//	- chunk is the chunk's index (chunks are split the same way
+	//	  regardless of the thread count)
+	typedef void (*JobFunction)( void* data, unsigned int begin, unsigned int end, unsigned int chunk );
+
+	// Number of chunks ParallelFor will split the count into
+	static unsigned int	CountChunks	( unsigned int count, unsigned int chunkSize );
+
+	// Run the function over [0, count) in chunks, returns when every chunk is done
+	void	ParallelFor	( unsigned int count, unsigned int chunkSize, JobFunction pFunction, void* data );
+
+private:
+	//*****************************************************************//
+	// SINGLETON (not-dynamically allocated)
+	JobSystem( void );
+	~JobSystem( void );
+
+	JobSystem( const JobSystem& )				= delete;
+	JobSystem& operator= ( const JobSystem& )	= delete;
+
+	static JobSystem*	s_pInstance;
+
+
+	//*****************************************************************//
+	// Job: one chunk of a ParallelFor
+	struct Job
+	{
+		JobFunction						pFunction;
+		void*							pData;
+		unsigned int					begin;
+		unsigned int					end;
+		unsigned int					chunk;
+		std::atomic< unsigned int >*	pRemaining;		// chunks left in the ParallelFor
+		unsigned int					profileParent;	// Profiler sample open at the ParallelFor
+	};
+
+	struct JobQueue
+	{
+		std::mutex			mutex;
+		std::deque< Job >	jobs;
+	};
+
+
+	//*****************************************************************//
+	// Helpers:
+	bool	PopJob		( unsigned int thread, Job& job );		// own queue (back)
+	bool	StealJob	( unsigned int thread, Job& job );		// other queues (front)
+	void	RunJob		( const Job& job );
+	void	WorkerLoop	( unsigned int thread );
+
+
+	//*****************************************************************//
+	// members:
+	std::vector< JobQueue* >		m_vQueues;					// one per thread (0 = main)
+	std::vector< std::thread >		m_vWorkers;					// threads 1 .. n-1
+
+	std::mutex						m_mtxWake;					// sleeping workers
+	std::condition_variable			m_cvWake;
+	std::atomic< unsigned int >		m_unQueued;					// jobs waiting in any queue
+	std::atomic< bool >				m_bRunning;
+
+};
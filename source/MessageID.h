@@ -10,7 +10,8 @@
 
 //*********************************************************************//
 // MessageID enum class
-//	- unique identifiers for messages sent to Game::MessageProc
+//	- unique identifiers (& MessageBus types) of the messages
+//	  handled by the GameplayState
 enum class MessageID	
 {
 	MSG_CREATE_BULLET,
@@ -0,0 +1,173 @@
+//*********************************************************************//
+//	File:		ObjectPool.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	ObjectPool class recycles fixed-size memory blocks
+//				for frequently created objects
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_Utilities.h"	// SGD_ASSERT
+#include <vector>							// std::vector type
+#include <type_traits>						// std::aligned_storage
+
+
+//*********************************************************************//
+// ObjectPool class
+//	- hands out raw memory for one DataType at a time
+//	- blocks are allocated in chunks & recycled through a free list
+//	- when every block is in use, a new chunk is added (a 'miss')
+//	- used by class-specific operator new / delete, so the object is
+//	  constructed fresh (reset) each time it is handed out
+template< typename DataType >
+class ObjectPool
+{
+public:
+	//*****************************************************************//
+	// Constructor & destructor
+	explicit ObjectPool( unsigned int chunkSize = 64 );
+	~ObjectPool( void );
+
+
+	//*****************************************************************//
+	// Block Storage:
+	void*	Allocate	( void );
+	void	Deallocate	( void* pBlock );
+	void	Reserve		( unsigned int capacity );		// grow up-front to avoid misses
+
+
+	//*****************************************************************//
+	// Stats:
+	unsigned int	GetCapacity		( void ) const	{	return m_unCapacity;	}	// blocks allocated
+	unsigned int	GetInUse		( void ) const	{	return m_unInUse;		}	// blocks handed out
+	unsigned int	GetHighWater	( void ) const	{	return m_unHighWater;	}	// most blocks in use at once
+	unsigned int	GetMisses		( void ) const	{	return m_unMisses;		}	// allocations that had to grow the pool
+
+private:
+	//*****************************************************************//
+	// Not copyable
+	ObjectPool( const ObjectPool& )				= delete;
+	ObjectPool& operator= ( const ObjectPool& )	= delete;
+
+
+	//*****************************************************************//
+	// Block: object storage, or the next free block while unused
+	union Block
+	{
+		Block*	pNext;
+		typename std::aligned_storage< sizeof( DataType ), std::alignment_of< DataType >::value >::type	storage;
+	};
+
+	void	AddChunk	( unsigned int count );
+
+
+	//*****************************************************************//
+	// members:
+	std::vector< Block* >	m_vChunks;					// allocated arrays of blocks
+	Block*					m_pFreeList		= nullptr;	// unused blocks
+	unsigned int			m_unChunkSize;				// blocks per new chunk
+
+	unsigned int			m_unCapacity	= 0;
+	unsigned int			m_unInUse		= 0;
+	unsigned int			m_unHighWater	= 0;
+	unsigned int			m_unMisses		= 0;
+
+};
+
+
+//*********************************************************************//
+// Constructor
+//	- the pool starts empty: Reserve to pre-allocate
+template< typename DataType >
+ObjectPool< DataType >::ObjectPool( unsigned int chunkSize )
+	: m_unChunkSize( chunkSize > 0 ? chunkSize : 1 )
+{
+}
+
+
+//*********************************************************************//
+// Destructor
+//	- deallocate every chunk (all objects should be released by now)
+template< typename DataType >
+ObjectPool< DataType >::~ObjectPool( void )
+{
+	SGD_ASSERT( m_unInUse == 0,
+				"ObjectPool::~ObjectPool - objects are still in use" );
+
+	for( unsigned int i = 0; i < m_vChunks.size(); i++ )
+		delete[] m_vChunks[ i ];
+}
+
+
+//*********************************************************************//
+// Allocate
+//	- pop a block off the free list (grow if there is none)
+template< typename DataType >
+void* ObjectPool< DataType >::Allocate( void )
+{
+	if( m_pFreeList == nullptr )
+	{
+		++m_unMisses;
+		AddChunk( m_unChunkSize );
+	}
+
+	Block* pBlock = m_pFreeList;
+	m_pFreeList = pBlock->pNext;
+
+	if( ++m_unInUse > m_unHighWater )
+		m_unHighWater = m_unInUse;
+
+	return pBlock;
+}
+
+
+//*********************************************************************//
+// Deallocate
+//	- push the block back onto the free list
+template< typename DataType >
+void ObjectPool< DataType >::Deallocate( void* pBlock )
+{
+	// Quietly ignore null (like delete)
+	if( pBlock == nullptr )
+		return;
+
+	SGD_ASSERT( m_unInUse > 0,
+				"ObjectPool::Deallocate - more blocks returned than handed out" );
+
+	Block* pFree = reinterpret_cast< Block* >( pBlock );
+	pFree->pNext = m_pFreeList;
+	m_pFreeList = pFree;
+
+	--m_unInUse;
+}
+
+
+//*********************************************************************//
+// Reserve
+//	- make sure the capacity can hold the number of blocks
+template< typename DataType >
+void ObjectPool< DataType >::Reserve( unsigned int capacity )
+{
+	if( capacity > m_unCapacity )
+		AddChunk( capacity - m_unCapacity );
+}
+
+
+//*********************************************************************//
+// AddChunk
+//	- allocate more blocks & thread them onto the free list
+template< typename DataType >
+void ObjectPool< DataType >::AddChunk( unsigned int count )
+{
+	Block* pChunk = new Block[ count ];
+	m_vChunks.push_back( pChunk );
+
+	for( unsigned int i = 0; i < count; i++ )
+	{
+		pChunk[ i ].pNext = m_pFreeList;
+		m_pFreeList = &pChunk[ i ];
+	}
+
+	m_unCapacity += count;
+}
@@ -11,16 +11,15 @@
 #include "MessageID.h"
 #include "CreateBulletMessage.h"
 #include "Enemy.h"
+#include "GameEvents.h"
 
 
-#include "../SGD Wrappers/SGD_Message.h"
 #include "../SGD Wrappers/SGD_GraphicsManager.h"
 #include "../SGD Wrappers/SGD_AudioManager.h"
 #include "../SGD Wrappers/SGD_InputManager.h"
 #include "../SGD Wrappers/SGD_Event.h"
 #include "../SGD Wrappers/SGD_EventManager.h"
-#include "../SGD Wrappers/SGD_MessageManager.h"
-#include "../SGD Wrappers/SGD_Message.h"
+#include "../SGD Wrappers/SGD_MessageBus.h"
 
 
 
@@ -30,8 +29,8 @@
 Player::Player()
 {
 	SetImage(Game::GetInstance()->GetPlayerImg());
-	RegisterForEvent("ENEMY_DESTROYED");
-	RegisterForEvent("GAME_OVER");
+	RegisterForEvent(GameEvent::ENEMY_DESTROYED);
+	RegisterForEvent(GameEvent::GAME_OVER);
 }
 
 
@@ -50,18 +49,18 @@ void Player::Update(float _elapsedTime)
 	{
 		if (SGD::InputManager::GetInstance()->IsKeyDown(SGD::Key::D))
 		{
-			m_ptPosition.x = GetPosition().x + GetVelocity().x * _elapsedTime * 60;
+			SetPosition(SGD::Point{ GetPosition().x + GetVelocity().x * _elapsedTime * 60, GetPosition().y });
 			SetDirection(RIGHT);
 		}
 		if (SGD::InputManager::GetInstance()->IsKeyDown(SGD::Key::A))
 		{
-			m_ptPosition.x = GetPosition().x - GetVelocity().x * _elapsedTime * 60;
+			SetPosition(SGD::Point{ GetPosition().x - GetVelocity().x * _elapsedTime * 60, GetPosition().y });
 			SetDirection(LEFT);
 		}
 		if (SGD::InputManager::GetInstance()->IsKeyDown(SGD::Key::W))
-			m_ptPosition.y = GetPosition().y - GetVelocity().y * _elapsedTime * 60;
+			SetPosition(SGD::Point{ GetPosition().x, GetPosition().y - GetVelocity().y * _elapsedTime * 60 });
 		if (SGD::InputManager::GetInstance()->IsKeyDown(SGD::Key::S))
-			m_ptPosition.y = GetPosition().y + GetVelocity().y * _elapsedTime * 60;
+			SetPosition(SGD::Point{ GetPosition().x, GetPosition().y + GetVelocity().y * _elapsedTime * 60 });
 
 		if ((SGD::InputManager::GetInstance()->IsKeyPressed(SGD::Key::Space)
 			&& m_fShotCooldown > SECONDARY_SHOT_DELAY) 
@@ -70,8 +69,7 @@ void Player::Update(float _elapsedTime)
 		{
 			SGD::AudioManager::GetInstance()->PlayAudio(GetSecondarySfx(), false);
 			m_fShotCooldown = 0.0f;
-			CreateBulletMessage* message = new CreateBulletMessage(this);
-			message->QueueMessage();
+			SGD::MessageBus::GetInstance()->Queue(CreateBulletMessage(this));
 			
 		}
 
@@ -88,8 +86,7 @@ void Player::Update(float _elapsedTime)
 		{
 			m_fincreaseCharge = 0.0f;
 			GameplayState::GetInstance()->SetDoubleDmg(true);
-			CreateBulletMessage* message = new CreateBulletMessage(this);
-			message->QueueMessage();
+			SGD::MessageBus::GetInstance()->Queue(CreateBulletMessage(this));
 		}
 
 		
@@ -100,38 +97,39 @@ void Player::Update(float _elapsedTime)
 
 void Player::Render(void)
 {
+	SGD::Point pos = GetRenderPosition();
 
 	if (GetDirection() == RIGHT)
 	SGD::GraphicsManager::GetInstance()->DrawTextureSection(GetImage(),
-		m_ptPosition, SGD::Rectangle{ 0, 0, 32, 32 }, {}, {}, {}, SGD::Size{ 2.5f, 2.5f }); 
+		pos, SGD::Rectangle{ 0, 0, 32, 32 }, {}, {}, {}, SGD::Size{ 2.5f, 2.5f }); 
 	else
 		SGD::GraphicsManager::GetInstance()->DrawTextureSection(GetImage(),
-		SGD::Point{ m_ptPosition.x + GetSize().width * 2.5f, m_ptPosition.y }, SGD::Rectangle{ 0, 0, 32, 32 }, {}, {}, {}, SGD::Size{ -2.5f, 2.5f });
+		SGD::Point{ pos.x + GetSize().width * 2.5f, pos.y }, SGD::Rectangle{ 0, 0, 32, 32 }, {}, {}, {}, SGD::Size{ -2.5f, 2.5f });
 
-	SGD::GraphicsManager::GetInstance()->DrawLine(SGD::Point{ m_ptPosition.x, m_ptPosition.y },
-		SGD::Point{ m_ptPosition.x + m_fincreaseCharge * 2.5f, m_ptPosition.y }, SGD::Color{ 0, 255, 0 });
+	SGD::GraphicsManager::GetInstance()->DrawLine(pos,
+		SGD::Point{ pos.x + m_fincreaseCharge * 2.5f, pos.y }, SGD::Color{ 0, 255, 0 });
 	
 }
 
 void Player::PlayerInBounds(void)
 {
 	if (GetPosition().x <= 0)
-		m_ptPosition.x = 0;
+		SetPosition(SGD::Point{ 0, GetPosition().y });
 	if (GetPosition().x > Game::GetInstance()->GetScreenSize().width - GetSize().width * 2.5f)
-		m_ptPosition.x = Game::GetInstance()->GetScreenSize().width - GetSize().width * 2.5f;
+		SetPosition(SGD::Point{ Game::GetInstance()->GetScreenSize().width - GetSize().width * 2.5f, GetPosition().y });
 	if (GetPosition().y <= 0)
-		m_ptPosition.y = 0;
+		SetPosition(SGD::Point{ GetPosition().x, 0 });
 	if (GetPosition().y > Game::GetInstance()->GetScreenSize().height - GetSize().height * 2.5f)
-		m_ptPosition.y = Game::GetInstance()->GetScreenSize().height - GetSize().height * 2.5f;
+		SetPosition(SGD::Point{ GetPosition().x, Game::GetInstance()->GetScreenSize().height - GetSize().height * 2.5f });
 }
 
 void Player::HandleEvent(const SGD::Event* pEvent)
 {
-	if (pEvent->GetEventID() == "ENEMY_DESTROYED")
+	if (pEvent->GetEventID() == GameEvent::ENEMY_DESTROYED)
 	{
-		SetScore(GetScore() + 50);
+		SetScore(GetScore() + 50 * pEvent->GetCount());	// coalesced kills
 	}
-	else if (pEvent->GetEventID() == "GAME_OVER")
+	else if (pEvent->GetEventID() == GameEvent::GAME_OVER)
 	{
 		SetAlive(false);
 		GameplayState::GetInstance()->SetGameLost(true);
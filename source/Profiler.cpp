@@ -0,0 +1,369 @@
+//*********************************************************************//
+//	File:		Profiler.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Profiler class times named zones of each frame,
+//				draws their statistics & exports them as a trace
+//*********************************************************************//
+
+#include "Profiler.h"
+
+#include "../SGD Wrappers/SGD_Utilities.h"
+#include "BitmapFont.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#if defined( _WIN32 )
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#else
+	#include <chrono>
+#endif
+
+
+//*********************************************************************//
+// Calling thread's innermost open zone (its sample)
+static SGD_THREAD_LOCAL unsigned int s_unOpenSample = Profiler::NO_SAMPLE;
+
+
+//*********************************************************************//
+// SINGLETON
+//	- instantiate the static member
+/*static*/ Profiler* Profiler::s_pInstance = nullptr;
+
+// GetInstance
+//	- allocate the singleton if necessary
+//	- return the singleton
+/*static*/ Profiler* Profiler::GetInstance( void )
+{
+	if( s_pInstance == nullptr )
+		s_pInstance = new Profiler;
+
+	return s_pInstance;
+}
+
+// DeleteInstance
+//	- deallocate the singleton
+/*static*/ void Profiler::DeleteInstance( void )
+{
+	delete s_pInstance;
+	s_pInstance = nullptr;
+}
+
+
+//*********************************************************************//
+// Constructor
+//	- read the clock frequency
+Profiler::Profiler( void )
+	: m_unWrite( 0 )
+{
+#if defined( _WIN32 )
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency( &frequency );
+	m_llFrequency = frequency.QuadPart;
+#else
+	m_llFrequency = 1000000000;		// steady_clock nanoseconds
+#endif
+}
+
+
+//*********************************************************************//
+// GetTicks
+//	- high resolution timestamp
+/*static*/ long long Profiler::GetTicks( void )
+{
+#if defined( _WIN32 )
+	LARGE_INTEGER now;
+	QueryPerformanceCounter( &now );
+	return now.QuadPart;
+#else
+	return std::chrono::duration_cast< std::chrono::nanoseconds >(
+		std::chrono::steady_clock::now().time_since_epoch() ).count();
+#endif
+}
+
+
+//*********************************************************************//
+// BeginFrame
+//	- open the frame's own zone (the root of every zone in it)
+void Profiler::BeginFrame( void )
+{
+	m_unFrameSample	= OpenZone( "Game::Update" );
+	m_llFrameStart	= m_aSamples[ m_unFrameSample % MAX_SAMPLES ].start;
+}
+
+
+//*********************************************************************//
+// EndFrame
+//	- close the frame's zone
+//	- total each zone's time into the frame's history slot
+void Profiler::EndFrame( void )
+{
+	CloseZone( m_unFrameSample, NO_SAMPLE );
+
+	Frame& frame = m_aFrames[ m_unFrames % MAX_FRAMES ];
+	frame.start			= m_llFrameStart;
+	frame.end			= GetTicks();
+	frame.firstSample	= m_unFrameSample;
+	frame.endSample		= m_unWrite.load();
+
+	unsigned int slot = m_unFrames % MAX_FRAMES;
+	for( unsigned int z = 0; z < m_vZones.size(); z++ )
+		m_vZones[ z ].history[ slot ] = 0.0f;
+
+
+	// Only the samples still in the ring
+	unsigned int first = frame.firstSample;
+	if( frame.endSample - first > MAX_SAMPLES )
+		first = frame.endSample - MAX_SAMPLES;
+
+	m_vSampleZones.resize( frame.endSample - first );
+
+	for( unsigned int s = first; s != frame.endSample; s++ )
+	{
+		const Sample& sample = m_aSamples[ s % MAX_SAMPLES ];
+
+		// Parents are claimed before their children: one from
+		// before this range (or NO_SAMPLE) makes the zone a root
+		int parent = -1;
+		if( sample.parent - first < s - first )
+			parent = m_vSampleZones[ sample.parent - first ];
+
+		int zone = FindZone( sample.name, parent );
+		if( zone < 0 )
+			zone = AddZone( sample.name, parent );
+
+		m_vSampleZones[ s - first ] = zone;
+		m_vZones[ zone ].history[ slot ] += ToMs( sample.end - sample.start );
+	}
+
+	++m_unFrames;
+}
+
+
+//*********************************************************************//
+// OpenZone
+//	- claim the next ring slot & start the sample
+//	- the zone nests under the thread's open sample until closed
+//	- safe from any thread (the slot is claimed atomically)
+unsigned int Profiler::OpenZone( const char* name )
+{
+	unsigned int index = m_unWrite.fetch_add( 1 );
+
+	Sample& sample = m_aSamples[ index % MAX_SAMPLES ];
+	sample.name		= name;
+	sample.parent	= s_unOpenSample;
+	sample.thread	= (unsigned short)JobSystem::GetInstance()->GetThreadIndex();
+	sample.start	= GetTicks();
+	sample.end		= sample.start;
+
+	s_unOpenSample = index;
+	return index;
+}
+
+
+//*********************************************************************//
+// CloseZone
+//	- end the sample & reopen its parent
+void Profiler::CloseZone( unsigned int sample, unsigned int parent )
+{
+	m_aSamples[ sample % MAX_SAMPLES ].end = GetTicks();
+	s_unOpenSample = parent;
+}
+
+
+//*********************************************************************//
+// GetOpenSample & SetOpenSample
+//	- the calling thread's innermost open zone
+/*static*/ unsigned int Profiler::GetOpenSample( void )
+{
+	return s_unOpenSample;
+}
+
+/*static*/ void Profiler::SetOpenSample( unsigned int sample )
+{
+	s_unOpenSample = sample;
+}
+
+
+//*********************************************************************//
+// GetAverage
+//	- mean milliseconds per frame of the zone (depth-first index)
+float Profiler::GetAverage( unsigned int index ) const
+{
+	unsigned int count = std::min( m_unFrames, (unsigned int)MAX_FRAMES );
+	if( index >= m_vOrder.size() || count == 0 )
+		return 0.0f;
+
+	const Zone& zone = m_vZones[ m_vOrder[ index ] ];
+
+	float total = 0.0f;
+	for( unsigned int f = 0; f < count; f++ )
+		total += zone.history[ f ];
+
+	return total / count;
+}
+
+
+//*********************************************************************//
+// GetPercentile
+//	- milliseconds per frame the zone stays under for 'percent' %
+//	  of the frames
+float Profiler::GetPercentile( unsigned int index, float percent ) const
+{
+	unsigned int count = std::min( m_unFrames, (unsigned int)MAX_FRAMES );
+	if( index >= m_vOrder.size() || count == 0 )
+		return 0.0f;
+
+	const Zone& zone = m_vZones[ m_vOrder[ index ] ];
+
+	float sorted[ MAX_FRAMES ];
+	std::copy( zone.history, zone.history + count, sorted );
+
+	unsigned int rank = (unsigned int)( percent / 100.0f * ( count - 1 ) + 0.5f );
+	if( rank >= count )
+		rank = count - 1;
+
+	std::nth_element( sorted, sorted + rank, sorted + count );
+	return sorted[ rank ];
+}
+
+
+//*********************************************************************//
+// Render
+//	- one line per zone: average, 95th & 99th percentile
+//	- depth-first, each zone indented under its parent
+void Profiler::Render( const BitmapFont* pFont, SGD::Point position ) const
+{
+	if( m_bOverlay == false || pFont == nullptr )
+		return;
+
+	std::ostringstream text;
+	text << std::fixed << std::setprecision( 2 ) << "ZONE MS   AVG   P95   P99\n";
+
+	for( unsigned int z = 0; z < GetNumZones(); z++ )
+	{
+		text << std::string( GetZoneDepth( z ) * 2, ' ' ) << GetZoneName( z )
+			 << "  " << GetAverage( z )
+			 << "  " << GetPercentile( z, 95.0f )
+			 << "  " << GetPercentile( z, 99.0f ) << '\n';
+	}
+
+	pFont->Draw( text.str().c_str(), position, 0.4f, SGD::Color{ 255, 255, 255, 255 } );
+}
+
+
+//*********************************************************************//
+// DumpTrace
+//	- every zone becomes a complete ('X') event, in microseconds
+//	  from the start of the oldest frame
+bool Profiler::DumpTrace( const char* filename, unsigned int numFrames ) const
+{
+	// Clamp to the frames still kept
+	numFrames = std::min( numFrames, std::min( m_unFrames, (unsigned int)MAX_FRAMES ) );
+	if( numFrames == 0 )
+		return false;
+
+	std::ofstream fout;
+	fout.open( filename, std::ios::out | std::ios::trunc );
+	if( fout.is_open() == false )
+		return false;
+
+
+	const Frame& oldest = m_aFrames[ ( m_unFrames - numFrames ) % MAX_FRAMES ];
+	const Frame& newest = m_aFrames[ ( m_unFrames - 1 ) % MAX_FRAMES ];
+
+	// Only the samples still in the ring
+	unsigned int first = oldest.firstSample;
+	if( newest.endSample - first > MAX_SAMPLES )
+		first = newest.endSample - MAX_SAMPLES;
+
+	fout << std::fixed << std::setprecision( 3 );
+	fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	for( unsigned int s = first; s != newest.endSample; s++ )
+	{
+		const Sample& sample = m_aSamples[ s % MAX_SAMPLES ];
+
+		if( s != first )
+			fout << ",\n";
+
+		fout << "{\"name\":\"" << sample.name
+			 << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << sample.thread
+			 << ",\"ts\":" << ToMs( sample.start - oldest.start ) * 1000.0f
+			 << ",\"dur\":" << ToMs( sample.end - sample.start ) * 1000.0f << '}';
+	}
+
+	fout << "\n]}\n";
+	fout.close();
+	return true;
+}
+
+
+//*********************************************************************//
+// FindZone
+//	- index of the zone with the name under the parent, or -1
+//	- pointers are compared first (the names are literals)
+int Profiler::FindZone( const char* name, int parent ) const
+{
+	for( unsigned int z = 0; z < m_vZones.size(); z++ )
+		if( m_vZones[ z ].parent == parent && m_vZones[ z ].name == name )
+			return (int)z;
+
+	for( unsigned int z = 0; z < m_vZones.size(); z++ )
+		if( m_vZones[ z ].parent == parent && strcmp( m_vZones[ z ].name, name ) == 0 )
+			return (int)z;
+
+	return -1;
+}
+
+
+//*********************************************************************//
+// AddZone
+//	- start tracking a new zone (no time in the earlier frames)
+//	- it goes after its parent's last descendant in the
+//	  depth-first order (roots go last)
+int Profiler::AddZone( const char* name, int parent )
+{
+	Zone zone;
+	zone.name	= name;
+	zone.parent	= parent;
+	zone.depth	= ( parent >= 0 ) ? m_vZones[ parent ].depth + 1 : 0;
+	std::fill( zone.history, zone.history + MAX_FRAMES, 0.0f );
+
+	m_vZones.push_back( zone );
+	int index = (int)m_vZones.size() - 1;
+
+	unsigned int position = (unsigned int)m_vOrder.size();
+	if( parent >= 0 )
+	{
+		position = (unsigned int)( std::find( m_vOrder.begin(), m_vOrder.end(), (unsigned int)parent ) - m_vOrder.begin() ) + 1;
+		while( position < m_vOrder.size() && m_vZones[ m_vOrder[ position ] ].depth > m_vZones[ parent ].depth )
+			position++;
+	}
+
+	m_vOrder.insert( m_vOrder.begin() + position, (unsigned int)index );
+	return index;
+}
+
+
+//*********************************************************************//
+// ProfileScope
+//	- open the zone under the thread's open one
+ProfileScope::ProfileScope( const char* name )
+	: m_unParent( Profiler::GetOpenSample() )
+{
+	m_unSample = Profiler::GetInstance()->OpenZone( name );
+}
+
+//	- close the zone
+ProfileScope::~ProfileScope( void )
+{
+	Profiler::GetInstance()->CloseZone( m_unSample, m_unParent );
+}
@@ -0,0 +1,186 @@
+//*********************************************************************//
+//	File:		Profiler.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Profiler class times named zones of each frame,
+//				draws their statistics & exports them as a trace
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_Geometry.h"	// Point type
+#include <vector>							// std::vector type
+#include <atomic>							// std::atomic type
+class BitmapFont;							// BitmapFont type
+
+
+//*********************************************************************//
+// Profiler class
+//	- PROFILE_SCOPE( "name" ) times the rest of the enclosing block
+//	- zones are recorded into a ring buffer (lock-free, any thread)
+//	- BeginFrame / EndFrame bracket each frame (main thread only),
+//	  the frame itself is recorded as the "Game::Update" zone
+//	- zones form a tree: a zone is its name under its parent, the
+//	  zone open when it began (JobSystem jobs nest under the zone
+//	  that started the ParallelFor)
+//	- keeps the last MAX_FRAMES frames of per-zone totals for
+//	  the averages & percentiles
+//	- SINGLETON
+class Profiler
+{
+public:
+	//*****************************************************************//
+	// SINGLETON!
+	static Profiler*	GetInstance		( void );
+	static void			DeleteInstance	( void );
+
+
+	//*****************************************************************//
+	// Frames:
+	void	BeginFrame	( void );
+	void	EndFrame	( void );
+
+
+	//*****************************************************************//
+	// Zones:
+	//	- use PROFILE_SCOPE instead of calling OpenZone / CloseZone directly
+	//	- name MUST be a string literal (the pointer is stored)
+	//	- OpenZone returns the zone's sample, CloseZone takes it back
+	//	  with the sample that was open before (GetOpenSample)
+	enum { NO_SAMPLE = 0xFFFFFFFF };
+
+	static long long	GetTicks	( void );
+	long long			GetFrequency( void ) const		{	return m_llFrequency;	}	// ticks per second
+	unsigned int		OpenZone	( const char* name );
+	void				CloseZone	( unsigned int sample, unsigned int parent );
+
+	// Sample the calling thread's next zone nests under
+	static unsigned int	GetOpenSample	( void );
+	static void			SetOpenSample	( unsigned int sample );
+
+
+	//*****************************************************************//
+	// Zones seen so far, depth-first (children follow their parent,
+	// siblings in the order first recorded)
+	unsigned int	GetNumZones	( void ) const					{	return (unsigned int)m_vOrder.size();				}
+	const char*		GetZoneName	( unsigned int index ) const	{	return m_vZones[ m_vOrder[ index ] ].name;			}
+	unsigned int	GetZoneDepth( unsigned int index ) const	{	return m_vZones[ m_vOrder[ index ] ].depth;		}	// frame = 0
+
+	// Statistics (milliseconds per frame, over the kept frames)
+	float	GetAverage		( unsigned int index ) const;
+	float	GetPercentile	( unsigned int index, float percent ) const;
+
+
+	//*****************************************************************//
+	// Overlay:
+	bool	IsOverlayVisible	( void ) const			{	return m_bOverlay;		}
+	void	SetOverlayVisible	( bool visible )		{	m_bOverlay = visible;	}
+	void	Render				( const BitmapFont* pFont, SGD::Point position ) const;
+
+
+	//*****************************************************************//
+	// Trace Export:
+	//	- write the last numFrames frames as Chrome trace-event JSON
+	//	  (open in chrome://tracing)
+	bool	DumpTrace	( const char* filename, unsigned int numFrames ) const;
+
+private:
+	//*****************************************************************//
+	// SINGLETON (dynamically allocated)
+	Profiler( void );
+	~Profiler( void )	= default;
+
+	Profiler( const Profiler& )				= delete;
+	Profiler& operator= ( const Profiler& )	= delete;
+
+	static Profiler*	s_pInstance;
+
+
+	//*****************************************************************//
+	// Ring sizes (powers of 2)
+	enum { MAX_SAMPLES = 65536, MAX_FRAMES = 256 };
+
+	//*****************************************************************//
+	// One timed zone
+	struct Sample
+	{
+		const char*		name;
+		long long		start;
+		long long		end;
+		unsigned int	parent;		// sample open when it began (or NO_SAMPLE)
+		unsigned short	thread;		// JobSystem thread index
+	};
+
+	//*****************************************************************//
+	// One frame's range of samples
+	struct Frame
+	{
+		long long		start;
+		long long		end;
+		unsigned int	firstSample;	// write index at BeginFrame
+		unsigned int	endSample;		// write index at EndFrame
+	};
+
+	//*****************************************************************//
+	// Per-zone totals of the kept frames
+	struct Zone
+	{
+		const char*		name;
+		int				parent;					// zone index (-1 = root)
+		unsigned int	depth;					// parent's + 1 (root = 0)
+		float			history[ MAX_FRAMES ];	// ms per frame
+	};
+
+	int		FindZone	( const char* name, int parent ) const;
+	int		AddZone		( const char* name, int parent );
+	float	ToMs		( long long ticks ) const	{	return (float)( (double)ticks * 1000.0 / (double)m_llFrequency );	}
+
+
+	//*****************************************************************//
+	// members:
+	Sample						m_aSamples[ MAX_SAMPLES ];	// ring buffer
+	std::atomic< unsigned int >	m_unWrite;					// next sample (never wraps the ring index math)
+
+	Frame						m_aFrames[ MAX_FRAMES ];	// ring buffer
+	unsigned int				m_unFrames		= 0;		// frames ended so far
+	long long					m_llFrameStart	= 0;
+	unsigned int				m_unFrameSample	= 0;		// the frame's own zone
+
+	std::vector< Zone >			m_vZones;					// in the order first recorded
+	std::vector< unsigned int >	m_vOrder;					// zone indices, depth-first
+	std::vector< int >			m_vSampleZones;				// EndFrame scratch: zone of each sample
+	long long					m_llFrequency	= 1;		// ticks per second
+	bool						m_bOverlay		= false;
+
+};
+
+
+//*********************************************************************//
+// ProfileScope class
+//	- records a zone from construction to destruction
+class ProfileScope
+{
+public:
+	ProfileScope( const char* name );
+	~ProfileScope( void );
+
+private:
+	ProfileScope( const ProfileScope& )				= delete;
+	ProfileScope& operator= ( const ProfileScope& )	= delete;
+
+	unsigned int	m_unSample;		// Profiler::OpenZone
+	unsigned int	m_unParent;		// open before this one
+};
+
+
+//*********************************************************************//
+// PROFILE_SCOPE
+//	- times the rest of the enclosing block as the named zone
+//	- define PROFILER_DISABLED to compile the zones out
+#if defined( PROFILER_DISABLED )
+	#define PROFILE_SCOPE( name )
+#else
+	#define PROFILE_SCOPE_JOIN2( a, b )		a##b
+	#define PROFILE_SCOPE_JOIN( a, b )		PROFILE_SCOPE_JOIN2( a, b )
+	#define PROFILE_SCOPE( name )			ProfileScope PROFILE_SCOPE_JOIN( profileScope_, __LINE__ )( name )
+#endif
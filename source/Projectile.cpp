@@ -5,16 +5,53 @@
 //	Purpose:	Handles the Projectile entity
 //*********************************************************************//
 #include "Projectile.h"
-#include "DestroyEntityMessage.h"
+#include "EntityManager.h"
 #include "GameplayState.h"
 #include "Game.h"
 #include "Player.h"
+#include "GameEvents.h"
 
 #include "../SGD Wrappers/SGD_Event.h"
 #include "../SGD Wrappers/SGD_EventManager.h"
 
 
 
+//*********************************************************************//
+// GetPool
+//	- the shared pool of projectile blocks
+//	- check GetHighWater / GetMisses to size it for the heaviest waves
+/*static*/ ObjectPool<Projectile>& Projectile::GetPool(void)
+{
+	static ObjectPool<Projectile> s_Pool(64);
+	return s_Pool;
+}
+
+//*********************************************************************//
+// operator new
+//	- take a block from the pool (derived classes use the heap)
+/*static*/ void* Projectile::operator new(size_t size)
+{
+	if (size != sizeof(Projectile))
+		return ::operator new(size);
+
+	return GetPool().Allocate();
+}
+
+//*********************************************************************//
+// operator delete
+//	- return the block to the pool
+/*static*/ void Projectile::operator delete(void* p, size_t size)
+{
+	if (size != sizeof(Projectile))
+	{
+		::operator delete(p);
+		return;
+	}
+
+	GetPool().Deallocate(p);
+}
+
+
 Projectile::Projectile()
 {
 }
@@ -22,13 +59,11 @@ Projectile::Projectile()
 
 Projectile::~Projectile()
 {
-	if (m_etProjectileOwner != nullptr)
-	m_etProjectileOwner->Release();
 }
 
 void Projectile::Render(void)
 {
-	SGD::Point projPoint = SGD::Point{ GetPosition().x, GetPosition().y };
+	SGD::Point projPoint = GetRenderPosition();
 	SGD::GraphicsManager::GetInstance()->DrawTexture(GetImage(), projPoint);
 }
 
@@ -44,8 +79,7 @@ void Projectile::Update(float elapsedTime)
 			|| GetPosition().y < 0
 			|| GetPosition().y >= Game::GetInstance()->GetScreenSize().height)
 		{
-			DestroyEntityMessage* destroyMsg = new DestroyEntityMessage(this);
-			destroyMsg->QueueMessage();
+			GameplayState::GetInstance()->GetEntityManager()->DestroyEntity(this);
 		}
 
 		Entity::Update(elapsedTime);
@@ -54,35 +88,28 @@ void Projectile::Update(float elapsedTime)
 
 void Projectile::SetProjectileOwner(Entity* _owner)
 {
-	if (m_etProjectileOwner != nullptr)
-		m_etProjectileOwner->Release();
-	if (_owner != nullptr)
-		m_etProjectileOwner = _owner;
-	_owner->AddRef();
+	m_hProjectileOwner = (_owner != nullptr) ? _owner->GetHandle() : HEntity();
 }
 
 void Projectile::HandleCollision(const IEntity* pOther)
 {
-	if (GetProjectileOwner() != pOther)
+	if (GetProjectileOwner() != pOther->GetStorageSlot().handle)
 	{
-		SGD::Event* Event = new SGD::Event("ENEMY_HIT", nullptr, this);
+		SGD::Event* Event = new SGD::Event(GameEvent::ENEMY_HIT, nullptr, this);
 		SGD::EventManager::GetInstance()->QueueEvent(Event, pOther);
-		DestroyEntityMessage* destroyMsg = new DestroyEntityMessage(this);
-		destroyMsg->QueueMessage();
+		GameplayState::GetInstance()->GetEntityManager()->DestroyEntity(this);
 
 		/*if (GetProjectileOwner()->GetType() == ENT_ENEMY)
 		{
-			SGD::Event* Event = new SGD::Event("PLAYER_HIT", nullptr, this);
+			SGD::Event* Event = new SGD::Event(GameEvent::PLAYER_HIT, nullptr, this);
 			SGD::EventManager::GetInstance()->QueueEvent(Event, pOther);
-			DestroyEntityMessage* destroyMsg = new DestroyEntityMessage(this);
-			destroyMsg->QueueMessage();
+			GameplayState::GetInstance()->GetEntityManager()->DestroyEntity(this);
 		}
 		else if (GetProjectileOwner()->GetType() == ENT_PLAYER)
 		{
-			SGD::Event* Event = new SGD::Event("ENEMY_HIT", nullptr, this);
+			SGD::Event* Event = new SGD::Event(GameEvent::ENEMY_HIT, nullptr, this);
 			SGD::EventManager::GetInstance()->QueueEvent(Event, pOther);
-			DestroyEntityMessage* destroyMsg = new DestroyEntityMessage(this);
-			destroyMsg->QueueMessage();
+			GameplayState::GetInstance()->GetEntityManager()->DestroyEntity(this);
 		}*/
 	}
 
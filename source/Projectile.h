@@ -6,6 +6,8 @@
 //*********************************************************************//
 #pragma once
 #include "Entity.h"
+#include "ObjectPool.h"
+#include <cstddef>
 class Projectile :
 	public Entity
 {
@@ -18,14 +20,21 @@ public:
 	void Render(void);
 	void Update(float elapsedTime);
 
-	Entity* GetProjectileOwner() const { return m_etProjectileOwner; }
+	HEntity GetProjectileOwner() const { return m_hProjectileOwner; }
 
 	void SetProjectileOwner(Entity* _owner);
 
 	void HandleCollision(const IEntity* pOther);
 
+	// Pooled allocation:
+	//	- new / delete (from Release) recycle the pool's blocks
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size);
+
+	static ObjectPool<Projectile>& GetPool(void);
+
 private:
 
-	Entity* m_etProjectileOwner = nullptr;
+	HEntity m_hProjectileOwner;	// does not keep the owner alive
 };
 
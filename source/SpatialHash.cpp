@@ -0,0 +1,209 @@
+//*********************************************************************//
+//	File:		SpatialHash.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	SpatialHash class buckets rectangles into a uniform
+//				grid to find nearby collision candidates
+//*********************************************************************//
+
+#include "SpatialHash.h"
+
+#include "../SGD Wrappers/SGD_Utilities.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+//*********************************************************************//
+// SetCellSize
+//	- change the width & height of each grid cell
+//	- takes effect on the next Build
+void SpatialHash::SetCellSize( float size )
+{
+	// Validate the parameter
+	SGD_ASSERT( size > 0.0f,
+				"SpatialHash::SetCellSize - cell size must be positive" );
+	if( size <= 0.0f )
+		return;
+
+	m_fCellSize		= size;
+	m_fInvCellSize	= 1.0f / size;
+}
+
+
+//*********************************************************************//
+// Clear
+//	- forget every inserted rect (keeps the allocated memory)
+void SpatialHash::Clear( void )
+{
+	m_vEntries.clear();
+	m_vOversized.clear();
+	m_vCellIds.clear();
+	m_vSlotStart.clear();
+	m_unSlotMask = 0;
+}
+
+
+//*********************************************************************//
+// Insert
+//	- store the rect's cell range for the next Build
+void SpatialHash::Insert( unsigned int id, const SGD::Rectangle& rect )
+{
+	Entry entry;
+	entry.id = id;
+	ComputeCells( rect, entry.left, entry.top, entry.right, entry.bottom );
+
+	// Huge rects would flood the table, so every query reports them instead
+	if( (entry.right - entry.left + 1) * (entry.bottom - entry.top + 1) > MAX_CELLS_PER_RECT )
+		m_vOversized.push_back( id );
+	else
+		m_vEntries.push_back( entry );
+
+	// Make room for the id's query stamp
+	if( id >= m_vStamps.size() )
+		m_vStamps.resize( id + 1, 0 );
+}
+
+
+//*********************************************************************//
+// Build
+//	- counting sort of the inserted ids into the hashed cells,
+//	  so each table slot is one contiguous run of ids
+void SpatialHash::Build( void )
+{
+	// Count the cells covered by every entry
+	unsigned int total = 0;
+	for( unsigned int i = 0; i < m_vEntries.size(); i++ )
+	{
+		const Entry& e = m_vEntries[ i ];
+		total += (unsigned int)( (e.right - e.left + 1) * (e.bottom - e.top + 1) );
+	}
+
+	// Size the table to a power of 2, roughly twice the cell count
+	unsigned int slots = 64;
+	while( slots < total * 2 )
+		slots <<= 1;
+
+	m_unSlotMask = slots - 1;
+	m_vSlotStart.assign( slots + 1, 0 );
+	m_vCellIds.resize( total );
+
+
+	// Count the ids per slot
+	for( unsigned int i = 0; i < m_vEntries.size(); i++ )
+	{
+		const Entry& e = m_vEntries[ i ];
+		for( int y = e.top; y <= e.bottom; y++ )
+			for( int x = e.left; x <= e.right; x++ )
+				m_vSlotStart[ HashCell( x, y ) + 1 ]++;
+	}
+
+	// Prefix sum into starting offsets
+	for( unsigned int s = 0; s < slots; s++ )
+		m_vSlotStart[ s + 1 ] += m_vSlotStart[ s ];
+
+
+	// Scatter the ids (m_vSlotStart[s] is used as the write cursor,
+	// then shifted back afterwards)
+	for( unsigned int i = 0; i < m_vEntries.size(); i++ )
+	{
+		const Entry& e = m_vEntries[ i ];
+		for( int y = e.top; y <= e.bottom; y++ )
+			for( int x = e.left; x <= e.right; x++ )
+				m_vCellIds[ m_vSlotStart[ HashCell( x, y ) ]++ ] = e.id;
+	}
+
+	for( unsigned int s = slots; s > 0; s-- )
+		m_vSlotStart[ s ] = m_vSlotStart[ s - 1 ];
+	m_vSlotStart[ 0 ] = 0;
+}
+
+
+//*********************************************************************//
+// Query
+//	- collect every id sharing a (hashed) cell with the rect
+//	- ids are unique and sorted in ascending order
+void SpatialHash::Query( const SGD::Rectangle& rect, std::vector< unsigned int >& ids )
+{
+	ids.clear();
+
+	// Nothing built?
+	if( m_vSlotStart.empty() == true )
+		return;
+
+	// Oversized rects are candidates for everything
+	ids.insert( ids.end(), m_vOversized.begin(), m_vOversized.end() );
+
+
+	// New query stamp (reset the stamps when it wraps)
+	if( ++m_unStamp == 0 )
+	{
+		std::fill( m_vStamps.begin(), m_vStamps.end(), 0 );
+		m_unStamp = 1;
+	}
+
+
+	int left, top, right, bottom;
+	ComputeCells( rect, left, top, right, bottom );
+
+	// A huge query rect is cheaper to answer with every id
+	if( (right - left + 1) * (bottom - top + 1) > MAX_CELLS_PER_RECT )
+	{
+		for( unsigned int i = 0; i < m_vEntries.size(); i++ )
+			ids.push_back( m_vEntries[ i ].id );
+
+		std::sort( ids.begin(), ids.end() );
+		return;
+	}
+
+	for( int y = top; y <= bottom; y++ )
+	{
+		for( int x = left; x <= right; x++ )
+		{
+			unsigned int slot = HashCell( x, y );
+			for( unsigned int c = m_vSlotStart[ slot ]; c < m_vSlotStart[ slot + 1 ]; c++ )
+			{
+				// Report each id once
+				unsigned int id = m_vCellIds[ c ];
+				if( m_vStamps[ id ] != m_unStamp )
+				{
+					m_vStamps[ id ] = m_unStamp;
+					ids.push_back( id );
+				}
+			}
+		}
+	}
+
+	// Callers rely on the original (ascending) order
+	std::sort( ids.begin(), ids.end() );
+}
+
+
+//*********************************************************************//
+// ComputeCells
+//	- convert the rect into an inclusive range of cell coordinates
+void SpatialHash::ComputeCells( const SGD::Rectangle& rect, int& left, int& top, int& right, int& bottom ) const
+{
+	// Keep wild coordinates within int range
+	const float limit = 1.0e6f;
+
+	left	= (int)floorf( std::max( -limit, std::min( limit, rect.left   ) ) * m_fInvCellSize );
+	top		= (int)floorf( std::max( -limit, std::min( limit, rect.top    ) ) * m_fInvCellSize );
+	right	= (int)floorf( std::max( -limit, std::min( limit, rect.right  ) ) * m_fInvCellSize );
+	bottom	= (int)floorf( std::max( -limit, std::min( limit, rect.bottom ) ) * m_fInvCellSize );
+
+	// Inverted rects still occupy their top-left cell
+	if( right < left )
+		right = left;
+	if( bottom < top )
+		bottom = top;
+}
+
+
+//*********************************************************************//
+// HashCell
+//	- map the cell coordinates to a table slot
+unsigned int SpatialHash::HashCell( int x, int y ) const
+{
+	return ( (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u ) & m_unSlotMask;
+}
@@ -0,0 +1,84 @@
+//*********************************************************************//
+//	File:		SpatialHash.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	SpatialHash class buckets rectangles into a uniform
+//				grid to find nearby collision candidates
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_Geometry.h"	// Rectangle type
+#include <vector>							// std::vector type
+
+
+//*********************************************************************//
+// SpatialHash class
+//	- uniform grid of square cells, hashed into a flat table
+//	- rebuilt from scratch: Clear, Insert every rect, then Build
+//	- Query returns the ids sharing a cell with the rect
+//	  (unique & ascending, may include ids that do not overlap)
+class SpatialHash
+{
+public:
+	//*****************************************************************//
+	// Default constructor & destructor
+	SpatialHash( void )		= default;
+	~SpatialHash( void )	= default;
+
+
+	//*****************************************************************//
+	// Cell Size:
+	float	GetCellSize	( void ) const		{	return m_fCellSize;		}
+	void	SetCellSize	( float size );
+
+
+	//*****************************************************************//
+	// Construction:
+	void	Clear	( void );
+	void	Insert	( unsigned int id, const SGD::Rectangle& rect );
+	void	Build	( void );
+
+
+	//*****************************************************************//
+	// Query:
+	void	Query	( const SGD::Rectangle& rect, std::vector< unsigned int >& ids );
+
+private:
+	//*****************************************************************//
+	// Not copyable
+	SpatialHash( const SpatialHash& )				= delete;
+	SpatialHash& operator= ( const SpatialHash& )	= delete;
+
+
+	//*****************************************************************//
+	// Rects covering more cells than this skip the grid
+	enum { MAX_CELLS_PER_RECT = 256 };
+
+	//*****************************************************************//
+	// Cell range covered by an inserted rect
+	struct Entry
+	{
+		unsigned int	id;
+		int				left, top, right, bottom;	// inclusive cell coordinates
+	};
+
+	void			ComputeCells( const SGD::Rectangle& rect, int& left, int& top, int& right, int& bottom ) const;
+	unsigned int	HashCell	( int x, int y ) const;
+
+
+	//*****************************************************************//
+	// members:
+	float						m_fCellSize		= 128.0f;	// cell width & height
+	float						m_fInvCellSize	= 1.0f / 128.0f;
+
+	std::vector< Entry >		m_vEntries;					// inserted rects
+	std::vector< unsigned int >	m_vOversized;				// ids too large for the grid
+	std::vector< unsigned int >	m_vSlotStart;				// first index into m_vCellIds per table slot (+1 sentinel)
+	std::vector< unsigned int >	m_vCellIds;					// ids, grouped by table slot
+	unsigned int				m_unSlotMask	= 0;		// table size - 1 (power of 2)
+
+	std::vector< unsigned int >	m_vStamps;					// last query that reported each id
+	unsigned int				m_unStamp		= 0;		// current query
+
+};
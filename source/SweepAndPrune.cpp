@@ -0,0 +1,247 @@
+//*********************************************************************//
+//	File:		SweepAndPrune.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	SweepList class keeps a bucket's rects sorted along X
+//				to find overlapping pairs with a sweep
+//*********************************************************************//
+
+#include "SweepAndPrune.h"
+
+#include "IEntity.h"
+
+#include <algorithm>
+
+
+//*********************************************************************//
+// Update
+//	- match the list to the bucket, sample every rect,
+//	  then restore the order with an insertion sort
+void SweepList::Update( const std::vector< IEntity* >& entities, bool swept )
+{
+	// Did the bucket change?
+	if( m_bDirty == true || m_vEntries.size() != entities.size() )
+		Resync( entities );
+
+	// Sample the current rects (or swept bounds)
+	for( unsigned int i = 0; i < m_vEntries.size(); i++ )
+	{
+		const IEntity* pEntity = m_vEntries[ i ].pEntity;
+		m_vEntries[ i ].rect = pEntity->GetRect();
+
+		// Empty rects stay empty (they can never intersect)
+		if( swept == true && m_vEntries[ i ].rect.IsEmpty() == false )
+			m_vEntries[ i ].rect = m_vEntries[ i ].rect.ComputeUnion( m_vEntries[ i ].rect - pEntity->GetDisplacement() );
+	}
+
+
+	// Insertion sort: nearly linear when little moved since last frame
+	for( unsigned int i = 1; i < m_vEntries.size(); i++ )
+	{
+		if( m_vEntries[ i - 1 ].rect.left <= m_vEntries[ i ].rect.left )
+			continue;
+
+		Entry entry = m_vEntries[ i ];
+		unsigned int j = i;
+		while( j > 0 && m_vEntries[ j - 1 ].rect.left > entry.rect.left )
+		{
+			m_vEntries[ j ] = m_vEntries[ j - 1 ];
+			--j;
+		}
+		m_vEntries[ j ] = entry;
+	}
+}
+
+
+//*********************************************************************//
+// FindPairs
+//	- sweep the list once, reporting every intersecting pair
+unsigned int SweepList::FindPairs( PairVector& pairs ) const
+{
+	unsigned int tests = 0;
+	m_vActive.clear();
+
+	for( unsigned int e = 0; e < m_vEntries.size(); e++ )
+	{
+		// Empty rects can never intersect
+		const Entry& entry = m_vEntries[ e ];
+		if( entry.rect.IsEmpty() == true )
+			continue;
+
+		// Drop the entries that end before this one starts
+		Prune( m_vEntries, m_vActive, entry.rect.left );
+
+		// Test against the entries still overlapping along X
+		for( unsigned int a = 0; a < m_vActive.size(); a++ )
+		{
+			const Entry& other = m_vEntries[ m_vActive[ a ] ];
+
+			// Ignore self-collision
+			if( other.pEntity == entry.pEntity )
+				continue;
+
+			++tests;
+			if( entry.rect.IsIntersecting( other.rect ) == true )
+			{
+				if( other.index < entry.index )
+					pairs.push_back( IndexPair( other.index, entry.index ) );
+				else
+					pairs.push_back( IndexPair( entry.index, other.index ) );
+			}
+		}
+
+		m_vActive.push_back( e );
+	}
+
+	return tests;
+}
+
+
+//*********************************************************************//
+// FindPairs
+//	- sweep both lists together, reporting the intersecting
+//	  pairs between them (never within one list)
+unsigned int SweepList::FindPairs( const SweepList& other, PairVector& pairs ) const
+{
+	unsigned int tests = 0;
+	m_vActive.clear();
+	m_vActiveOther.clear();
+
+	const EntryVector& mine		= m_vEntries;
+	const EntryVector& theirs	= other.m_vEntries;
+
+	unsigned int i = 0;
+	unsigned int j = 0;
+	while( i < mine.size() || j < theirs.size() )
+	{
+		// Take whichever entry starts first
+		bool bMine = ( j >= theirs.size()
+					   || ( i < mine.size() && mine[ i ].rect.left <= theirs[ j ].rect.left ) );
+
+		if( bMine == true )
+		{
+			const Entry& entry = mine[ i ];
+			if( entry.rect.IsEmpty() == false )
+			{
+				// Test against the other list's open entries
+				Prune( theirs, m_vActiveOther, entry.rect.left );
+				for( unsigned int a = 0; a < m_vActiveOther.size(); a++ )
+				{
+					const Entry& open = theirs[ m_vActiveOther[ a ] ];
+					if( open.pEntity == entry.pEntity )
+						continue;
+
+					++tests;
+					if( entry.rect.IsIntersecting( open.rect ) == true )
+						pairs.push_back( IndexPair( entry.index, open.index ) );
+				}
+
+				m_vActive.push_back( i );
+			}
+			++i;
+		}
+		else
+		{
+			const Entry& entry = theirs[ j ];
+			if( entry.rect.IsEmpty() == false )
+			{
+				// Test against this list's open entries
+				Prune( mine, m_vActive, entry.rect.left );
+				for( unsigned int a = 0; a < m_vActive.size(); a++ )
+				{
+					const Entry& open = mine[ m_vActive[ a ] ];
+					if( open.pEntity == entry.pEntity )
+						continue;
+
+					++tests;
+					if( open.rect.IsIntersecting( entry.rect ) == true )
+						pairs.push_back( IndexPair( open.index, entry.index ) );
+				}
+
+				m_vActiveOther.push_back( j );
+			}
+			++j;
+		}
+	}
+
+	return tests;
+}
+
+
+//*********************************************************************//
+// Resync
+//	- rebuild the entries from the bucket while keeping the
+//	  previous (nearly sorted) order for the entities that remain
+void SweepList::Resync( const std::vector< IEntity* >& entities )
+{
+	// Bucket positions, sorted by entity for lookups
+	//	(the same entity can be stored more than once)
+	std::vector< std::pair< IEntity*, unsigned int > > lookup( entities.size() );
+	for( unsigned int i = 0; i < entities.size(); i++ )
+		lookup[ i ] = std::make_pair( entities[ i ], i );
+	std::sort( lookup.begin(), lookup.end() );
+
+	std::vector< bool > used( entities.size(), false );
+
+
+	// Keep the surviving entries in their current order
+	EntryVector entries;
+	entries.reserve( entities.size() );
+
+	for( unsigned int e = 0; e < m_vEntries.size(); e++ )
+	{
+		IEntity* pEntity = m_vEntries[ e ].pEntity;
+
+		std::vector< std::pair< IEntity*, unsigned int > >::iterator iter
+			= std::lower_bound( lookup.begin(), lookup.end(), std::make_pair( pEntity, 0u ) );
+
+		for( ; iter != lookup.end() && iter->first == pEntity; ++iter )
+		{
+			if( used[ iter->second ] == false )
+			{
+				used[ iter->second ] = true;
+
+				Entry entry = m_vEntries[ e ];
+				entry.index = iter->second;
+				entries.push_back( entry );
+				break;
+			}
+		}
+	}
+
+
+	// Append the new entities (sorted on the next Update)
+	for( unsigned int i = 0; i < entities.size(); i++ )
+	{
+		if( used[ i ] == true )
+			continue;
+
+		Entry entry;
+		entry.pEntity	= entities[ i ];
+		entry.index		= i;
+		entry.rect		= entities[ i ]->GetRect();
+		entries.push_back( entry );
+	}
+
+	m_vEntries.swap( entries );
+	m_bDirty = false;
+}
+
+
+//*********************************************************************//
+// Prune
+//	- remove the active entries ending at or before the left edge
+//	  (order within the active list does not matter)
+void SweepList::Prune( const EntryVector& entries, ActiveVector& active, float left ) const
+{
+	for( unsigned int a = 0; a < active.size(); )
+	{
+		if( entries[ active[ a ] ].rect.right <= left )
+		{
+			active[ a ] = active.back();
+			active.pop_back();
+		}
+		else
+			++a;
+	}
+}
@@ -0,0 +1,79 @@
+//*********************************************************************//
+//	File:		SweepAndPrune.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	SweepList class keeps a bucket's rects sorted along X
+//				to find overlapping pairs with a sweep
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_Geometry.h"	// Rectangle type
+#include <vector>							// std::vector type
+#include <utility>							// std::pair type
+class IEntity;								// IEntity type
+
+
+//*********************************************************************//
+// SweepList class
+//	- persistent list of a bucket's entities, sorted by their left edge
+//	- entities barely move between frames, so an insertion sort
+//	  keeps the list ordered for (nearly) linear cost
+//	- Invalidate whenever the bucket's contents change
+class SweepList
+{
+public:
+	//*****************************************************************//
+	// Default constructor & destructor
+	SweepList( void )	= default;
+	~SweepList( void )	= default;
+
+
+	//*****************************************************************//
+	// Overlapping pair of bucket indices
+	typedef std::pair< unsigned int, unsigned int >	IndexPair;
+	typedef std::vector< IndexPair >				PairVector;
+
+
+	//*****************************************************************//
+	// Synchronization:
+	//	- swept samples each entity's bounds over its last update
+	//	  (continuous collision) instead of its current rect
+	void	Invalidate	( void )		{	m_bDirty = true;	}
+	void	Update		( const std::vector< IEntity* >& entities, bool swept = false );
+
+
+	//*****************************************************************//
+	// Sweep:
+	//	- pairs within one list are (lower index, higher index)
+	//	- pairs between two lists are (index in this, index in other)
+	//	- returns the number of rect tests
+	unsigned int	FindPairs	( PairVector& pairs ) const;
+	unsigned int	FindPairs	( const SweepList& other, PairVector& pairs ) const;
+
+private:
+	//*****************************************************************//
+	// Sorted entry
+	struct Entry
+	{
+		IEntity*		pEntity;
+		unsigned int	index;		// position within the bucket
+		SGD::Rectangle	rect;		// sampled once per Update
+	};
+	typedef std::vector< Entry >		EntryVector;
+	typedef std::vector< unsigned int >	ActiveVector;
+
+
+	void	Resync		( const std::vector< IEntity* >& entities );
+	void	Prune		( const EntryVector& entries, ActiveVector& active, float left ) const;
+
+
+	//*****************************************************************//
+	// members:
+	EntryVector				m_vEntries;				// sorted by rect.left
+	bool					m_bDirty	= true;		// bucket changed since the last Update
+
+	mutable ActiveVector	m_vActive;				// sweep scratch space
+	mutable ActiveVector	m_vActiveOther;
+
+};
@@ -0,0 +1,105 @@
+//*********************************************************************//
+//	File:		TransformStore.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	TransformStore class stores the entities' positions,
+//				velocities & sizes in contiguous arrays
+//*********************************************************************//
+
+#include "TransformStore.h"
+
+#include "../SGD Wrappers/SGD_Utilities.h"
+
+
+//*********************************************************************//
+// Allocate
+//	- claim a slot (reusing a released one first)
+//	- initialize the slot with the given transform
+unsigned int TransformStore::Allocate( SGD::Point pos, SGD::Vector vel, SGD::Size size )
+{
+	unsigned int slot;
+
+	if( m_vFreeSlots.empty() == false )
+	{
+		slot = m_vFreeSlots.back();
+		m_vFreeSlots.pop_back();
+	}
+	else
+	{
+		// Grow every array together
+		slot = (unsigned int)m_vX.size();
+		m_vX.push_back( 0.0f );
+		m_vY.push_back( 0.0f );
+		m_vPrevX.push_back( 0.0f );
+		m_vPrevY.push_back( 0.0f );
+		m_vVX.push_back( 0.0f );
+		m_vVY.push_back( 0.0f );
+		m_vW.push_back( 0.0f );
+		m_vH.push_back( 0.0f );
+		m_vStep.push_back( 0.0f );
+	}
+
+	SetPosition( slot, pos );
+	SetVelocity( slot, vel );
+	m_vPrevX[ slot ] = pos.x;		// no movement yet
+	m_vPrevY[ slot ] = pos.y;
+	SetSize( slot, size );
+	m_vStep[ slot ] = 0.0f;
+
+	return slot;
+}
+
+
+//*********************************************************************//
+// Free
+//	- release the slot for reuse
+void TransformStore::Free( unsigned int slot )
+{
+	// Validate the parameter
+	SGD_ASSERT( slot < m_vX.size(),
+				"TransformStore::Free - invalid slot" );
+	if( slot >= m_vX.size() )
+		return;
+
+	// A free slot must never move
+	m_vStep[ slot ] = 0.0f;
+	m_vVX[ slot ] = 0.0f;
+	m_vVY[ slot ] = 0.0f;
+
+	m_vFreeSlots.push_back( slot );
+}
+
+
+//*********************************************************************//
+// Integrate
+//	- move every slot by its velocity for its queued time
+//	- one straight pass over the arrays (no branches, no pointers)
+void TransformStore::Integrate( void )
+{
+	const unsigned int count = (unsigned int)m_vX.size();
+	if( count == 0 )
+		return;
+
+	float*			x		= &m_vX[ 0 ];
+	float*			y		= &m_vY[ 0 ];
+	const float*	vx		= &m_vVX[ 0 ];
+	const float*	vy		= &m_vVY[ 0 ];
+	float*			step	= &m_vStep[ 0 ];
+
+	for( unsigned int i = 0; i < count; i++ )
+	{
+		x[ i ] += vx[ i ] * step[ i ];
+		y[ i ] += vy[ i ] * step[ i ];
+		step[ i ] = 0.0f;
+	}
+}
+
+
+//*********************************************************************//
+// SavePrevious
+//	- copy the current positions into the previous positions
+void TransformStore::SavePrevious( void )
+{
+	m_vPrevX = m_vX;
+	m_vPrevY = m_vY;
+}
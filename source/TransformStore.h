@@ -0,0 +1,95 @@
+//*********************************************************************//
+//	File:		TransformStore.h
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	TransformStore class stores the entities' positions,
+//				velocities & sizes in contiguous arrays
+//*********************************************************************//
+
+#pragma once
+
+#include "../SGD Wrappers/SGD_Geometry.h"	// Point, Vector, Size & Rectangle type
+#include <vector>							// std::vector type
+
+
+//*********************************************************************//
+// TransformStore class
+//	- structure-of-arrays: one array per component, indexed by slot
+//	- entities request movement during their Update, then Integrate
+//	  moves every requested slot in one pass
+class TransformStore
+{
+public:
+	//*****************************************************************//
+	// Default constructor & destructor
+	TransformStore( void )	= default;
+	~TransformStore( void )	= default;
+
+
+	//*****************************************************************//
+	// Slot Storage:
+	unsigned int	Allocate	( SGD::Point pos, SGD::Vector vel, SGD::Size size );
+	void			Free		( unsigned int slot );
+
+
+	//*****************************************************************//
+	// Accessors:
+	SGD::Point		GetPosition	( unsigned int slot ) const	{	return SGD::Point{ m_vX[ slot ], m_vY[ slot ] };		}
+	SGD::Point		GetPreviousPosition( unsigned int slot ) const	{	return SGD::Point{ m_vPrevX[ slot ], m_vPrevY[ slot ] };	}
+	SGD::Point		GetBlendedPosition( unsigned int slot ) const
+	{
+		return SGD::Point{ m_vPrevX[ slot ] + ( m_vX[ slot ] - m_vPrevX[ slot ] ) * m_fBlend,
+						   m_vPrevY[ slot ] + ( m_vY[ slot ] - m_vPrevY[ slot ] ) * m_fBlend };
+	}
+	SGD::Vector		GetVelocity	( unsigned int slot ) const	{	return SGD::Vector{ m_vVX[ slot ], m_vVY[ slot ] };	}
+	SGD::Size		GetSize		( unsigned int slot ) const	{	return SGD::Size{ m_vW[ slot ], m_vH[ slot ] };		}
+	SGD::Rectangle	GetRect		( unsigned int slot ) const
+	{
+		return SGD::Rectangle{ m_vX[ slot ], m_vY[ slot ], m_vX[ slot ] + m_vW[ slot ], m_vY[ slot ] + m_vH[ slot ] };
+	}
+
+	// Mutators:
+	void			SetPosition	( unsigned int slot, SGD::Point pos )	{	m_vX[ slot ] = pos.x;		m_vY[ slot ] = pos.y;		}
+	void			SetVelocity	( unsigned int slot, SGD::Vector vel )	{	m_vVX[ slot ] = vel.x;		m_vVY[ slot ] = vel.y;		}
+	void			SetSize		( unsigned int slot, SGD::Size size )	{	m_vW[ slot ] = size.width;	m_vH[ slot ] = size.height;	}
+
+
+	//*****************************************************************//
+	// Movement:
+	//	- Step queues the slot to move by its velocity for the time
+	//	- Integrate applies (and clears) every queued step
+	void			Step		( unsigned int slot, float elapsedTime )	{	m_vStep[ slot ] += elapsedTime;	}
+	void			Integrate	( void );
+
+	// Remember every position as the previous one
+	//	(called at the start of each update, to measure the movement)
+	void			SavePrevious( void );
+
+	// Blend between the previous & current positions for rendering
+	//	(0 = previous, 1 = current)
+	float			GetBlend	( void ) const							{	return m_fBlend;	}
+	void			SetBlend	( float blend )							{	m_fBlend = blend;	}
+
+private:
+	//*****************************************************************//
+	// Not copyable (entities hold slots into this store)
+	TransformStore( const TransformStore& )				= delete;
+	TransformStore& operator= ( const TransformStore& )	= delete;
+
+
+	//*****************************************************************//
+	// members:
+	std::vector< float >		m_vX;			// position
+	std::vector< float >		m_vY;
+	std::vector< float >		m_vPrevX;		// position at the start of the update
+	std::vector< float >		m_vPrevY;
+	std::vector< float >		m_vVX;			// velocity
+	std::vector< float >		m_vVY;
+	std::vector< float >		m_vW;			// size
+	std::vector< float >		m_vH;
+	std::vector< float >		m_vStep;		// queued movement time (0 = stay)
+
+	std::vector< unsigned int >	m_vFreeSlots;	// released slots for reuse
+	float						m_fBlend	= 1.0f;	// render blend factor
+
+};
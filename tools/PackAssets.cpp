@@ -0,0 +1,229 @@
+//*********************************************************************//
+//	File:		PackAssets.cpp
+//	Author:		Eva-Lotta Wahlberg
+//	Course:		SGD 1505
+//	Purpose:	Packs asset files into one archive for MountArchive
+//				(the layout is in SGD_AssetArchive.h)
+//*********************************************************************//
+
+#include "../SGD Wrappers/SGD_AssetArchive.h"
+#include "../SGD Wrappers/SGD_AssetIndex.h"
+#include "../SGD Wrappers/SGD_Compression.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace SGD::SGD_IMPLEMENTATION;
+
+
+//*********************************************************************//
+// Command line
+struct PackOptions
+{
+	const char*					output		= nullptr;
+	unsigned int				alignment	= 16;		// entry data alignment
+	bool						compress	= false;	// try CompressLZ on each file
+	std::vector< const char* >	files;
+};
+
+static void PrintUsage( const char* program )
+{
+	printf( "usage: %s OUTPUT [--align N] [--compress] FILE...\n"
+			"  packs the files into the archive OUTPUT, named by their paths\n"
+			"  as the game loads them (run it from the same folder)\n"
+			"  --align: entry data alignment in bytes (power of 2, default 16)\n"
+			"  --compress: compresses the files it shrinks by 1/8 or more\n",
+			program );
+}
+
+static bool ParseOptions( int argc, char* argv[], PackOptions& options )
+{
+	for( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[ i ];
+		if( strcmp( arg, "--align" ) == 0 && i + 1 < argc )
+			options.alignment = (unsigned int)strtoul( argv[ ++i ], nullptr, 0 );
+		else if( strcmp( arg, "--compress" ) == 0 )
+			options.compress = true;
+		else if( strncmp( arg, "--", 2 ) == 0 )
+			return false;
+		else if( options.output == nullptr )
+			options.output = arg;
+		else
+			options.files.push_back( arg );
+	}
+
+	if( options.alignment == 0 || ( options.alignment & ( options.alignment - 1 ) ) != 0 )
+		return false;
+
+	return options.output != nullptr && options.files.empty() == false;
+}
+
+
+//*********************************************************************//
+// Packed file
+struct PackedFile
+{
+	std::string						name;		// EncodeAssetName
+	const char*						path;
+	unsigned int					originalSize;
+	unsigned int					compression;
+	std::vector< unsigned char >	data;		// as stored
+};
+
+static bool ReadFile( const char* path, std::vector< unsigned char >& data )
+{
+	FILE* pFile = fopen( path, "rb" );
+	if( pFile == nullptr )
+		return false;
+
+	data.clear();
+	unsigned char block[ 65536 ];
+	size_t read;
+	while( ( read = fread( block, 1, sizeof( block ), pFile ) ) > 0 )
+		data.insert( data.end(), block, block + read );
+
+	bool success = ferror( pFile ) == 0;
+	fclose( pFile );
+	return success;
+}
+
+static unsigned int Align( size_t offset, unsigned int alignment )
+{
+	return (unsigned int)( ( offset + alignment - 1 ) & ~(size_t)( alignment - 1 ) );
+}
+
+
+//*********************************************************************//
+// main
+int main( int argc, char* argv[] )
+{
+	PackOptions options;
+	if( ParseOptions( argc, argv, options ) == false )
+	{
+		PrintUsage( argv[ 0 ] );
+		return 1;
+	}
+
+
+	// Read (& compress) every file
+	std::vector< PackedFile > files( options.files.size() );
+	for( unsigned int i = 0; i < files.size(); i++ )
+	{
+		PackedFile& file = files[ i ];
+		file.path = options.files[ i ];
+
+		if( ReadFile( file.path, file.data ) == false )
+		{
+			fprintf( stderr, "could not read '%s'\n", file.path );
+			return 1;
+		}
+
+		// The paths are ASCII
+		std::string	path = file.path;
+		file.name			= EncodeAssetName( std::wstring( path.begin(), path.end() ).c_str() );
+		file.originalSize	= (unsigned int)file.data.size();
+		file.compression	= ARCHIVE_STORED;
+
+		if( options.compress == true )
+		{
+			std::vector< unsigned char > compressed;
+			size_t size = CompressLZ( file.data.data(), file.data.size(), compressed );
+
+			if( size <= file.data.size() - file.data.size() / 8 )
+			{
+				file.data.swap( compressed );
+				file.compression = ARCHIVE_LZ;
+			}
+		}
+	}
+
+
+	// Sort by name for the binary search
+	std::sort( files.begin(), files.end(),
+		[]( const PackedFile& a, const PackedFile& b ) { return a.name < b.name; } );
+
+	for( unsigned int i = 1; i < files.size(); i++ )
+	{
+		if( files[ i ].name == files[ i - 1 ].name )
+		{
+			fprintf( stderr, "'%s' & '%s' are the same asset\n", files[ i - 1 ].path, files[ i ].path );
+			return 1;
+		}
+	}
+
+
+	// Lay out the header, table, names & data
+	ArchiveHeader header;
+	memcpy( header.magic, "SGDA", 4 );
+	header.version		= ARCHIVE_VERSION;
+	header.count		= (unsigned int)files.size();
+	header.alignment	= options.alignment;
+
+	std::vector< ArchiveEntry > entries( files.size() );
+	size_t offset = sizeof( ArchiveHeader ) + entries.size() * sizeof( ArchiveEntry );
+
+	for( unsigned int i = 0; i < files.size(); i++ )
+	{
+		entries[ i ].nameOffset	= (unsigned int)offset;
+		entries[ i ].nameLength	= (unsigned int)files[ i ].name.size();
+		offset += files[ i ].name.size();
+	}
+
+	unsigned long long original = 0;
+	unsigned int numCompressed = 0;
+	for( unsigned int i = 0; i < files.size(); i++ )
+	{
+		offset = Align( offset, options.alignment );
+
+		entries[ i ].offset			= (unsigned int)offset;
+		entries[ i ].size			= (unsigned int)files[ i ].data.size();
+		entries[ i ].originalSize	= files[ i ].originalSize;
+		entries[ i ].compression	= files[ i ].compression;
+		offset += files[ i ].data.size();
+
+		original += files[ i ].originalSize;
+		if( files[ i ].compression != ARCHIVE_STORED )
+			numCompressed++;
+	}
+
+	if( offset > 0xFFFFFFFF )
+	{
+		fprintf( stderr, "the archive would be over 4 GB\n" );
+		return 1;
+	}
+
+
+	// Write it
+	std::vector< unsigned char > archive( offset, 0 );
+	memcpy( archive.data(), &header, sizeof( header ) );
+	if( entries.empty() == false )
+		memcpy( archive.data() + sizeof( header ), entries.data(), entries.size() * sizeof( ArchiveEntry ) );
+
+	for( unsigned int i = 0; i < files.size(); i++ )
+	{
+		memcpy( archive.data() + entries[ i ].nameOffset, files[ i ].name.data(), files[ i ].name.size() );
+		if( files[ i ].data.empty() == false )
+			memcpy( archive.data() + entries[ i ].offset, files[ i ].data.data(), files[ i ].data.size() );
+	}
+
+	FILE* pFile = fopen( options.output, "wb" );
+	bool success = pFile != nullptr && fwrite( archive.data(), 1, archive.size(), pFile ) == archive.size();
+	if( pFile != nullptr && fclose( pFile ) != 0 )
+		success = false;
+
+	if( success == false )
+	{
+		fprintf( stderr, "could not write '%s'\n", options.output );
+		remove( options.output );
+		return 1;
+	}
+
+	printf( "%s: %u files, %llu bytes (%llu before packing, %u compressed)\n",
+			options.output, header.count, (unsigned long long)archive.size(), original, numCompressed );
+	return 0;
+}